@@ -115,8 +115,10 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/discretization/common/fvbasefdlocallinearizer.hh
              opm/models/discretization/common/fvbaseboundarycontext.hh
              opm/models/discretization/common/fvbaseadlocallinearizer.hh
+             opm/models/discretization/common/fvbasevectoradlocallinearizer.hh
              opm/models/discretization/common/fvbaseconstraints.hh
              opm/models/discretization/common/fvbaseproperties.hh
+             opm/models/discretization/common/fvbasestencilgeometrycache.hh
              opm/models/discretization/common/fvbaseextensivequantities.hh
              opm/models/discretization/common/fvbaselinearizer.hh
              opm/models/discretization/common/restrictprolong.hh
@@ -153,9 +155,11 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/io/vtkscalarfunction.hh
              opm/models/io/vtkenergymodule.hh
              opm/models/io/restart.hh
+             opm/models/io/binaryrestart.hh
              opm/models/io/cubegridvanguard.hh
              opm/models/io/baseoutputwriter.hh
              opm/models/io/vtkmultiwriter.hh
+             opm/models/io/vtknativewriter.hh
              opm/models/io/vtkmultiphasemodule.hh
              opm/models/io/vtkdiscretefracturemodule.hh
              opm/models/io/vtkdiffusionmodule.hh
@@ -190,6 +194,9 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/parallel/gridcommhandles.hh
              opm/models/parallel/mpibuffer.hh
              opm/models/parallel/threadedentityiterator.hh
+             opm/models/parallel/chunkscheduler.hh
+             opm/models/parallel/elementrange.hh
+             opm/models/parallel/collectivebatch.hh
              opm/models/pvs/pvsboundaryratevector.hh
              opm/models/pvs/pvsratevector.hh
              opm/models/pvs/pvsindices.hh
@@ -230,7 +237,9 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/simulators/linalg/linalgproperties.hh
              opm/simulators/linalg/linearsolverreport.hh
              opm/simulators/linalg/istlsparsematrixadapter.hh
+             opm/simulators/linalg/sparsitypattern.hh
              opm/simulators/linalg/istlpreconditionerwrappers.hh
+             opm/simulators/linalg/threadedpreconditioners.hh
              opm/simulators/linalg/residreductioncriterion.hh
              opm/simulators/linalg/overlappingbcrsmatrix.hh
              opm/simulators/linalg/blacklist.hh
@@ -242,8 +251,12 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/simulators/linalg/elementborderlistfromgrid.hh
              opm/simulators/linalg/combinedcriterion.hh
              opm/simulators/linalg/bicgstabsolver.hh
+             opm/simulators/linalg/cprpreconditioner.hh
+             opm/simulators/linalg/pipelinedbicgstabsolver.hh
              opm/simulators/linalg/globalindices.hh
+             opm/simulators/linalg/flatindexmap.hh
              opm/simulators/linalg/superlubackend.hh
+             opm/simulators/linalg/blockkernels.hh
              opm/simulators/linalg/matrixblock.hh
              opm/simulators/linalg/istlsolverwrappers.hh
              opm/simulators/linalg/overlaptypes.hh
@@ -98,7 +98,6 @@ public:
         ExtensiveQuantities extQuants;
         extQuants.updateBoundary(context, bfIdx, timeIdx, fluidState);
         const auto& insideIntQuants = context.intensiveQuantities(bfIdx, timeIdx);
-        unsigned focusDofIdx = context.focusDofIndex();
         unsigned interiorDofIdx = context.interiorScvIndex(bfIdx, timeIdx);
 
         ////////
@@ -141,7 +140,7 @@ public:
                 Evaluation density;
                 Evaluation specificEnthalpy;
                 if (pBoundary > pInside) {
-                    if (focusDofIdx == interiorDofIdx) {
+                    if (context.isFocusDof(interiorDofIdx)) {
                         density = fluidState.density(phaseIdx);
                         specificEnthalpy = fluidState.enthalpy(phaseIdx);
                     }
@@ -150,7 +149,7 @@ public:
                         specificEnthalpy = Opm::getValue(fluidState.enthalpy(phaseIdx));
                     }
                 }
-                else if (focusDofIdx == interiorDofIdx) {
+                else if (context.isFocusDof(interiorDofIdx)) {
                     density = insideIntQuants.fluidState().density(phaseIdx);
                     specificEnthalpy = insideIntQuants.fluidState().enthalpy(phaseIdx);
                 }
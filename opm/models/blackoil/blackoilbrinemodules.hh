@@ -369,11 +369,9 @@ public:
                                   unsigned dofIdx,
                                   unsigned timeIdx)
     {
-        const PrimaryVariables& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
-
         auto& fs = asImp_().fluidState_;
         // set saltconcentration
-        fs.setSaltConcentration(priVars.makeEvaluation(saltConcentrationIdx, timeIdx));
+        fs.setSaltConcentration(elemCtx.makeEvaluation(dofIdx, saltConcentrationIdx, timeIdx));
 
     }
 
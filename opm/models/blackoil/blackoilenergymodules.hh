@@ -183,13 +183,12 @@ public:
         flux[contiEnergyEqIdx] = 0.0;
 
         const auto& extQuants = elemCtx.extensiveQuantities(scvfIdx, timeIdx);
-        unsigned focusIdx = elemCtx.focusDofIndex();
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             if (!FluidSystem::phaseIsActive(phaseIdx))
                 continue;
 
             unsigned upIdx = extQuants.upstreamIndex(phaseIdx);
-            if (upIdx == focusIdx)
+            if (elemCtx.isFocusDof(upIdx))
                 addPhaseEnthalpyFlux_<Evaluation>(flux, phaseIdx, elemCtx, scvfIdx, timeIdx);
             else
                 addPhaseEnthalpyFlux_<Scalar>(flux, phaseIdx, elemCtx, scvfIdx, timeIdx);
@@ -354,10 +353,9 @@ public:
                             unsigned timeIdx)
     {
         auto& fs = asImp_().fluidState_;
-        const auto& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
 
         // set temperature
-        fs.setTemperature(priVars.makeEvaluation(temperatureIdx, timeIdx, elemCtx.linearizationType()));
+        fs.setTemperature(elemCtx.makeEvaluation(dofIdx, temperatureIdx, timeIdx, elemCtx.linearizationType()));
     }
 
     /*!
@@ -494,27 +492,24 @@ public:
         const auto& exFs = exIq.fluidState();
 
         Evaluation deltaT;
-        if (elemCtx.focusDofIndex() == inIdx)
-            deltaT =
-                Opm::decay<Scalar>(exFs.temperature(/*phaseIdx=*/0))
-                - inFs.temperature(/*phaseIdx=*/0);
-        else if (elemCtx.focusDofIndex() == exIdx)
-            deltaT =
-                exFs.temperature(/*phaseIdx=*/0)
-                - Opm::decay<Scalar>(inFs.temperature(/*phaseIdx=*/0));
+        if (elemCtx.isFocusDof(exIdx))
+            deltaT = exFs.temperature(/*phaseIdx=*/0);
         else
-            deltaT =
-                Opm::decay<Scalar>(exFs.temperature(/*phaseIdx=*/0))
-                - Opm::decay<Scalar>(inFs.temperature(/*phaseIdx=*/0));
+            deltaT = Opm::decay<Scalar>(exFs.temperature(/*phaseIdx=*/0));
+
+        if (elemCtx.isFocusDof(inIdx))
+            deltaT -= inFs.temperature(/*phaseIdx=*/0);
+        else
+            deltaT -= Opm::decay<Scalar>(inFs.temperature(/*phaseIdx=*/0));
 
         Evaluation inLambda;
-        if (elemCtx.focusDofIndex() == inIdx)
+        if (elemCtx.isFocusDof(inIdx))
             inLambda = inIq.totalThermalConductivity();
         else
             inLambda = Opm::decay<Scalar>(inIq.totalThermalConductivity());
 
         Evaluation exLambda;
-        if (elemCtx.focusDofIndex() == exIdx)
+        if (elemCtx.isFocusDof(exIdx))
             exLambda = exIq.totalThermalConductivity();
         else
             exLambda = Opm::decay<Scalar>(exIq.totalThermalConductivity());
@@ -553,7 +548,7 @@ public:
         const auto& inFs = inIq.fluidState();
 
         Evaluation deltaT;
-        if (ctx.focusDofIndex() == inIdx)
+        if (ctx.isFocusDof(inIdx))
             deltaT =
                 boundaryFs.temperature(/*phaseIdx=*/0)
                 - inFs.temperature(/*phaseIdx=*/0);
@@ -563,7 +558,7 @@ public:
                 - Opm::decay<Scalar>(inFs.temperature(/*phaseIdx=*/0));
 
         Evaluation lambda;
-        if (ctx.focusDofIndex() == inIdx)
+        if (ctx.isFocusDof(inIdx))
             lambda = inIq.totalThermalConductivity();
         else
             lambda = Opm::decay<Scalar>(inIq.totalThermalConductivity());
@@ -684,7 +684,7 @@ public:
         unsigned pvtRegionIdx = priVars.pvtRegionIndex();
         auto& fs = asImp_().fluidState_;
 
-        zFraction_ = priVars.makeEvaluation(zFractionIdx, timeIdx);
+        zFraction_ = elemCtx.makeEvaluation(dofIdx, zFractionIdx, timeIdx);
 
         oilViscosity_ = ExtboModule::oilViscosity(pvtRegionIdx, fs.pressure(oilPhaseIdx), zFraction_);
         gasViscosity_ = ExtboModule::gasViscosity(pvtRegionIdx, fs.pressure(gasPhaseIdx), zFraction_);
@@ -713,14 +713,14 @@ public:
            static const Scalar thresholdWaterFilledCell = 1.0 - 1e-6;
            Scalar Sw = 0.0;
            if (Indices::waterEnabled)
-              Sw = priVars.makeEvaluation(Indices::waterSaturationIdx, timeIdx).value();
+              Sw = elemCtx.makeEvaluation(dofIdx, Indices::waterSaturationIdx, timeIdx).value();
 
            if (Sw >= thresholdWaterFilledCell)
               rs_ = 0.0;  // water only, zero rs_ ...
         }
 
         if (priVars.primaryVarsMeaning() == PrimaryVariables::Sw_po_Rs) {
-           rs_ = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx);
+           rs_ = elemCtx.makeEvaluation(dofIdx, Indices::compositionSwitchIdx, timeIdx);
            const Evaluation zLim = ExtboModule::zLim(pvtRegionIdx);
            if (zFraction_ > zLim) {
              pbub = ExtboModule::pbubRs(pvtRegionIdx, zLim, rs_);
@@ -733,7 +733,7 @@ public:
         }
 
         if (priVars.primaryVarsMeaning() == PrimaryVariables::Sw_pg_Rv) {
-           rv_ = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx);
+           rv_ = elemCtx.makeEvaluation(dofIdx, Indices::compositionSwitchIdx, timeIdx);
            Evaluation rvsat = ExtboModule::rv(pvtRegionIdx, pbub, zFraction_);
            bg_ = ExtboModule::bg(pvtRegionIdx, pbub, zFraction_) + ExtboModule::gasCmp(pvtRegionIdx, zFraction_)*(rv_-rvsat);
 
@@ -509,8 +509,7 @@ public:
                                unsigned dofIdx,
                                unsigned timeIdx)
     {
-        const PrimaryVariables& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
-        foamConcentration_ = priVars.makeEvaluation(foamConcentrationIdx, timeIdx);
+        foamConcentration_ = elemCtx.makeEvaluation(dofIdx, foamConcentrationIdx, timeIdx);
         const auto& fs = asImp_().fluidState_;
 
         // Compute gas mobility reduction factor
@@ -130,6 +130,11 @@ struct Indices<TypeTag, TTag::BlackOilModel>
                                     getPropValue<TypeTag, Properties::EnableBrine>(),
                                     /*PVOffset=*/0>; };
 
+//! The CPR preconditioner decouples the pressure from the switching variables
+template<class TypeTag>
+struct CprPressureIndex<TypeTag, TTag::BlackOilModel>
+{ static constexpr int value = GetPropType<TypeTag, Properties::Indices>::pressureSwitchIdx; };
+
 //! Set the fluid system to the black-oil fluid system by default
 template<class TypeTag>
 struct FluidSystem<TypeTag, TTag::BlackOilModel>
@@ -111,7 +111,7 @@ public:
         ParentType::finishInit();
 
         wasSwitched_.resize(this->model().numTotalDof());
-        std::fill(wasSwitched_.begin(), wasSwitched_.end(), false);
+        std::fill(wasSwitched_.begin(), wasSwitched_.end(), 0);
     }
 
     /*!
@@ -148,30 +148,6 @@ protected:
         ParentType::beginIteration_();
     }
 
-    /*!
-     * \copydoc FvBaseNewtonMethod::endIteration_
-     */
-    void endIteration_(SolutionVector& uCurrentIter,
-                       const SolutionVector& uLastIter)
-    {
-#if HAVE_MPI
-        // in the MPI enabled case we need to add up the number of DOF
-        // for which the interpretation changed over all processes.
-        int localSwitched = numPriVarsSwitched_;
-        MPI_Allreduce(&localSwitched,
-                      &numPriVarsSwitched_,
-                      /*num=*/1,
-                      MPI_INT,
-                      MPI_SUM,
-                      MPI_COMM_WORLD);
-#endif // HAVE_MPI
-
-        this->simulator_.model().newtonMethod().endIterMsg()
-            << ", num switched=" << numPriVarsSwitched_;
-
-        ParentType::endIteration_(uCurrentIter, uLastIter);
-    }
-
 public:
     void update_(SolutionVector& nextSolution,
                  const SolutionVector& currentSolution,
@@ -180,25 +156,43 @@ public:
     {
         const auto& comm = this->simulator_.gridView().comm();
 
-        int succeeded;
+        bool succeeded;
+        int numSwitched = 0;
         try {
+            // the primary variables of the individual DOFs are updated (and switched)
+            // by all threads
             ParentType::update_(nextSolution,
                                 currentSolution,
                                 solutionUpdate,
                                 currentResidual);
-            succeeded = 1;
+
+            // count the DOFs for which the interpretation of the primary variables has
+            // changed
+            int numGridDof = static_cast<int>(this->model().numGridDof());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+: numSwitched)
+#endif
+            for (int dofIdx = 0; dofIdx < numGridDof; ++dofIdx)
+                numSwitched += wasSwitched_[static_cast<size_t>(dofIdx)];
+
+            succeeded = true;
         }
         catch (...) {
             std::cout << "Newton update threw an exception on rank "
                       << comm.rank() << "\n";
-            succeeded = 0;
+            succeeded = false;
         }
-        succeeded = comm.min(succeeded);
 
-        if (!succeeded)
-            throw Opm::NumericalIssue("A process did not succeed in adapting the primary variables");
-
-        numPriVarsSwitched_ = comm.sum(numPriVarsSwitched_);
+        // the status and the number of switched DOFs are reduced over all processes
+        // together with the other values at the end of the iteration
+        auto& collectives = this->collectives();
+        collectives.addStatus(succeeded, "A process did not succeed in adapting the primary variables");
+        collectives.addSum(numSwitched,
+                           [this](double totalSwitched)
+                           {
+                               numPriVarsSwitched_ = static_cast<int>(totalSwitched);
+                               this->endIterMsg() << ", num switched=" << numPriVarsSwitched_;
+                           });
     }
 
 protected:
@@ -341,14 +335,13 @@ protected:
 
         // switch the new primary variables to something which is physically meaningful.
         // use a threshold value after a switch to make it harder to switch back
-        // immediately.
+        // immediately. this method is called by multiple threads at the same time, so
+        // the number of switched DOFs is determined by update_() afterwards.
         if (wasSwitched_[globalDofIdx])
             wasSwitched_[globalDofIdx] = nextValue.adaptPrimaryVariables(this->problem(), globalDofIdx, priVarOscilationThreshold_);
         else
             wasSwitched_[globalDofIdx] = nextValue.adaptPrimaryVariables(this->problem(), globalDofIdx);
 
-        if (wasSwitched_[globalDofIdx])
-            ++ numPriVarsSwitched_;
         if(projectSaturations_){
             nextValue.chopAndNormalizeSaturations();
         }
@@ -365,8 +358,9 @@ private:
     bool projectSaturations_;
 
     // keep track of cells where the primary variable meaning has changed
-    // to detect and hinder oscillations
-    std::vector<bool> wasSwitched_;
+    // to detect and hinder oscillations. (std::vector<bool> cannot be written by
+    // multiple threads concurrently.)
+    std::vector<unsigned char> wasSwitched_;
 };
 } // namespace Opm
 
@@ -1045,10 +1045,9 @@ public:
                                   unsigned timeIdx)
     {
         const auto linearizationType = elemCtx.linearizationType();
-        const PrimaryVariables& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
-        polymerConcentration_ = priVars.makeEvaluation(polymerConcentrationIdx, timeIdx, linearizationType);
+        polymerConcentration_ = elemCtx.makeEvaluation(dofIdx, polymerConcentrationIdx, timeIdx, linearizationType);
         if (enablePolymerMolarWeight) {
-            polymerMoleWeight_ = priVars.makeEvaluation(polymerMoleWeightIdx, timeIdx, linearizationType);
+            polymerMoleWeight_ = elemCtx.makeEvaluation(dofIdx, polymerMoleWeightIdx, timeIdx, linearizationType);
         }
         const Scalar cmax = PolymerModule::plymaxMaxConcentration(elemCtx, dofIdx, timeIdx);
 
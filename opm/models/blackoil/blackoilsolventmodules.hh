@@ -895,9 +895,8 @@ public:
                                   unsigned dofIdx,
                                   unsigned timeIdx)
     {
-        const PrimaryVariables& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
         auto& fs = asImp_().fluidState_;
-        solventSaturation_ = priVars.makeEvaluation(solventSaturationIdx, timeIdx, elemCtx.linearizationType());
+        solventSaturation_ = elemCtx.makeEvaluation(dofIdx, solventSaturationIdx, timeIdx, elemCtx.linearizationType());
         hydrocarbonSaturation_ = fs.saturation(gasPhaseIdx);
 
         // apply a cut-off. Don't waste calculations if no solvent
@@ -948,9 +947,9 @@ public:
             //oil is the reference phase for pressure
             const auto linearizationType = elemCtx.linearizationType();
             if (priVars.primaryVarsMeaning() == PrimaryVariables::Sw_pg_Rv)
-                pgMisc = priVars.makeEvaluation(Indices::pressureSwitchIdx, timeIdx, linearizationType);
+                pgMisc = elemCtx.makeEvaluation(dofIdx, Indices::pressureSwitchIdx, timeIdx, linearizationType);
             else {
-                const Evaluation& po = priVars.makeEvaluation(Indices::pressureSwitchIdx, timeIdx, linearizationType);
+                const Evaluation& po = elemCtx.makeEvaluation(dofIdx, Indices::pressureSwitchIdx, timeIdx, linearizationType);
                 pgMisc = po + (pC[gasPhaseIdx] - pC[oilPhaseIdx]);
             }
 
@@ -1359,7 +1358,7 @@ public:
         Opm::Valgrind::CheckDefined(solventPGrad);
 
         // correct the pressure gradients by the gravitational acceleration
-        if (EWOMS_GET_PARAM(TypeTag, bool, EnableGravity)) {
+        if (elemCtx.problem().enableGravity()) {
             // estimate the gravitational acceleration at a given SCV face
             // using the arithmetic mean
             const auto& gIn = elemCtx.problem().gravity(elemCtx, i, timeIdx);
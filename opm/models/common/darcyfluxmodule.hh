@@ -195,7 +195,6 @@ protected:
         unsigned j = scvf.exteriorIndex();
         interiorDofIdx_ = static_cast<short>(i);
         exteriorDofIdx_ = static_cast<short>(j);
-        unsigned focusDofIdx = elemCtx.focusDofIndex();
 
         // calculate the "raw" pressure gradient
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
@@ -213,7 +212,7 @@ protected:
         }
 
         // correct the pressure gradients by the gravitational acceleration
-        if (EWOMS_GET_PARAM(TypeTag, bool, EnableGravity)) {
+        if (elemCtx.problem().enableGravity()) {
             // estimate the gravitational acceleration at a given SCV face
             // using the arithmetic mean
             const auto& gIn = elemCtx.problem().gravity(elemCtx, i, timeIdx);
@@ -243,7 +242,7 @@ protected:
                 Evaluation pStatIn;
 
                 if (std::is_same<Scalar, Evaluation>::value ||
-                    interiorDofIdx_ == static_cast<int>(focusDofIdx))
+                    elemCtx.isFocusDof(i))
                 {
                     const Evaluation& rhoIn = intQuantsIn.fluidState().density(phaseIdx);
                     pStatIn = - rhoIn*(gIn*distVecIn);
@@ -258,7 +257,7 @@ protected:
                 Evaluation pStatEx;
 
                 if (std::is_same<Scalar, Evaluation>::value ||
-                    exteriorDofIdx_ == static_cast<int>(focusDofIdx))
+                    elemCtx.isFocusDof(j))
                 {
                     const Evaluation& rhoEx = intQuantsEx.fluidState().density(phaseIdx);
                     pStatEx = - rhoEx*(gEx*distVecEx);
@@ -315,7 +314,7 @@ protected:
             // we only carry the derivatives along if the upstream DOF is the one which
             // we currently focus on
             const auto& up = elemCtx.intensiveQuantities(upstreamDofIdx_[phaseIdx], timeIdx);
-            if (upstreamDofIdx_[phaseIdx] == static_cast<int>(focusDofIdx))
+            if (elemCtx.isFocusDof(static_cast<unsigned>(upstreamDofIdx_[phaseIdx])))
                 mobility_[phaseIdx] = up.mobility(phaseIdx);
             else
                 mobility_[phaseIdx] = Toolbox::value(up.mobility(phaseIdx));
@@ -356,14 +355,13 @@ protected:
         auto i = scvf.interiorIndex();
         interiorDofIdx_ = static_cast<short>(i);
         exteriorDofIdx_ = -1;
-        int focusDofIdx = elemCtx.focusDofIndex();
 
         // calculate the intrinsic permeability
         const auto& intQuantsIn = elemCtx.intensiveQuantities(i, timeIdx);
         K_ = intQuantsIn.intrinsicPermeability();
 
         // correct the pressure gradients by the gravitational acceleration
-        if (EWOMS_GET_PARAM(TypeTag, bool, EnableGravity)) {
+        if (elemCtx.problem().enableGravity()) {
             // estimate the gravitational acceleration at a given SCV face
             // using the arithmetic mean
             const auto& gIn = elemCtx.problem().gravity(elemCtx, i, timeIdx);
@@ -435,7 +433,7 @@ protected:
 
             // take the phase mobility from the DOF in upstream direction
             if (upstreamDofIdx_[phaseIdx] < 0) {
-                if (interiorDofIdx_ == focusDofIdx)
+                if (elemCtx.isFocusDof(i))
                     mobility_[phaseIdx] =
                         kr[phaseIdx] / fluidState.viscosity(phaseIdx);
                 else
@@ -443,7 +441,7 @@ protected:
                         Toolbox::value(kr[phaseIdx])
                         / Toolbox::value(fluidState.viscosity(phaseIdx));
             }
-            else if (upstreamDofIdx_[phaseIdx] != focusDofIdx)
+            else if (!elemCtx.isFocusDof(i))
                 mobility_[phaseIdx] = Toolbox::value(intQuantsIn.mobility(phaseIdx));
             else
                 mobility_[phaseIdx] = intQuantsIn.mobility(phaseIdx);
@@ -625,10 +625,7 @@ protected:
             val = Toolbox::createConstant(priVars[temperatureIdx]);
         else {
             // automatic differentiation
-            if (timeIdx == 0)
-                val = Toolbox::createVariable(priVars[temperatureIdx], temperatureIdx);
-            else
-                val = Toolbox::createConstant(priVars[temperatureIdx]);
+            val = context.makeEvaluation(spaceIdx, temperatureIdx, timeIdx);
         }
         fluidState.setTemperature(val);
     }
@@ -255,7 +255,6 @@ protected:
     {
         DarcyExtQuants::calculateGradients_(elemCtx, faceIdx, timeIdx);
 
-        auto focusDofIdx = elemCtx.focusDofIndex();
         unsigned i = static_cast<unsigned>(this->interiorDofIdx_);
         unsigned j = static_cast<unsigned>(this->exteriorDofIdx_);
         const auto& intQuantsIn = elemCtx.intensiveQuantities(i, timeIdx);
@@ -268,19 +267,15 @@ protected:
             sqrtK_[dimIdx] = std::sqrt(this->K_[dimIdx][dimIdx]);
 
         // obtain the Ergun coefficient. Lacking better ideas, we use its the arithmetic mean.
-        if (focusDofIdx == i) {
-            ergunCoefficient_ =
-                (intQuantsIn.ergunCoefficient() +
-                 Opm::getValue(intQuantsEx.ergunCoefficient()))/2;
-        }
-        else if (focusDofIdx == j)
-            ergunCoefficient_ =
-                (Opm::getValue(intQuantsIn.ergunCoefficient()) +
-                 intQuantsEx.ergunCoefficient())/2;
+        if (elemCtx.isFocusDof(i))
+            ergunCoefficient_ = intQuantsIn.ergunCoefficient();
         else
-            ergunCoefficient_ =
-                (Opm::getValue(intQuantsIn.ergunCoefficient()) +
-                 Opm::getValue(intQuantsEx.ergunCoefficient()))/2;
+            ergunCoefficient_ = Opm::getValue(intQuantsIn.ergunCoefficient());
+        if (elemCtx.isFocusDof(j))
+            ergunCoefficient_ += intQuantsEx.ergunCoefficient();
+        else
+            ergunCoefficient_ += Opm::getValue(intQuantsEx.ergunCoefficient());
+        ergunCoefficient_ /= 2;
 
         // obtain the mobility to passability ratio for each phase.
         for (unsigned phaseIdx=0; phaseIdx < numPhases; phaseIdx++) {
@@ -290,7 +285,7 @@ protected:
             unsigned upIdx = static_cast<unsigned>(this->upstreamIndex_(phaseIdx));
             const auto& up = elemCtx.intensiveQuantities(upIdx, timeIdx);
 
-            if (focusDofIdx == upIdx) {
+            if (elemCtx.isFocusDof(upIdx)) {
                 density_[phaseIdx] =
                     up.fluidState().density(phaseIdx);
                 mobilityPassabilityRatio_[phaseIdx] =
@@ -316,13 +311,12 @@ protected:
                                                     timeIdx,
                                                     fluidState);
 
-        auto focusDofIdx = elemCtx.focusDofIndex();
         unsigned i = static_cast<unsigned>(this->interiorDofIdx_);
         const auto& intQuantsIn = elemCtx.intensiveQuantities(i, timeIdx);
 
         // obtain the Ergun coefficient. Because we are on the boundary here, we will
         // take the Ergun coefficient of the interior
-        if (focusDofIdx == i)
+        if (elemCtx.isFocusDof(i))
             ergunCoefficient_ = intQuantsIn.ergunCoefficient();
         else
             ergunCoefficient_ = Opm::getValue(intQuantsIn.ergunCoefficient());
@@ -337,7 +331,7 @@ protected:
             if (!elemCtx.model().phaseIsConsidered(phaseIdx))
                 continue;
 
-            if (focusDofIdx == i) {
+            if (elemCtx.isFocusDof(i)) {
                 density_[phaseIdx] = intQuantsIn.fluidState().density(phaseIdx);
                 mobilityPassabilityRatio_[phaseIdx] = intQuantsIn.mobilityPassabilityRatio(phaseIdx);
             }
@@ -358,7 +352,6 @@ protected:
      */
     void calculateFluxes_(const ElementContext& elemCtx, unsigned scvfIdx, unsigned timeIdx)
     {
-        auto focusDofIdx = elemCtx.focusDofIndex();
         auto i = asImp_().interiorIndex();
         auto j = asImp_().exteriorIndex();
         const auto& intQuantsI = elemCtx.intensiveQuantities(i, timeIdx);
@@ -370,18 +363,15 @@ protected:
 
         // obtain the Ergun coefficient from the intensive quantity object. Until a
         // better method comes along, we use arithmetic averaging.
-        if (focusDofIdx == i)
-            ergunCoefficient_ =
-                (intQuantsI.ergunCoefficient() +
-                 Opm::getValue(intQuantsJ.ergunCoefficient())) / 2;
-        else if (focusDofIdx == j)
-            ergunCoefficient_ =
-                (Opm::getValue(intQuantsI.ergunCoefficient()) +
-                 intQuantsJ.ergunCoefficient()) / 2;
+        if (elemCtx.isFocusDof(i))
+            ergunCoefficient_ = intQuantsI.ergunCoefficient();
+        else
+            ergunCoefficient_ = Opm::getValue(intQuantsI.ergunCoefficient());
+        if (elemCtx.isFocusDof(j))
+            ergunCoefficient_ += intQuantsJ.ergunCoefficient();
         else
-            ergunCoefficient_ =
-                (Opm::getValue(intQuantsI.ergunCoefficient()) +
-                 Opm::getValue(intQuantsJ.ergunCoefficient())) / 2;
+            ergunCoefficient_ += Opm::getValue(intQuantsJ.ergunCoefficient());
+        ergunCoefficient_ /= 2;
 
         ///////////////
         // calculate the weights of the upstream and the downstream control volumes
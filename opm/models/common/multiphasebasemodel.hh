@@ -139,6 +139,10 @@ struct ThermalConductionLawParams<TypeTag, TTag::MultiPhaseBaseModel>
 template<class TypeTag>
 struct EnableGravity<TypeTag, TTag::MultiPhaseBaseModel> { static constexpr bool value = false; };
 
+//! compute the intrinsic permeabilities of the intersections each time they are needed
+template<class TypeTag>
+struct EnableIntersectionPermeabilityCache<TypeTag, TTag::MultiPhaseBaseModel> { static constexpr bool value = false; };
+
 
 } // namespace Opm::Properties
 
@@ -207,7 +211,8 @@ public:
 
         storage = 0;
 
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(this->gridView());
+        const auto& elemRange = this->elementRange();
+        ChunkScheduler scheduler(elemRange.size(), ThreadManager::maxThreads(), this->elementChunkSize());
         std::mutex mutex;
 #ifdef _OPENMP
 #pragma omp parallel
@@ -217,34 +222,36 @@ public:
             // moved in front of the #pragma!
             unsigned threadId = ThreadManager::threadId();
             ElementContext elemCtx(this->simulator_);
-            ElementIterator elemIt = threadedElemIt.beginParallel();
             EqVector tmp;
 
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const Element& elem = *elemIt;
-                if (elem.partitionType() != Dune::InteriorEntity)
-                    continue; // ignore ghost and overlap elements
-
-                elemCtx.updateStencil(elem);
-                elemCtx.updateIntensiveQuantities(/*timeIdx=*/0);
-
-                const auto& stencil = elemCtx.stencil(/*timeIdx=*/0);
-
-                for (unsigned dofIdx = 0; dofIdx < elemCtx.numDof(/*timeIdx=*/0); ++dofIdx) {
-                    const auto& scv = stencil.subControlVolume(dofIdx);
-                    const auto& intQuants = elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
-
-                    tmp = 0;
-                    this->localResidual(threadId).addPhaseStorage(tmp,
-                                                                  elemCtx,
-                                                                  dofIdx,
-                                                                  /*timeIdx=*/0,
-                                                                  phaseIdx);
-                    tmp *= scv.volume()*intQuants.extrusionFactor();
-
-                    mutex.lock();
-                    storage += tmp;
-                    mutex.unlock();
+            size_t beginIdx, endIdx;
+            while (scheduler.nextChunk(threadId, beginIdx, endIdx)) {
+                for (size_t elemIdx = beginIdx; elemIdx < endIdx; ++elemIdx) {
+                    const Element elem = elemRange.element(elemIdx);
+                    if (elem.partitionType() != Dune::InteriorEntity)
+                        continue; // ignore ghost and overlap elements
+
+                    elemCtx.updateStencil(elem);
+                    elemCtx.updateIntensiveQuantities(/*timeIdx=*/0);
+
+                    const auto& stencil = elemCtx.stencil(/*timeIdx=*/0);
+
+                    for (unsigned dofIdx = 0; dofIdx < elemCtx.numDof(/*timeIdx=*/0); ++dofIdx) {
+                        const auto& scv = stencil.subControlVolume(dofIdx);
+                        const auto& intQuants = elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
+
+                        tmp = 0;
+                        this->localResidual(threadId).addPhaseStorage(tmp,
+                                                                      elemCtx,
+                                                                      dofIdx,
+                                                                      /*timeIdx=*/0,
+                                                                      phaseIdx);
+                        tmp *= scv.volume()*intQuants.extrusionFactor();
+
+                        mutex.lock();
+                        storage += tmp;
+                        mutex.unlock();
+                    }
                 }
             }
         }
@@ -40,6 +40,8 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <vector>
+
 namespace Opm {
 
 /*!
@@ -89,8 +91,65 @@ public:
 
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableGravity,
                              "Use the gravity correction for the pressure gradients.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableIntersectionPermeabilityCache,
+                             "Compute the intrinsic permeability of each intersection only "
+                             "once. If the permeabilities change during the simulation, the "
+                             "problem must call invalidateIntersectionPermeabilities().");
+    }
+
+    /*!
+     * \brief Called by the Opm::Simulator in order to initialize the problem.
+     *
+     * If you overload this method don't forget to call ParentType::finishInit()
+     */
+    void finishInit()
+    {
+        ParentType::finishInit();
+
+        resizeIntersectionPermeabilityCache_();
+    }
+
+    /*!
+     * \brief Handle changes of the grid
+     */
+    void gridChanged()
+    {
+        ParentType::gridChanged();
+
+        resizeIntersectionPermeabilityCache_();
     }
 
+    /*!
+     * \brief This method restores the complete state of the problem
+     *        from disk.
+     *
+     * Since the permeabilities may have been modified by the problem in the process, the
+     * cached permeabilities of the intersections are discarded.
+     *
+     * \tparam Restarter The deserializer type
+     *
+     * \param res The deserializer object
+     */
+    template <class Restarter>
+    void deserialize(Restarter& res)
+    {
+        ParentType::deserialize(res);
+
+        invalidateIntersectionPermeabilities();
+    }
+
+    /*!
+     * \brief Discard all cached intrinsic permeabilities of intersections.
+     *
+     * If the EnableIntersectionPermeabilityCache parameter is set, problems which modify
+     * the intrinsic permeabilities of their degrees of freedom after the simulation has
+     * been started must call this method after each modification. Invalidating the cache
+     * is cheap, the permeabilities of each intersection are computed again the next time
+     * they are required.
+     */
+    void invalidateIntersectionPermeabilities()
+    { ++intersectionPermeabilityGeneration_; }
+
     /*!
      * \brief Returns the intrinsic permeability of an intersection.
      *
@@ -99,6 +158,11 @@ public:
      * exterior finite volumes and averages them harmonically. Note that if this function
      * is defined, the intrinsicPermeability() method does not need to be defined by the
      * problem (if a finite-volume discretization is used).
+     *
+     * If the EnableIntersectionPermeabilityCache parameter is set, the result is cached
+     * for each pair of element and intersection index. The cache is discarded if the grid
+     * changes, if the problem is restored from a restart file and if the problem calls
+     * invalidateIntersectionPermeabilities().
      */
     template <class Context>
     void intersectionIntrinsicPermeability(DimMatrix& result,
@@ -106,16 +170,30 @@ public:
                                            unsigned intersectionIdx,
                                            unsigned timeIdx) const
     {
-        const auto& scvf = context.stencil(timeIdx).interiorFace(intersectionIdx);
+        // the cache is only available after the problem has been fully initialized
+        unsigned elemIdx = 0;
+        if (enableIntersectionPermeabilityCache_)
+            elemIdx = this->elementMapper().index(context.element());
+        if (elemIdx >= intersectionPermeabilityCache_.size()) {
+            averageIntrinsicPermeability_(result, context, intersectionIdx, timeIdx);
+            return;
+        }
 
-        const DimMatrix& K1 = asImp_().intrinsicPermeability(context, scvf.interiorIndex(), timeIdx);
-        const DimMatrix& K2 = asImp_().intrinsicPermeability(context, scvf.exteriorIndex(), timeIdx);
+        // the cache entries of an element are only accessed by the thread which
+        // currently deals with that element, so no locking is required here.
+        auto& elemCache = intersectionPermeabilityCache_[elemIdx];
+        if (intersectionIdx >= elemCache.size()) {
+            size_t numInteriorFaces = context.stencil(timeIdx).numInteriorFaces();
+            elemCache.resize(numInteriorFaces);
+        }
 
-        // entry-wise harmonic mean. this is almost certainly wrong if
-        // you have off-main diagonal entries in your permeabilities!
-        for (unsigned i = 0; i < dimWorld; ++i)
-            for (unsigned j = 0; j < dimWorld; ++j)
-                result[i][j] = Opm::harmonicMean(K1[i][j], K2[i][j]);
+        auto& entry = elemCache[intersectionIdx];
+        if (entry.generation != intersectionPermeabilityGeneration_) {
+            averageIntrinsicPermeability_(entry.permeability, context, intersectionIdx, timeIdx);
+            entry.generation = intersectionPermeabilityGeneration_;
+        }
+
+        result = entry.permeability;
     }
 
     /*!
@@ -298,6 +376,15 @@ public:
     const DimVector& gravity() const
     { return gravity_; }
 
+    /*!
+     * \brief Returns true if the <tt>EnableGravity</tt> parameter is set.
+     *
+     * In contrast to retrieving the parameter, calling this method is cheap enough to be
+     * done for each sub-control volume face.
+     */
+    bool enableGravity() const
+    { return enableGravity_; }
+
     /*!
      * \brief Mark grid cells for refinement or coarsening
      *
@@ -376,9 +463,49 @@ protected:
         return ret;
     }
 
+    /*!
+     * \brief Computes the intrinsic permeability of an intersection by harmonically
+     *        averaging the permeabilities of its interior and exterior finite volumes.
+     */
+    template <class Context>
+    void averageIntrinsicPermeability_(DimMatrix& result,
+                                       const Context& context,
+                                       unsigned intersectionIdx,
+                                       unsigned timeIdx) const
+    {
+        const auto& scvf = context.stencil(timeIdx).interiorFace(intersectionIdx);
+
+        const DimMatrix& K1 = asImp_().intrinsicPermeability(context, scvf.interiorIndex(), timeIdx);
+        const DimMatrix& K2 = asImp_().intrinsicPermeability(context, scvf.exteriorIndex(), timeIdx);
+
+        // entry-wise harmonic mean. this is almost certainly wrong if
+        // you have off-main diagonal entries in your permeabilities!
+        for (unsigned i = 0; i < dimWorld; ++i)
+            for (unsigned j = 0; j < dimWorld; ++j)
+                result[i][j] = Opm::harmonicMean(K1[i][j], K2[i][j]);
+    }
+
     DimVector gravity_;
+    bool enableGravity_;
 
 private:
+    // the cached permeability of an intersection. it is only valid if its generation
+    // matches the current generation of the cache
+    struct IntersectionPermeability_
+    {
+        DimMatrix permeability;
+        unsigned generation = 0;
+    };
+
+    void resizeIntersectionPermeabilityCache_()
+    {
+        intersectionPermeabilityCache_.clear();
+        if (enableIntersectionPermeabilityCache_)
+            intersectionPermeabilityCache_.resize(this->elementMapper().size());
+
+        invalidateIntersectionPermeabilities();
+    }
+
     //! Returns the implementation of the problem (i.e. static polymorphism)
     Implementation& asImp_()
     { return *static_cast<Implementation *>(this); }
@@ -388,10 +515,20 @@ private:
 
     void init_()
     {
+        enableGravity_ = EWOMS_GET_PARAM(TypeTag, bool, EnableGravity);
+
         gravity_ = 0.0;
-        if (EWOMS_GET_PARAM(TypeTag, bool, EnableGravity))
+        if (enableGravity_)
             gravity_[dimWorld-1]  = -9.81;
+
+        enableIntersectionPermeabilityCache_ =
+            EWOMS_GET_PARAM(TypeTag, bool, EnableIntersectionPermeabilityCache);
+        intersectionPermeabilityGeneration_ = 0;
     }
+
+    bool enableIntersectionPermeabilityCache_;
+    unsigned intersectionPermeabilityGeneration_;
+    mutable std::vector<std::vector<IntersectionPermeability_> > intersectionPermeabilityCache_;
 };
 
 } // namespace Opm
@@ -80,6 +80,9 @@ struct EnableGravity { using type = UndefinedProperty; };
 //! Enable diffusive fluxes?
 template<class TypeTag, class MyTypeTag>
 struct EnableDiffusion { using type = UndefinedProperty; };
+//! Specify whether the intrinsic permeabilities of the intersections should be cached
+template<class TypeTag, class MyTypeTag>
+struct EnableIntersectionPermeabilityCache { using type = UndefinedProperty; };
 
 } // namespace Opm::Properties
 
@@ -201,6 +201,15 @@ public:
     unsigned focusDofIndex() const
     { return elemCtx_.focusDofIndex(); }
 
+    /*!
+     * \brief Returns true iff the derivatives w.r.t. the primary variables of a
+     *        sub-control volume are currently considered.
+     *
+     * \param dofIdx The local index of the sub-control volume
+     */
+    bool isFocusDof(unsigned dofIdx) const
+    { return elemCtx_.isFocusDof(dofIdx); }
+
     /*!
      * \brief Return the local sub-control volume index of the
      *        interior of a boundary segment
@@ -34,6 +34,7 @@
 #include "fvbaselinearizer.hh"
 #include "fvbasefdlocallinearizer.hh"
 #include "fvbaseadlocallinearizer.hh"
+#include "fvbasevectoradlocallinearizer.hh"
 #include "fvbaselocalresidual.hh"
 #include "fvbaseelementcontext.hh"
 #include "fvbaseboundarycontext.hh"
@@ -49,6 +50,8 @@
 
 #include <opm/models/parallel/gridcommhandles.hh>
 #include <opm/models/parallel/threadmanager.hh>
+#include <opm/models/parallel/elementrange.hh>
+#include <opm/models/parallel/chunkscheduler.hh>
 #include <opm/simulators/linalg/nullborderlistmanager.hh>
 #include <opm/models/utils/simulator.hh>
 #include <opm/models/utils/alignedallocator.hh>
@@ -219,8 +222,15 @@ struct ThreadManager<TypeTag, TTag::FvBaseDiscretization> { using type = Opm::Th
 template<class TypeTag>
 struct ThreadsPerProcess<TypeTag, TTag::FvBaseDiscretization> { static constexpr int value = 1; };
 template<class TypeTag>
+struct ElementChunkSize<TypeTag, TTag::FvBaseDiscretization> { static constexpr int value = 16; };
+template<class TypeTag>
 struct UseLinearizationLock<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = true; };
 
+//! By default, linearize the elements in the order of the grid and use locking if
+//! required by the discretization
+template<class TypeTag>
+struct EnableColoredLinearization<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
+
 /*!
  * \brief Linearizer for the global system of equations.
  */
@@ -261,6 +271,10 @@ struct EnableVtkOutput<TypeTag, TTag::FvBaseDiscretization> { static constexpr b
 template<class TypeTag>
 struct EnableAsyncVtkOutput<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = true; };
 
+//! By default, use Dune's VTK writer
+template<class TypeTag>
+struct EnableNativeVtkOutput<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
+
 //! Set the format of the VTK output to ASCII by default
 template<class TypeTag>
 struct VtkOutputFormat<TypeTag, TTag::FvBaseDiscretization> { static constexpr int value = Dune::VTK::ascii; };
@@ -269,6 +283,10 @@ struct VtkOutputFormat<TypeTag, TTag::FvBaseDiscretization> { static constexpr i
 template<class TypeTag>
 struct EnableStorageCache<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
 
+// do not keep the stencils of all elements in memory by default
+template<class TypeTag>
+struct EnableStencilCache<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
+
 // disable constraints by default
 template<class TypeTag>
 struct EnableConstraints<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
@@ -357,6 +375,7 @@ class FvBaseDiscretization
     using ExtensiveQuantities = GetPropType<TypeTag, Properties::ExtensiveQuantities>;
     using GradientCalculator = GetPropType<TypeTag, Properties::GradientCalculator>;
     using Stencil = GetPropType<TypeTag, Properties::Stencil>;
+    using StencilGeometryCache = typename Stencil::GeometryCache;
     using DiscBaseOutputModule = GetPropType<TypeTag, Properties::DiscBaseOutputModule>;
     using GridCommHandleFactory = GetPropType<TypeTag, Properties::GridCommHandleFactory>;
     using NewtonMethod = GetPropType<TypeTag, Properties::NewtonMethod>;
@@ -439,8 +458,15 @@ public:
         , enableGridAdaptation_( EWOMS_GET_PARAM(TypeTag, bool, EnableGridAdaptation) )
         , enableIntensiveQuantityCache_(EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantityCache))
         , enableStorageCache_(EWOMS_GET_PARAM(TypeTag, bool, EnableStorageCache))
+        , enableStencilCache_(EWOMS_GET_PARAM(TypeTag, bool, EnableStencilCache))
         , enableThermodynamicHints_(EWOMS_GET_PARAM(TypeTag, bool, EnableThermodynamicHints))
     {
+        int elementChunkSize = EWOMS_GET_PARAM(TypeTag, int, ElementChunkSize);
+        if (elementChunkSize < 1)
+            throw std::invalid_argument("The number of elements per chunk must be at least 1 (is "
+                                        +std::to_string(elementChunkSize)+")");
+        elementChunkSize_ = static_cast<size_t>(elementChunkSize);
+
 #if HAVE_DUNE_FEM
         if (enableGridAdaptation_ && !Dune::Fem::Capabilities::isLocallyAdaptive<Grid>::v)
             throw std::invalid_argument("Grid adaptation enabled, but chosen Grid is not capable"
@@ -507,7 +533,10 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableThermodynamicHints, "Enable thermodynamic hints");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableIntensiveQuantityCache, "Turn on caching of intensive quantities");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableStorageCache, "Store previous storage terms and avoid re-calculating them.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableStencilCache, "Keep the finite volume geometry of all elements in memory instead of re-computing it for each visit.");
         EWOMS_REGISTER_PARAM(TypeTag, std::string, OutputDir, "The directory to which result files are written");
+        EWOMS_REGISTER_PARAM(TypeTag, int, ElementChunkSize,
+                             "The number of consecutive elements handed to a thread at once in threaded loops over the grid");
     }
 
     /*!
@@ -515,6 +544,10 @@ public:
      */
     void finishInit()
     {
+        // (re-)compute the finite volume geometry of all elements if it is to be
+        // cached. this must happen first because the loop below already makes use of it.
+        updateStencilGeometryCache_();
+
         // initialize the volume of the finite volumes to zero
         size_t numDof = asImp_().numGridDof();
         dofTotalVolume_.resize(numDof);
@@ -770,17 +803,21 @@ public:
         invalidateIntensiveQuantitiesCache(timeIdx);
 
         // loop over all elements...
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_);
+        const auto& elemRange = elementRange();
+        ChunkScheduler scheduler(elemRange.size(), ThreadManager::maxThreads(), elementChunkSize_);
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
+            unsigned threadId = ThreadManager::threadId();
             ElementContext elemCtx(simulator_);
-            ElementIterator elemIt = threadedElemIt.beginParallel();
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const Element& elem = *elemIt;
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+            size_t beginIdx, endIdx;
+            while (scheduler.nextChunk(threadId, beginIdx, endIdx)) {
+                for (size_t elemIdx = beginIdx; elemIdx < endIdx; ++elemIdx) {
+                    const Element elem = elemRange.element(elemIdx);
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                }
             }
         }
     }
@@ -896,7 +933,8 @@ public:
         dest = 0;
 
         std::mutex mutex;
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_);
+        const auto& elemRange = elementRange();
+        ChunkScheduler scheduler(elemRange.size(), ThreadManager::maxThreads(), elementChunkSize_);
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -905,27 +943,29 @@ public:
             // moved in front of the #pragma!
             unsigned threadId = ThreadManager::threadId();
             ElementContext elemCtx(simulator_);
-            ElementIterator elemIt = threadedElemIt.beginParallel();
             LocalEvalBlockVector residual, storageTerm;
 
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const Element& elem = *elemIt;
-                if (elem.partitionType() != Dune::InteriorEntity)
-                    continue;
+            size_t beginIdx, endIdx;
+            while (scheduler.nextChunk(threadId, beginIdx, endIdx)) {
+                for (size_t elemIdx = beginIdx; elemIdx < endIdx; ++elemIdx) {
+                    const Element elem = elemRange.element(elemIdx);
+                    if (elem.partitionType() != Dune::InteriorEntity)
+                        continue;
 
-                elemCtx.updateAll(elem);
-                residual.resize(elemCtx.numDof(/*timeIdx=*/0));
-                storageTerm.resize(elemCtx.numPrimaryDof(/*timeIdx=*/0));
-                asImp_().localResidual(threadId).eval(residual, elemCtx);
-
-                size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
-                mutex.lock();
-                for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; ++dofIdx) {
-                    unsigned globalI = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-                    for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
-                        dest[globalI][eqIdx] += Toolbox::value(residual[dofIdx][eqIdx]);
+                    elemCtx.updateAll(elem);
+                    residual.resize(elemCtx.numDof(/*timeIdx=*/0));
+                    storageTerm.resize(elemCtx.numPrimaryDof(/*timeIdx=*/0));
+                    asImp_().localResidual(threadId).eval(residual, elemCtx);
+
+                    size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+                    mutex.lock();
+                    for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; ++dofIdx) {
+                        unsigned globalI = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+                        for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+                            dest[globalI][eqIdx] += Toolbox::value(residual[dofIdx][eqIdx]);
+                    }
+                    mutex.unlock();
                 }
-                mutex.unlock();
             }
         }
 
@@ -957,7 +997,8 @@ public:
         storage = 0;
 
         std::mutex mutex;
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView());
+        const auto& elemRange = elementRange();
+        ChunkScheduler scheduler(elemRange.size(), ThreadManager::maxThreads(), elementChunkSize_);
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -966,31 +1007,33 @@ public:
             // moved in front of the #pragma!
             unsigned threadId = ThreadManager::threadId();
             ElementContext elemCtx(simulator_);
-            ElementIterator elemIt = threadedElemIt.beginParallel();
             LocalEvalBlockVector elemStorage;
 
             // in this method, we need to disable the storage cache because we want to
             // evaluate the storage term for other time indices than the most recent one
             elemCtx.setEnableStorageCache(false);
 
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const Element& elem = *elemIt;
-                if (elem.partitionType() != Dune::InteriorEntity)
-                    continue; // ignore ghost and overlap elements
+            size_t beginIdx, endIdx;
+            while (scheduler.nextChunk(threadId, beginIdx, endIdx)) {
+                for (size_t elemIdx = beginIdx; elemIdx < endIdx; ++elemIdx) {
+                    const Element elem = elemRange.element(elemIdx);
+                    if (elem.partitionType() != Dune::InteriorEntity)
+                        continue; // ignore ghost and overlap elements
 
-                elemCtx.updateStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(timeIdx);
+                    elemCtx.updateStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(timeIdx);
 
-                size_t numPrimaryDof = elemCtx.numPrimaryDof(timeIdx);
-                elemStorage.resize(numPrimaryDof);
+                    size_t numPrimaryDof = elemCtx.numPrimaryDof(timeIdx);
+                    elemStorage.resize(numPrimaryDof);
 
-                localResidual(threadId).evalStorage(elemStorage, elemCtx, timeIdx);
+                    localResidual(threadId).evalStorage(elemStorage, elemCtx, timeIdx);
 
-                mutex.lock();
-                for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; ++dofIdx)
-                    for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
-                        storage[eqIdx] += Toolbox::value(elemStorage[dofIdx][eqIdx]);
-                mutex.unlock();
+                    mutex.lock();
+                    for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; ++dofIdx)
+                        for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                            storage[eqIdx] += Toolbox::value(elemStorage[dofIdx][eqIdx]);
+                    mutex.unlock();
+                }
             }
         }
 
@@ -1377,6 +1420,7 @@ public:
                 elementMapper_.update();
                 vertexMapper_.update();
                 resetLinearizer();
+                outputElemCtx_.clear();
 
                 // this is a bit hacky because it supposes that Problem::finishInit()
                 // works fine multiple times in a row.
@@ -1720,40 +1764,86 @@ public:
     void prepareOutputFields() const
     {
         bool needFullContextUpdate = false;
+        bool dofDataOnly = true;
         auto modIt = outputModules_.begin();
         const auto& modEndIt = outputModules_.end();
         for (; modIt != modEndIt; ++modIt) {
+            (*modIt)->beginOutputStep();
             (*modIt)->allocBuffers();
             needFullContextUpdate = needFullContextUpdate || (*modIt)->needExtensiveQuantities();
+            dofDataOnly = dofDataOnly && (*modIt)->dofDataOnly();
         }
 
-        // iterate over grid
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView());
+        // if none of the modules needs more than the intensive quantities of the
+        // individual degrees of freedom and all of these are available from the cache,
+        // the loop over the elements can be skipped.
+        size_t numDof = asImp_().numGridDof();
+        if (dofDataOnly && !needFullContextUpdate && asImp_().storeIntensiveQuantities()) {
+            for (unsigned dofIdx = 0; dofIdx < numDof && dofDataOnly; ++dofIdx)
+                dofDataOnly = !isLocalDof_[dofIdx] || intensiveQuantityCacheUpToDate_[/*timeIdx=*/0][dofIdx];
+        }
+        else
+            dofDataOnly = false;
+
+        if (dofDataOnly) {
 #ifdef _OPENMP
-#pragma omp parallel
+#pragma omp parallel for schedule(static)
 #endif
-        {
-            ElementContext elemCtx(simulator_);
-            ElementIterator elemIt = threadedElemIt.beginParallel();
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const auto& elem = *elemIt;
-                if (elem.partitionType() != Dune::InteriorEntity)
-                    // ignore non-interior entities
+            for (int dofIdx = 0; dofIdx < static_cast<int>(numDof); ++dofIdx) {
+                if (!isLocalDof_[static_cast<unsigned>(dofIdx)])
+                    // ignore DOFs which are not touched by an interior element
                     continue;
 
-                if (needFullContextUpdate)
-                    elemCtx.updateAll(elem);
-                else {
-                    elemCtx.updatePrimaryStencil(elem);
-                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                }
-
-                // we cannot reuse the "modIt" variable here because the code here might
-                // be threaded and "modIt" is is the same for all threads, i.e., if a
-                // given thread modifies it, the changes affect all threads.
+                const auto& intQuants = intensiveQuantityCache_[/*timeIdx=*/0][static_cast<unsigned>(dofIdx)];
                 auto modIt2 = outputModules_.begin();
                 for (; modIt2 != modEndIt; ++modIt2)
-                    (*modIt2)->processElement(elemCtx);
+                    (*modIt2)->processDof(static_cast<unsigned>(dofIdx), intQuants);
+            }
+
+            return;
+        }
+
+        // the element contexts are kept between two output events because creating
+        // them is relatively expensive
+        if (outputElemCtx_.size() != ThreadManager::maxThreads()) {
+            outputElemCtx_.clear();
+            for (unsigned threadId = 0; threadId < ThreadManager::maxThreads(); ++threadId)
+                outputElemCtx_.emplace_back(new ElementContext(simulator_));
+        }
+
+        // iterate over grid
+        const auto& elemRange = elementRange();
+        ChunkScheduler scheduler(elemRange.size(), ThreadManager::maxThreads(), elementChunkSize_);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            unsigned threadId = ThreadManager::threadId();
+            ElementContext& elemCtx = *outputElemCtx_[threadId];
+            size_t beginIdx, endIdx;
+            while (scheduler.nextChunk(threadId, beginIdx, endIdx)) {
+                for (size_t elemIdx = beginIdx; elemIdx < endIdx; ++elemIdx) {
+                    const Element elem = elemRange.element(elemIdx);
+                    if (elem.partitionType() != Dune::InteriorEntity)
+                        // ignore non-interior entities
+                        continue;
+
+                    // note that the element context uses the cached intensive
+                    // quantities if they are available
+                    if (needFullContextUpdate)
+                        elemCtx.updateAll(elem);
+                    else {
+                        elemCtx.updatePrimaryStencil(elem);
+                        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    }
+
+                    // we cannot reuse the "modIt" variable here because the code here
+                    // might be threaded and "modIt" is is the same for all threads, i.e.,
+                    // if a given thread modifies it, the changes affect all threads.
+                    auto modIt2 = outputModules_.begin();
+                    for (; modIt2 != modEndIt; ++modIt2)
+                        (*modIt2)->processElement(elemCtx);
+                }
             }
         }
     }
@@ -1776,6 +1866,41 @@ public:
     const GridView& gridView() const
     { return gridView_; }
 
+    /*!
+     * \brief Returns a flat list of all elements of the grid view.
+     *
+     * The list is only rebuilt if the grid has changed since the last call, so this
+     * method must be called in a sequential context.
+     */
+    const ElementRange<GridView>& elementRange() const
+    {
+        elementRange_.update(gridView_, simulator_.vanguard().gridSequenceNumber());
+        return elementRange_;
+    }
+
+    /*!
+     * \brief Returns the finite volume geometry of all elements.
+     *
+     * If the stencil cache is disabled or if the grid has changed since the cache was
+     * built, a null pointer is returned and the stencils must be computed from the
+     * geometries of the grid.
+     */
+    const StencilGeometryCache* stencilGeometryCache() const
+    {
+        if (!enableStencilCache_
+            || stencilGeometryCacheSequenceNumber_ != simulator_.vanguard().gridSequenceNumber())
+            return nullptr;
+
+        return &stencilGeometryCache_;
+    }
+
+    /*!
+     * \brief Returns the number of consecutive elements which are handed out to a thread
+     *        at once by threaded loops over the grid.
+     */
+    size_t elementChunkSize() const
+    { return elementChunkSize_; }
+
     /*!
      * \brief Add a module for an auxiliary equation.
      *
@@ -1872,6 +1997,32 @@ public:
     { return updateTimer_; }
 
 protected:
+    void updateStencilGeometryCache_()
+    {
+        if (!enableStencilCache_)
+            return;
+
+        stencilGeometryCache_.reset(elementMapper_.size());
+
+        Stencil stencil(gridView_, asImp_().dofMapper());
+        ElementIterator elemIt = gridView_.template begin</*codim=*/0>();
+        const ElementIterator& elemEndIt = gridView_.template end</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            stencil.update(elem);
+            stencil.storeGeometry(stencilGeometryCache_,
+                                  static_cast<unsigned>(elementMapper_.index(elem)));
+        }
+        stencilGeometryCache_.shrinkToFit();
+
+        stencilGeometryCacheSequenceNumber_ = simulator_.vanguard().gridSequenceNumber();
+
+        if (verbose_())
+            std::cout << "Memory used by the stencil geometry cache of rank 0: "
+                      << stencilGeometryCache_.memoryUsage()/(1024.0*1024.0) << " MiB\n"
+                      << std::flush;
+    }
+
     void resizeAndResetIntensiveQuantitiesCache_()
     {
         // allocate the storage cache
@@ -1972,6 +2123,7 @@ protected:
 
 
     std::list<BaseOutputModule<TypeTag>*> outputModules_;
+    mutable std::vector<std::unique_ptr<ElementContext> > outputElemCtx_;
 
     Scalar gridTotalVolume_;
     std::vector<Scalar> dofTotalVolume_;
@@ -1979,9 +2131,16 @@ protected:
 
     mutable GlobalEqVector storageCache_[historySize];
 
+    mutable ElementRange<GridView> elementRange_;
+    size_t elementChunkSize_;
+
+    StencilGeometryCache stencilGeometryCache_;
+    int stencilGeometryCacheSequenceNumber_;
+
     bool enableGridAdaptation_;
     bool enableIntensiveQuantityCache_;
     bool enableStorageCache_;
+    bool enableStencilCache_;
     bool enableThermodynamicHints_;
 };
 } // namespace Opm
@@ -33,6 +33,7 @@
 #include <opm/models/discretization/common/linearizationtype.hh>
 #include <opm/models/utils/alignedallocator.hh>
 
+#include <opm/material/common/MathToolbox.hpp>
 #include <opm/material/common/Unused.hpp>
 
 #include <dune/common/fvector.hh>
@@ -53,6 +54,8 @@ class FvBaseElementContext
     using Implementation = GetPropType<TypeTag, Properties::ElementContext>;
 
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
+    using Toolbox = Opm::MathToolbox<Evaluation>;
     using PrimaryVariables = GetPropType<TypeTag, Properties::PrimaryVariables>;
     using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
     using ExtensiveQuantities = GetPropType<TypeTag, Properties::ExtensiveQuantities>;
@@ -97,9 +100,10 @@ public:
     {
         // remember the simulator object
         simulatorPtr_ = &simulator;
-        enableStorageCache_ = EWOMS_GET_PARAM(TypeTag, bool, EnableStorageCache);
+        enableStorageCache_ = simulator.model().enableStorageCache();
         stashedDofIdx_ = -1;
         focusDofIdx_ = -1;
+        focusAllPrimaryDofs_ = false;
     }
 
     static void *operator new(size_t size)
@@ -133,10 +137,16 @@ public:
         // remember the current element
         elemPtr_ = &elem;
 
-        // update the stencil. the center gradients are quite expensive to calculate and
-        // most models don't need them, so that we only do this if the model explicitly
-        // enables them
-        stencil_.update(elem);
+        // update the stencil. if the model keeps the finite volume geometry of all
+        // elements in memory, it is only copied. the center gradients are quite
+        // expensive to calculate and most models don't need them, so that we only do
+        // this if the model explicitly enables them
+        const auto* geometryCache = model().stencilGeometryCache();
+        if (geometryCache)
+            stencil_.update(elem, *geometryCache,
+                            static_cast<unsigned>(model().elementMapper().index(elem)));
+        else
+            stencil_.update(elem);
 
         // resize the arrays containing the flux and the volume variables
         dofVars_.resize(stencil_.numDof());
@@ -258,7 +268,24 @@ public:
      * focused on.
      */
     void setFocusDofIndex(unsigned dofIdx)
-    { focusDofIdx_ = dofIdx; }
+    {
+        focusDofIdx_ = dofIdx;
+        focusAllPrimaryDofs_ = false;
+    }
+
+    /*!
+     * \brief Focus on all primary degrees of freedom of the element at once
+     *
+     * I.e., in the case of automatic differentiation, the evaluations returned by
+     * makeEvaluation() store the derivatives w.r.t. the primary variables of the local
+     * primary DOF 'dofIdx' at the offset 'dofIdx*numEq'. The Evaluation type thus must
+     * be able to hold numEq derivatives for each primary DOF of the stencil.
+     */
+    void setFocusAllPrimaryDofs()
+    {
+        focusDofIdx_ = -1;
+        focusAllPrimaryDofs_ = true;
+    }
 
     /*!
      * \brief Returns the degree of freedom on which the simulator is currently "focused" on
@@ -268,6 +295,55 @@ public:
     unsigned focusDofIndex() const
     { return focusDofIdx_; }
 
+    /*!
+     * \brief Returns true iff the derivatives w.r.t. the primary variables of a
+     *        degree of freedom are currently considered.
+     *
+     * \param dofIdx The local index of the degree of freedom in the current element.
+     */
+    bool isFocusDof(unsigned dofIdx) const
+    {
+        if (focusAllPrimaryDofs_)
+            return dofIdx < numPrimaryDof(/*timeIdx=*/0);
+        return static_cast<int>(dofIdx) == focusDofIdx_;
+    }
+
+    /*!
+     * \brief Return a primary variable of a degree of freedom as an evaluation.
+     *
+     * This is the same as PrimaryVariables::makeEvaluation() unless the context
+     * focuses on all primary DOFs. In this case, the derivatives of the primary
+     * variables of each primary DOF are placed at the offset 'dofIdx*numEq' while the
+     * primary variables of all other DOFs are constant.
+     *
+     * \param dofIdx The local index of the degree of freedom in the current element.
+     * \param varIdx The index of the primary variable.
+     * \param timeIdx The index of the solution vector used by the time discretization.
+     * \param linearizationType The linearization type (see linearizationType())
+     */
+    Evaluation makeEvaluation(unsigned dofIdx,
+                              unsigned varIdx,
+                              unsigned timeIdx,
+                              LinearizationType linearizationType = LinearizationType()) const
+    {
+        const PrimaryVariables& priVars = primaryVars(dofIdx, timeIdx);
+        if (!focusAllPrimaryDofs_)
+            return priVars.makeEvaluation(varIdx, timeIdx, linearizationType);
+
+        if (timeIdx != linearizationType.time || dofIdx >= numPrimaryDof(timeIdx))
+            return Toolbox::createConstant(priVars[varIdx]);
+        return Toolbox::createVariable(priVars[varIdx], dofIdx*numEq + varIdx);
+    }
+
+    /*!
+     * \brief Returns true iff the context focuses on all primary degrees of freedom
+     *        at once.
+     *
+     * \copydetails setFocusAllPrimaryDofs()
+     */
+    bool focusAllPrimaryDofs() const
+    { return focusAllPrimaryDofs_; }
+
     /*!
      * \brief Returns the linearization type.
      *
@@ -567,6 +643,15 @@ protected:
             dofVars_[dofIdx].thermodynamicHint[timeIdx] =
                 model().thermodynamicHint(globalIdx, timeIdx);
 
+            // the cached intensive quantities exhibit the derivatives w.r.t. the
+            // primary variables of their own DOF at offset zero. if the context focuses
+            // on all primary DOFs, the ones of the current solution need to be
+            // recalculated and must not be put into the cache.
+            if (focusAllPrimaryDofs_ && timeIdx == 0) {
+                updateSingleIntQuants_(dofSol, dofIdx, timeIdx);
+                continue;
+            }
+
             const auto *cachedIntQuants = model().cachedIntensiveQuantities(globalIdx, timeIdx);
             if (cachedIntQuants) {
                 dofVars_[dofIdx].intensiveQuantities[timeIdx] = *cachedIntQuants;
@@ -607,6 +692,7 @@ protected:
 
     int stashedDofIdx_;
     int focusDofIdx_;
+    bool focusAllPrimaryDofs_;
     bool enableStorageCache_;
 };
 
@@ -200,6 +200,7 @@ public:
         simulatorPtr_ = &simulator;
         delete internalElemContext_;
         internalElemContext_ = new ElementContext(simulator);
+        differenceMethod_ = EWOMS_GET_PARAM(TypeTag, int, NumericDifferenceMethod);
     }
 
     /*!
@@ -334,8 +335,8 @@ protected:
     /*!
      * \brief Returns the numeric difference method which is applied.
      */
-    static int numericDifferenceMethod_()
-    { return EWOMS_GET_PARAM(TypeTag, int, NumericDifferenceMethod); }
+    int numericDifferenceMethod_() const
+    { return differenceMethod_; }
 
     /*!
      * \brief Resize all internal attributes to the size of the
@@ -506,6 +507,7 @@ protected:
     Model *modelPtr_;
 
     ElementContext *internalElemContext_;
+    int differenceMethod_;
 
     LocalEvalBlockVector residual_;
     LocalEvalBlockVector derivResidual_;
@@ -109,16 +109,15 @@ public:
         const auto& face = elemCtx.stencil(/*timeIdx=*/0).interiorFace(fapIdx);
         auto i = face.interiorIndex();
         auto j = face.exteriorIndex();
-        auto focusDofIdx = elemCtx.focusDofIndex();
 
         // use the average weighted by distance...
         ReturnType value;
-        if (i == focusDofIdx)
+        if (elemCtx.isFocusDof(i))
             value = quantityCallback(i)*interiorDistance;
         else
             value = Opm::getValue(quantityCallback(i))*interiorDistance;
 
-        if (j == focusDofIdx)
+        if (elemCtx.isFocusDof(j))
             value += quantityCallback(j)*exteriorDistance;
         else
             value += Opm::getValue(quantityCallback(j))*exteriorDistance;
@@ -155,11 +154,10 @@ public:
         const auto& face = elemCtx.stencil(/*timeIdx=*/0).interiorFace(fapIdx);
         auto i = face.interiorIndex();
         auto j = face.exteriorIndex();
-        auto focusDofIdx = elemCtx.focusDofIndex();
 
         // use the average weighted by distance...
         ReturnType value;
-        if (i == focusDofIdx) {
+        if (elemCtx.isFocusDof(i)) {
             value = quantityCallback(i);
             for (int k = 0; k < value.size(); ++k)
                 value[k] *= interiorDistance;
@@ -170,7 +168,7 @@ public:
                 value[k] = Opm::getValue(dofVal[k])*interiorDistance;
         }
 
-        if (j == focusDofIdx) {
+        if (elemCtx.isFocusDof(j)) {
             const auto& dofVal = quantityCallback(j);
             for (int k = 0; k < dofVal.size(); ++k)
                 value[k] += dofVal[k]*exteriorDistance;
@@ -210,26 +208,20 @@ public:
 
         auto i = face.interiorIndex();
         auto j = face.exteriorIndex();
-        auto focusIdx = elemCtx.focusDofIndex();
 
         const auto& interiorPos = stencil.subControlVolume(i).globalPos();
         const auto& exteriorPos = stencil.subControlVolume(j).globalPos();
 
         Evaluation deltay;
-        if (i == focusIdx) {
-            deltay =
-                Opm::getValue(quantityCallback(j))
-                - quantityCallback(i);
-        }
-        else if (j == focusIdx) {
-            deltay =
-                quantityCallback(j)
-                - Opm::getValue(quantityCallback(i));
-        }
+        if (elemCtx.isFocusDof(j))
+            deltay = quantityCallback(j);
         else
-            deltay =
-                Opm::getValue(quantityCallback(j))
-                - Opm::getValue(quantityCallback(i));
+            deltay = Opm::getValue(quantityCallback(j));
+
+        if (elemCtx.isFocusDof(i))
+            deltay -= quantityCallback(i);
+        else
+            deltay -= Opm::getValue(quantityCallback(i));
 
         Scalar distSquared = 0.0;
         for (unsigned dimIdx = 0; dimIdx < dimWorld; ++dimIdx) {
@@ -292,7 +284,7 @@ public:
         const auto& face = stencil.boundaryFace(faceIdx);
 
         Evaluation deltay;
-        if (face.interiorIndex() == elemCtx.focusDofIndex())
+        if (elemCtx.isFocusDof(face.interiorIndex()))
             deltay = quantityCallback.boundaryValue() - quantityCallback(face.interiorIndex());
         else
             deltay =
@@ -34,7 +34,10 @@
 #include <opm/models/parallel/gridcommhandles.hh>
 #include <opm/models/parallel/threadmanager.hh>
 #include <opm/models/parallel/threadedentityiterator.hh>
+#include <opm/models/parallel/chunkscheduler.hh>
+#include <opm/models/parallel/collectivebatch.hh>
 #include <opm/models/discretization/common/baseauxiliarymodule.hh>
+#include <opm/simulators/linalg/sparsitypattern.hh>
 
 #include <opm/material/common/Exceptions.hpp>
 
@@ -49,6 +52,7 @@
 #include <set>
 #include <exception>   // current_exception, rethrow_exception
 #include <mutex>
+#include <atomic>
 
 namespace Opm {
 // forward declarations
@@ -93,6 +97,7 @@ class FvBaseLinearizer
 
     using Element = typename GridView::template Codim<0>::Entity;
     using ElementIterator = typename GridView::template Codim<0>::Iterator;
+    using ElementSeed = typename Element::EntitySeed;
 
     using Vector = GlobalEqVector;
 
@@ -115,6 +120,7 @@ public:
         : jacobian_()
     {
         simulatorPtr_ = 0;
+        enableColoredLinearization_ = false;
     }
 
     ~FvBaseLinearizer()
@@ -129,7 +135,10 @@ public:
      * \brief Register all run-time parameters for the Jacobian linearizer.
      */
     static void registerParameters()
-    { }
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableColoredLinearization,
+                             "Linearize the grid elements color by color without locking");
+    }
 
     /*!
      * \brief Initialize the linearizer.
@@ -143,6 +152,7 @@ public:
     void init(Simulator& simulator)
     {
         simulatorPtr_ = &simulator;
+        enableColoredLinearization_ = EWOMS_GET_PARAM(TypeTag, bool, EnableColoredLinearization);
         eraseMatrix();
         auto it = elementCtx_.begin();
         const auto& endIt = elementCtx_.end();
@@ -162,8 +172,19 @@ public:
     void eraseMatrix()
     {
         jacobian_.reset();
+        coloredElementSeeds_.clear();
+        colorOffsets_.clear();
     }
 
+    /*!
+     * \brief Returns the number of element colors used for the lock-free linearization.
+     *
+     * If the colored linearization is disabled, or if the Jacobian matrix has not yet
+     * been created, zero is returned.
+     */
+    size_t numColors() const
+    { return colorOffsets_.empty() ? 0 : colorOffsets_.size() - 1; }
+
     /*!
      * \brief Linearize the full system of non-linear equations.
      *
@@ -190,6 +211,21 @@ public:
      * represented by the model object.
      */
     void linearizeDomain()
+    {
+        CollectiveBatch collectives(simulator_().gridView().comm());
+        linearizeDomain(collectives);
+        collectives.sync();
+    }
+
+    /*!
+     * \brief Linearize the part of the non-linear system of equations that is associated
+     *        with the spatial domain without communicating the result.
+     *
+     * Instead of checking right away if all processes succeeded, the local status is
+     * added to a batch of collective operations. The caller is responsible for
+     * synchronizing this batch.
+     */
+    void linearizeDomain(CollectiveBatch& collectives)
     {
         // we defer the initialization of the Jacobian matrix until here because the
         // auxiliary modules usually assume the problem, model and grid to be fully
@@ -197,29 +233,27 @@ public:
         if (!jacobian_)
             initFirstIteration_();
 
-        int succeeded;
+        bool succeeded;
         try {
             linearize_();
-            succeeded = 1;
+            succeeded = true;
         }
         catch (const std::exception& e)
         {
             std::cout << "rank " << simulator_().gridView().comm().rank()
                       << " caught an exception while linearizing:" << e.what()
                       << "\n"  << std::flush;
-            succeeded = 0;
+            succeeded = false;
         }
         catch (...)
         {
             std::cout << "rank " << simulator_().gridView().comm().rank()
                       << " caught an exception while linearizing"
                       << "\n"  << std::flush;
-            succeeded = 0;
+            succeeded = false;
         }
-        succeeded = gridView_().comm().min(succeeded);
 
-        if (!succeeded)
-            throw Opm::NumericalIssue("A process did not succeed in linearizing the system");
+        collectives.addStatus(succeeded, "A process did not succeed in linearizing the system");
     }
 
     void finalize()
@@ -230,12 +264,24 @@ public:
      *        with the spatial domain.
      */
     void linearizeAuxiliaryEquations()
+    {
+        CollectiveBatch collectives(simulator_().gridView().comm());
+        linearizeAuxiliaryEquations(collectives);
+        collectives.sync();
+    }
+
+    /*!
+     * \brief Linearize the auxiliary equations without communicating the result.
+     *
+     * The status of each auxiliary module is added to a batch of collective
+     * operations. The caller is responsible for synchronizing this batch.
+     */
+    void linearizeAuxiliaryEquations(CollectiveBatch& collectives)
     {
         // flush possible local caches into matrix structure
         jacobian_->commit();
 
         auto& model = model_();
-        const auto& comm = simulator_().gridView().comm();
         for (unsigned auxModIdx = 0; auxModIdx < model.numAuxiliaryModules(); ++auxModIdx) {
             bool succeeded = true;
             try {
@@ -249,10 +295,7 @@ public:
                           << "\n"  << std::flush;
             }
 
-            succeeded = comm.min(succeeded);
-
-            if (!succeeded)
-                throw Opm::NumericalIssue("linearization of an auxilary equation failed");
+            collectives.addStatus(succeeded, "linearization of an auxilary equation failed");
         }
     }
 
@@ -290,6 +333,15 @@ public:
     const std::map<unsigned, Constraints>& constraintsMap() const
     { return constraintsMap_; }
 
+    /*!
+     * \brief Returns true if a degree of freedom is subject to a constraint.
+     *
+     * In contrast to looking up the DOF in the constraints map, this only requires a
+     * single array access.
+     */
+    bool isConstraintDof(unsigned globalDofIdx) const
+    { return globalDofIdx < isConstraintDof_.size() && isConstraintDof_[globalDofIdx]; }
+
 private:
     Simulator& simulator_()
     { return *simulatorPtr_; }
@@ -328,40 +380,153 @@ private:
         elementCtx_.resize(ThreadManager::maxThreads());
         for (unsigned threadId = 0; threadId != ThreadManager::maxThreads(); ++ threadId)
             elementCtx_[threadId] = new ElementContext(simulator_());
+
+        // partition the elements into colors if the lock-free linearization is used
+        if (enableColoredLinearization_)
+            createElementColoring_();
     }
 
-    // Construct the BCRS matrix for the Jacobian of the residual function
-    void createMatrix_()
+    // Partition the elements into colors so that no two elements of the same color
+    // write to the same entry of the global linear system.
+    //
+    // An element writes the residual of its primary degrees of freedom and all matrix
+    // blocks which are located in the columns of its primary DOFs and in the rows of the
+    // DOFs of its stencil. Two elements thus conflict if a primary DOF of one of them is
+    // part of the stencil of the other. For the element centered finite volume method
+    // this means that face-neighbors get different colors, for the vertex centered
+    // method all elements which share a vertex are colored differently.
+    void createElementColoring_()
     {
-        const auto& model = model_();
         Stencil stencil(gridView_(), model_().dofMapper());
 
-        // for the main model, find out the global indices of the neighboring degrees of
-        // freedom of each primary degree of freedom
-        using NeighborSet = std::set< unsigned >;
-        std::vector<NeighborSet> sparsityPattern(model.numTotalDof());
+        // collect the seeds, the primary and the stencil DOFs of all elements which need
+        // to be linearized
+        std::vector<ElementSeed> elemSeeds;
+        std::vector<unsigned> elemDofOffsets(1, 0);
+        std::vector<unsigned> elemNumPrimaryDof;
+        std::vector<unsigned> elemDofs;
 
         ElementIterator elemIt = gridView_().template begin<0>();
         const ElementIterator elemEndIt = gridView_().template end<0>();
         for (; elemIt != elemEndIt; ++elemIt) {
             const Element& elem = *elemIt;
+            if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
+                continue;
+
             stencil.update(elem);
+            elemSeeds.push_back(elem.seed());
+            elemNumPrimaryDof.push_back(static_cast<unsigned>(stencil.numPrimaryDof()));
+            for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx)
+                elemDofs.push_back(stencil.globalSpaceIndex(dofIdx));
+            elemDofOffsets.push_back(static_cast<unsigned>(elemDofs.size()));
+        }
+
+        // invert the relation: for each DOF, find the elements which use it as a primary
+        // DOF and the ones which feature it in their stencil
+        size_t numElems = elemSeeds.size();
+        size_t numDof = model_().numGridDof();
+        std::vector<std::vector<unsigned> > primaryDofElems(numDof);
+        std::vector<std::vector<unsigned> > stencilDofElems(numDof);
+        for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+            unsigned firstDof = elemDofOffsets[elemIdx];
+            for (unsigned i = firstDof; i < elemDofOffsets[elemIdx + 1]; ++i) {
+                if (i - firstDof < elemNumPrimaryDof[elemIdx])
+                    primaryDofElems[elemDofs[i]].push_back(elemIdx);
+                stencilDofElems[elemDofs[i]].push_back(elemIdx);
+            }
+        }
+
+        // greedily assign to each element the smallest color which is not used by any
+        // of the conflicting elements that have already been colored
+        static constexpr int noColor = -1;
+        std::vector<int> elemColor(numElems, noColor);
+        std::vector<unsigned> colorBlockedBy;
+        std::vector<unsigned> colorSize;
+        auto blockColorsOf = [&](const std::vector<unsigned>& conflictingElems, unsigned elemIdx) {
+            for (unsigned otherElemIdx : conflictingElems) {
+                int otherColor = elemColor[otherElemIdx];
+                if (otherColor != noColor)
+                    colorBlockedBy[static_cast<unsigned>(otherColor)] = elemIdx;
+            }
+        };
+        for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+            unsigned firstDof = elemDofOffsets[elemIdx];
+            for (unsigned i = firstDof; i < elemDofOffsets[elemIdx + 1]; ++i) {
+                unsigned globalDofIdx = elemDofs[i];
+                if (i - firstDof < elemNumPrimaryDof[elemIdx])
+                    blockColorsOf(stencilDofElems[globalDofIdx], elemIdx);
+                blockColorsOf(primaryDofElems[globalDofIdx], elemIdx);
+            }
+
+            unsigned color = 0;
+            while (color < colorBlockedBy.size() && colorBlockedBy[color] == elemIdx)
+                ++color;
+            if (color == colorBlockedBy.size()) {
+                // marking a new color as blocked by an element which does not exist
+                colorBlockedBy.push_back(static_cast<unsigned>(numElems));
+                colorSize.push_back(0);
+            }
+
+            elemColor[elemIdx] = static_cast<int>(color);
+            ++colorSize[color];
+        }
+
+        // sort the element seeds by color. within a color, the order of the grid is
+        // retained, so that the result is deterministic.
+        colorOffsets_.resize(colorSize.size() + 1);
+        colorOffsets_[0] = 0;
+        for (unsigned color = 0; color < colorSize.size(); ++color)
+            colorOffsets_[color + 1] = colorOffsets_[color] + colorSize[color];
+
+        std::vector<size_t> colorPos(colorOffsets_.begin(), colorOffsets_.end() - 1);
+        coloredElementSeeds_.resize(numElems);
+        for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+            unsigned color = static_cast<unsigned>(elemColor[elemIdx]);
+            coloredElementSeeds_[colorPos[color]++] = elemSeeds[elemIdx];
+        }
+    }
 
+    // Construct the BCRS matrix for the Jacobian of the residual function
+    void createMatrix_()
+    {
+        const auto& model = model_();
+
+        // for the main model, find out the global indices of the neighboring degrees of
+        // freedom of each primary degree of freedom. this is done in two threaded passes
+        // over the grid: the first one determines an upper bound for the number of
+        // neighbors of each degree of freedom, the second one specifies them.
+        Linear::SparsityPattern sparsityPattern;
+        sparsityPattern.beginCounting(model.numTotalDof());
+        forEachStencil_([&sparsityPattern](const Stencil& stencil) {
+            for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
+                unsigned myIdx = stencil.globalSpaceIndex(primaryDofIdx);
+                sparsityPattern.countEntries(myIdx, stencil.numDof());
+            }
+        });
+
+        sparsityPattern.beginFilling();
+        forEachStencil_([&sparsityPattern](const Stencil& stencil) {
             for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
                 unsigned myIdx = stencil.globalSpaceIndex(primaryDofIdx);
 
                 for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
                     unsigned neighborIdx = stencil.globalSpaceIndex(dofIdx);
-                    sparsityPattern[myIdx].insert(neighborIdx);
+                    sparsityPattern.addEntry(myIdx, neighborIdx);
                 }
             }
-        }
+        });
+        sparsityPattern.finalize();
 
         // add the additional neighbors and degrees of freedom caused by the auxiliary
         // equations
         size_t numAuxMod = model.numAuxiliaryModules();
-        for (unsigned auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx)
-            model.auxiliaryModule(auxModIdx)->addNeighbors(sparsityPattern);
+        if (numAuxMod > 0) {
+            using NeighborSet = std::set<unsigned>;
+            std::vector<NeighborSet> auxNeighbors(model.numTotalDof());
+            for (unsigned auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx)
+                model.auxiliaryModule(auxModIdx)->addNeighbors(auxNeighbors);
+            sparsityPattern.addNeighbors(auxNeighbors);
+        }
 
         // allocate raw matrix
         jacobian_.reset(new SparseMatrixAdapter(simulator_()));
@@ -370,6 +535,32 @@ private:
         jacobian_->reserve(sparsityPattern);
     }
 
+    // call a functor for the stencils of all elements of the grid using all threads. only
+    // the topology of the stencils is available to the functor.
+    template <class Functor>
+    void forEachStencil_(const Functor& functor)
+    {
+        const auto& elemRange = model_().elementRange();
+        ChunkScheduler scheduler(elemRange.size(),
+                                 ThreadManager::maxThreads(),
+                                 model_().elementChunkSize());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            unsigned threadId = ThreadManager::threadId();
+            Stencil stencil(gridView_(), model_().dofMapper());
+            size_t beginIdx, endIdx;
+            while (scheduler.nextChunk(threadId, beginIdx, endIdx)) {
+                for (size_t elemIdx = beginIdx; elemIdx < endIdx; ++elemIdx) {
+                    const Element elem = elemRange.element(elemIdx);
+                    stencil.updateTopology(elem);
+                    functor(static_cast<const Stencil&>(stencil));
+                }
+            }
+        }
+    }
+
     // reset the global linear system of equations.
     void resetSystem_()
     {
@@ -389,39 +580,51 @@ private:
         constraintsMap_.clear();
 
         // loop over all elements...
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_());
+        std::mutex constraintsMutex;
+        const auto& elemRange = model_().elementRange();
+        ChunkScheduler scheduler(elemRange.size(),
+                                 ThreadManager::maxThreads(),
+                                 model_().elementChunkSize());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
             unsigned threadId = ThreadManager::threadId();
-            ElementIterator elemIt = threadedElemIt.beginParallel();
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                // create an element context (the solution-based quantities are not
-                // available here!)
-                const Element& elem = *elemIt;
-                ElementContext& elemCtx = *elementCtx_[threadId];
-                elemCtx.updateStencil(elem);
-
-                // check if the problem wants to constrain any degree of the current
-                // element's freedom. if yes, add the constraint to the map.
-                for (unsigned primaryDofIdx = 0;
-                     primaryDofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0);
-                     ++ primaryDofIdx)
-                {
-                    Constraints constraints;
-                    elemCtx.problem().constraints(constraints,
-                                                  elemCtx,
-                                                  primaryDofIdx,
-                                                  /*timeIdx=*/0);
-                    if (constraints.isActive()) {
-                        unsigned globI = elemCtx.globalSpaceIndex(primaryDofIdx, /*timeIdx=*/0);
-                        constraintsMap_[globI] = constraints;
-                        continue;
+            size_t beginIdx, endIdx;
+            while (scheduler.nextChunk(threadId, beginIdx, endIdx)) {
+                for (size_t elemIdx = beginIdx; elemIdx < endIdx; ++elemIdx) {
+                    // create an element context (the solution-based quantities are not
+                    // available here!)
+                    const Element elem = elemRange.element(elemIdx);
+                    ElementContext& elemCtx = *elementCtx_[threadId];
+                    elemCtx.updateStencil(elem);
+
+                    // check if the problem wants to constrain any degree of the current
+                    // element's freedom. if yes, add the constraint to the map.
+                    for (unsigned primaryDofIdx = 0;
+                         primaryDofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0);
+                         ++ primaryDofIdx)
+                    {
+                        Constraints constraints;
+                        elemCtx.problem().constraints(constraints,
+                                                      elemCtx,
+                                                      primaryDofIdx,
+                                                      /*timeIdx=*/0);
+                        if (constraints.isActive()) {
+                            unsigned globI = elemCtx.globalSpaceIndex(primaryDofIdx, /*timeIdx=*/0);
+                            std::lock_guard<std::mutex> guard(constraintsMutex);
+                            constraintsMap_[globI] = constraints;
+                        }
                     }
                 }
             }
         }
+
+        // flag the constraint DOFs in a dense array, so that they can be identified
+        // cheaply by the Newton method
+        isConstraintDof_.assign(model_().numTotalDof(), 0);
+        for (const auto& dofConstraints : constraintsMap_)
+            isConstraintDof_[dofConstraints.first] = 1;
     }
 
     // linearize the whole system
@@ -437,6 +640,10 @@ private:
 
         applyConstraintsToSolution_();
 
+        // the code below is executed for each element, so run-time parameters should have
+        // been retrieved beforehand. (this is only checked if debugging code is enabled.)
+        Parameters::ForbidParameterRetrieval forbidParamRetrieval;
+
         // to avoid a race condition if two threads handle an exception at the same time,
         // we use an explicit lock to control access to the exception storage object
         // amongst thread-local handlers
@@ -446,34 +653,47 @@ private:
         // parallel block below. initialized to null to indicate no exception
         std::exception_ptr exceptionPtr = nullptr;
 
+        if (enableColoredLinearization_) {
+            linearizeColored_();
+            applyConstraintsToLinearization_();
+            return;
+        }
+
         // relinearize the elements...
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_());
+        const auto& elemRange = model_().elementRange();
+        ChunkScheduler scheduler(elemRange.size(),
+                                 ThreadManager::maxThreads(),
+                                 model_().elementChunkSize());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
-            ElementIterator elemIt = threadedElemIt.beginParallel();
-            ElementIterator nextElemIt = elemIt;
+            unsigned threadId = ThreadManager::threadId();
+            size_t beginIdx, endIdx;
             try {
-                for (; !threadedElemIt.isFinished(elemIt); elemIt = nextElemIt) {
-                    // give the model and the problem a chance to prefetch the data required
-                    // to linearize the next element, but only if we need to consider it
-                    nextElemIt = threadedElemIt.increment();
-                    if (!threadedElemIt.isFinished(nextElemIt)) {
-                        const auto& nextElem = *nextElemIt;
-                        if (linearizeNonLocalElements
-                            || nextElem.partitionType() == Dune::InteriorEntity)
-                        {
-                            model_().prefetch(nextElem);
-                            problem_().prefetch(nextElem);
+                while (scheduler.nextChunk(threadId, beginIdx, endIdx)) {
+                    Element nextElem = elemRange.element(beginIdx);
+                    for (size_t elemIdx = beginIdx; elemIdx < endIdx; ++elemIdx) {
+                        const Element elem = nextElem;
+
+                        // give the model and the problem a chance to prefetch the data
+                        // required to linearize the next element, but only if we need to
+                        // consider it
+                        if (elemIdx + 1 < endIdx) {
+                            nextElem = elemRange.element(elemIdx + 1);
+                            if (linearizeNonLocalElements
+                                || nextElem.partitionType() == Dune::InteriorEntity)
+                            {
+                                model_().prefetch(nextElem);
+                                problem_().prefetch(nextElem);
+                            }
                         }
-                    }
 
-                    const Element& elem = *elemIt;
-                    if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
-                        continue;
+                        if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
+                            continue;
 
-                    linearizeElement_(elem);
+                        linearizeElement_(elem, useLinearizationLock_());
+                    }
                 }
             }
             // If an exception occurs in the parallel block, it won't escape the
@@ -488,7 +708,7 @@ private:
             catch(...) {
                 std::lock_guard<std::mutex> take(exceptionLock);
                 exceptionPtr = std::current_exception();
-                threadedElemIt.setFinished();
+                scheduler.setFinished();
             }
         }  // parallel block
 
@@ -502,8 +722,53 @@ private:
         applyConstraintsToLinearization_();
     }
 
+    // linearize all elements color by color. since the elements of a given color do not
+    // share any entries of the linear system, no locking is required within a color.
+    void linearizeColored_()
+    {
+        const auto& grid = gridView_().grid();
+
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+        std::atomic<bool> failed(false);
+
+        for (unsigned color = 0; color < numColors() && !failed; ++color) {
+            const size_t beginIdx = colorOffsets_[color];
+            const int numColorElems = static_cast<int>(colorOffsets_[color + 1] - beginIdx);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int i = 0; i < numColorElems; ++i) {
+                if (failed)
+                    continue;
+
+                try {
+                    // give the model and the problem a chance to prefetch the data
+                    // required to linearize the next element of the current color
+                    if (i + 1 < numColorElems) {
+                        const auto nextElem = grid.entity(coloredElementSeeds_[beginIdx + i + 1]);
+                        model_().prefetch(nextElem);
+                        problem_().prefetch(nextElem);
+                    }
+
+                    const auto elem = grid.entity(coloredElementSeeds_[beginIdx + i]);
+                    linearizeElement_(elem, /*useLock=*/false);
+                }
+                // exceptions must not escape the parallel loop. (see linearize_())
+                catch(...) {
+                    std::lock_guard<std::mutex> take(exceptionLock);
+                    exceptionPtr = std::current_exception();
+                    failed = true;
+                }
+            }
+        }
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+    }
+
     // linearize an element in the interior of the process' grid partition
-    void linearizeElement_(const Element& elem)
+    void linearizeElement_(const Element& elem, bool useLock)
     {
         unsigned threadId = ThreadManager::threadId();
 
@@ -514,7 +779,7 @@ private:
         localLinearizer.linearize(*elementCtx, elem);
 
         // update the right hand side and the Jacobian matrix
-        if (getPropValue<TypeTag, Properties::UseLinearizationLock>())
+        if (useLock)
             globalMatrixMutex_.lock();
 
         size_t numPrimaryDof = elementCtx->numPrimaryDof(/*timeIdx=*/0);
@@ -532,7 +797,7 @@ private:
             }
         }
 
-        if (getPropValue<TypeTag, Properties::UseLinearizationLock>())
+        if (useLock)
             globalMatrixMutex_.unlock();
     }
 
@@ -579,12 +844,16 @@ private:
     static bool enableConstraints_()
     { return getPropValue<TypeTag, Properties::EnableConstraints>(); }
 
+    static bool useLinearizationLock_()
+    { return getPropValue<TypeTag, Properties::UseLinearizationLock>(); }
+
     Simulator *simulatorPtr_;
     std::vector<ElementContext*> elementCtx_;
 
     // The constraint equations (only non-empty if the
     // EnableConstraints property is true)
     std::map<unsigned, Constraints> constraintsMap_;
+    std::vector<unsigned char> isConstraintDof_;
 
     // the jacobian matrix
     std::unique_ptr<SparseMatrixAdapter> jacobian_;
@@ -595,6 +864,12 @@ private:
     LinearizationType linearizationType_;
 
     std::mutex globalMatrixMutex_;
+
+    // the seeds of the elements sorted by color and the index of the first element of
+    // each color (only used if the colored linearization is enabled)
+    bool enableColoredLinearization_;
+    std::vector<ElementSeed> coloredElementSeeds_;
+    std::vector<size_t> colorOffsets_;
 };
 
 } // namespace Opm
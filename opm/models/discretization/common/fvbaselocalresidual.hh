@@ -172,23 +172,8 @@ public:
         // evaluate the boundary conditions
         asImp_().evalBoundary_(residual, elemCtx, /*timeIdx=*/0);
 
-        if (useVolumetricResidual) {
-            // make the residual volume specific (i.e., make it incorrect mass per cubic
-            // meter instead of total mass)
-            size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
-            for (unsigned dofIdx=0; dofIdx < numDof; ++dofIdx) {
-                if (elemCtx.dofTotalVolume(dofIdx, /*timeIdx=*/0) > 0.0) {
-                    // interior DOF
-                    Scalar dofVolume = elemCtx.dofTotalVolume(dofIdx, /*timeIdx=*/0);
-
-                    assert(std::isfinite(dofVolume));
-                    Opm::Valgrind::CheckDefined(dofVolume);
-
-                    for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
-                        residual[dofIdx][eqIdx] /= dofVolume;
-                }
-            }
-        }
+        if (useVolumetricResidual)
+            makeVolumeSpecific_(residual, elemCtx);
     }
 
     /*!
@@ -225,7 +210,7 @@ public:
                 // center of attention, we need to consider the derivatives for the
                 // storage term, else the storage term is constant w.r.t. the primary
                 // variables of the focused DOF.
-                if (dofIdx == elemCtx.focusDofIndex()) {
+                if (elemCtx.isFocusDof(dofIdx)) {
                     asImp_().computeStorage(storage[dofIdx],
                                             elemCtx,
                                             dofIdx,
@@ -301,52 +286,10 @@ public:
                     const ElementContext& elemCtx,
                     unsigned timeIdx) const
     {
-        RateVector flux;
-
-        const auto& stencil = elemCtx.stencil(timeIdx);
         // calculate the mass flux over the sub-control volume faces
         size_t numInteriorFaces = elemCtx.numInteriorFaces(timeIdx);
-        for (unsigned scvfIdx = 0; scvfIdx < numInteriorFaces; scvfIdx++) {
-            const auto& face = stencil.interiorFace(scvfIdx);
-            unsigned i = face.interiorIndex();
-            unsigned j = face.exteriorIndex();
-
-            Opm::Valgrind::SetUndefined(flux);
-            asImp_().computeFlux(flux, /*context=*/elemCtx, scvfIdx, timeIdx);
-            Opm::Valgrind::CheckDefined(flux);
-#ifndef NDEBUG
-            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
-                assert(Opm::isfinite(flux[eqIdx]));
-#endif
-
-            Scalar alpha = elemCtx.extensiveQuantities(scvfIdx, timeIdx).extrusionFactor();
-            alpha *= face.area();
-            Opm::Valgrind::CheckDefined(alpha);
-            assert(alpha > 0.0);
-            assert(Opm::isfinite(alpha));
-
-            for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
-                flux[eqIdx] *= alpha;
-
-            // The balance equation for a finite volume is given by
-            //
-            // dStorage/dt + Flux = Source
-            //
-            // where the 'Flux' and the 'Source' terms represent the
-            // mass per second which leaves the finite
-            // volume. Re-arranging this, we get
-            //
-            // dStorage/dt + Flux - Source = 0
-            //
-            // Since the mass flux as calculated by computeFlux() goes out of sub-control
-            // volume i and into sub-control volume j, we need to add the flux to finite
-            // volume i and subtract it from finite volume j
-            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
-                assert(Opm::isfinite(flux[eqIdx]));
-                residual[i][eqIdx] += flux[eqIdx];
-                residual[j][eqIdx] -= flux[eqIdx];
-            }
-        }
+        for (unsigned scvfIdx = 0; scvfIdx < numInteriorFaces; scvfIdx++)
+            asImp_().evalFlux_(residual, elemCtx, scvfIdx, timeIdx);
 
 #if !defined NDEBUG
         // in debug mode, ensure that the residual is well-defined
@@ -414,6 +357,81 @@ public:
     }
 
 protected:
+    /*!
+     * \brief Add the flux over a single sub-control volume face to the local residual.
+     */
+    void evalFlux_(LocalEvalBlockVector& residual,
+                   const ElementContext& elemCtx,
+                   unsigned scvfIdx,
+                   unsigned timeIdx) const
+    {
+        RateVector flux;
+
+        const auto& face = elemCtx.stencil(timeIdx).interiorFace(scvfIdx);
+        unsigned i = face.interiorIndex();
+        unsigned j = face.exteriorIndex();
+
+        Opm::Valgrind::SetUndefined(flux);
+        asImp_().computeFlux(flux, /*context=*/elemCtx, scvfIdx, timeIdx);
+        Opm::Valgrind::CheckDefined(flux);
+#ifndef NDEBUG
+        for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+            assert(Opm::isfinite(flux[eqIdx]));
+#endif
+
+        Scalar alpha = elemCtx.extensiveQuantities(scvfIdx, timeIdx).extrusionFactor();
+        alpha *= face.area();
+        Opm::Valgrind::CheckDefined(alpha);
+        assert(alpha > 0.0);
+        assert(Opm::isfinite(alpha));
+
+        for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+            flux[eqIdx] *= alpha;
+
+        // The balance equation for a finite volume is given by
+        //
+        // dStorage/dt + Flux = Source
+        //
+        // where the 'Flux' and the 'Source' terms represent the
+        // mass per second which leaves the finite
+        // volume. Re-arranging this, we get
+        //
+        // dStorage/dt + Flux - Source = 0
+        //
+        // Since the mass flux as calculated by computeFlux() goes out of sub-control
+        // volume i and into sub-control volume j, we need to add the flux to finite
+        // volume i and subtract it from finite volume j
+        for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+            assert(Opm::isfinite(flux[eqIdx]));
+            residual[i][eqIdx] += flux[eqIdx];
+            residual[j][eqIdx] -= flux[eqIdx];
+        }
+    }
+
+    /*!
+     * \brief Divide the residual of all interior degrees of freedom by their volume.
+     *
+     * I.e., make the residual volume specific (incorrect mass per cubic meter instead
+     * of total mass).
+     */
+    void makeVolumeSpecific_(LocalEvalBlockVector& residual,
+                             const ElementContext& elemCtx) const
+    {
+        size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
+        for (unsigned dofIdx=0; dofIdx < numDof; ++dofIdx) {
+            if (elemCtx.dofTotalVolume(dofIdx, /*timeIdx=*/0) > 0.0) {
+                // interior DOF
+                Scalar dofVolume = elemCtx.dofTotalVolume(dofIdx, /*timeIdx=*/0);
+
+                assert(std::isfinite(dofVolume));
+                Opm::Valgrind::CheckDefined(dofVolume);
+
+                for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+                    residual[dofIdx][eqIdx] /= dofVolume;
+            }
+        }
+    }
+
     /*!
      * \brief Evaluate the boundary conditions of an element.
      */
@@ -491,6 +509,31 @@ protected:
      */
     void evalVolumeTerms_(LocalEvalBlockVector& residual,
                           ElementContext& elemCtx) const
+    {
+        // evaluate the volumetric terms (storage + source terms)
+        size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+        for (unsigned dofIdx=0; dofIdx < numPrimaryDof; dofIdx++)
+            asImp_().evalVolumeTerm_(residual, elemCtx, dofIdx);
+
+#if !defined NDEBUG
+        // in debug mode, ensure that the residual is well-defined
+        size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
+        for (unsigned i=0; i < numDof; i++) {
+            for (unsigned j = 0; j < numEq; ++ j) {
+                assert(Opm::isfinite(residual[i][j]));
+                Opm::Valgrind::CheckDefined(residual[i][j]);
+            }
+        }
+#endif
+    }
+
+    /*!
+     * \brief Add the change in the storage term and the source term of a single
+     *        primary sub-control volume to the local residual.
+     */
+    void evalVolumeTerm_(LocalEvalBlockVector& residual,
+                         ElementContext& elemCtx,
+                         unsigned dofIdx) const
     {
         EvalVector tmp;
         EqVector tmp2;
@@ -499,131 +542,116 @@ protected:
         tmp = 0.0;
         tmp2 = 0.0;
 
-        // evaluate the volumetric terms (storage + source terms)
-        size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
-        for (unsigned dofIdx=0; dofIdx < numPrimaryDof; dofIdx++) {
-            Scalar extrusionFactor =
-                elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0).extrusionFactor();
-            Opm::Valgrind::CheckDefined(extrusionFactor);
-            assert(Opm::isfinite(extrusionFactor));
-            assert(extrusionFactor > 0.0);
-            Scalar scvVolume =
-               elemCtx.stencil(/*timeIdx=*/0).subControlVolume(dofIdx).volume() * extrusionFactor;
-            Opm::Valgrind::CheckDefined(scvVolume);
-            assert(Opm::isfinite(scvVolume));
-            assert(scvVolume > 0.0);
-
-            // if the model uses extensive quantities in its storage term, and we use
-            // automatic differention and current DOF is also not the one we currently
-            // focus on, the storage term does not need any derivatives!
-            if (!extensiveStorageTerm &&
-                !std::is_same<Scalar, Evaluation>::value &&
-                dofIdx != elemCtx.focusDofIndex())
-            {
-                asImp_().computeStorage(tmp2, elemCtx, dofIdx, /*timeIdx=*/0);
-                for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
-                    tmp[eqIdx] = tmp2[eqIdx];
-            }
-            else
-                asImp_().computeStorage(tmp, elemCtx, dofIdx, /*timeIdx=*/0);
+        Scalar extrusionFactor =
+            elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0).extrusionFactor();
+        Opm::Valgrind::CheckDefined(extrusionFactor);
+        assert(Opm::isfinite(extrusionFactor));
+        assert(extrusionFactor > 0.0);
+        Scalar scvVolume =
+           elemCtx.stencil(/*timeIdx=*/0).subControlVolume(dofIdx).volume() * extrusionFactor;
+        Opm::Valgrind::CheckDefined(scvVolume);
+        assert(Opm::isfinite(scvVolume));
+        assert(scvVolume > 0.0);
+
+        // if the model uses extensive quantities in its storage term, and we use
+        // automatic differention and current DOF is also not the one we currently
+        // focus on, the storage term does not need any derivatives!
+        if (!extensiveStorageTerm &&
+            !std::is_same<Scalar, Evaluation>::value &&
+            !elemCtx.isFocusDof(dofIdx))
+        {
+            asImp_().computeStorage(tmp2, elemCtx, dofIdx, /*timeIdx=*/0);
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                tmp[eqIdx] = tmp2[eqIdx];
+        }
+        else
+            asImp_().computeStorage(tmp, elemCtx, dofIdx, /*timeIdx=*/0);
 
 #ifndef NDEBUG
-            Opm::Valgrind::CheckDefined(tmp);
-            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
-                assert(Opm::isfinite(tmp[eqIdx]));
+        Opm::Valgrind::CheckDefined(tmp);
+        for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+            assert(Opm::isfinite(tmp[eqIdx]));
 #endif
 
-            if (elemCtx.enableStorageCache()) {
-                const auto& model = elemCtx.model();
-                unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-                if (model.newtonMethod().numIterations() == 0 &&
-                    !elemCtx.haveStashedIntensiveQuantities())
-                {
-                    if (!elemCtx.problem().recycleFirstIterationStorage()) {
-                        // we re-calculate the storage term for the solution of the
-                        // previous time step from scratch instead of using the one of
-                        // the first iteration of the current time step.
-                        tmp2 = 0.0;
-                        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/1);
-                        asImp_().computeStorage(tmp2, elemCtx,  dofIdx, /*timeIdx=*/1);
-                    }
-                    else {
-                        // if the storage term is cached and we're in the first iteration
-                        // of the time step, use the storage term of the first iteration
-                        // as the one as the solution of the last time step (this assumes
-                        // that the initial guess for the solution at the end of the time
-                        // step is the same as the solution at the beginning of the time
-                        // step. This is usually true, but some fancy preprocessing
-                        // scheme might invalidate that assumption.)
-                        for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
-                            tmp2[eqIdx] = Toolbox::value(tmp[eqIdx]);
-                    }
-
-                    Opm::Valgrind::CheckDefined(tmp2);
-
-                    model.updateCachedStorage(globalDofIdx, /*timeIdx=*/1, tmp2);
+        if (elemCtx.enableStorageCache()) {
+            const auto& model = elemCtx.model();
+            unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+            if (model.newtonMethod().numIterations() == 0 &&
+                !elemCtx.haveStashedIntensiveQuantities())
+            {
+                if (!elemCtx.problem().recycleFirstIterationStorage()) {
+                    // we re-calculate the storage term for the solution of the
+                    // previous time step from scratch instead of using the one of
+                    // the first iteration of the current time step.
+                    tmp2 = 0.0;
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/1);
+                    asImp_().computeStorage(tmp2, elemCtx,  dofIdx, /*timeIdx=*/1);
                 }
                 else {
-                    // if the mass storage at the beginning of the time step is not cached,
-                    // if the storage term is cached and we're not looking at the first
-                    // iteration of the time step, we take the cached data.
-                    tmp2 = model.cachedStorage(globalDofIdx, /*timeIdx=*/1);
-                    Opm::Valgrind::CheckDefined(tmp2);
+                    // if the storage term is cached and we're in the first iteration
+                    // of the time step, use the storage term of the first iteration
+                    // as the one as the solution of the last time step (this assumes
+                    // that the initial guess for the solution at the end of the time
+                    // step is the same as the solution at the beginning of the time
+                    // step. This is usually true, but some fancy preprocessing
+                    // scheme might invalidate that assumption.)
+                    for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+                        tmp2[eqIdx] = Toolbox::value(tmp[eqIdx]);
                 }
+
+                Opm::Valgrind::CheckDefined(tmp2);
+
+                model.updateCachedStorage(globalDofIdx, /*timeIdx=*/1, tmp2);
             }
             else {
                 // if the mass storage at the beginning of the time step is not cached,
-                // we re-calculate it from scratch.
-                tmp2 = 0.0;
-                asImp_().computeStorage(tmp2, elemCtx,  dofIdx, /*timeIdx=*/1);
+                // if the storage term is cached and we're not looking at the first
+                // iteration of the time step, we take the cached data.
+                tmp2 = model.cachedStorage(globalDofIdx, /*timeIdx=*/1);
                 Opm::Valgrind::CheckDefined(tmp2);
             }
+        }
+        else {
+            // if the mass storage at the beginning of the time step is not cached,
+            // we re-calculate it from scratch.
+            tmp2 = 0.0;
+            asImp_().computeStorage(tmp2, elemCtx,  dofIdx, /*timeIdx=*/1);
+            Opm::Valgrind::CheckDefined(tmp2);
+        }
 
-            // Use the implicit Euler time discretization
-            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
-                double dt = elemCtx.simulator().timeStepSize();
-                assert(dt > 0);
-                tmp[eqIdx] -= tmp2[eqIdx];
-                tmp[eqIdx] *= scvVolume / dt;
-
-                residual[dofIdx][eqIdx] += tmp[eqIdx];
-            }
+        // Use the implicit Euler time discretization
+        for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+            double dt = elemCtx.simulator().timeStepSize();
+            assert(dt > 0);
+            tmp[eqIdx] -= tmp2[eqIdx];
+            tmp[eqIdx] *= scvVolume / dt;
 
-            Opm::Valgrind::CheckDefined(residual[dofIdx]);
+            residual[dofIdx][eqIdx] += tmp[eqIdx];
+        }
 
-            // deal with the source term
-            asImp_().computeSource(sourceRate, elemCtx, dofIdx, /*timeIdx=*/0);
+        Opm::Valgrind::CheckDefined(residual[dofIdx]);
 
-            // if the model uses extensive quantities in its storage term, and we use
-            // automatic differention and current DOF is also not the one we currently
-            // focus on, the storage term does not need any derivatives!
-            if (!extensiveStorageTerm &&
-                !std::is_same<Scalar, Evaluation>::value &&
-                dofIdx != elemCtx.focusDofIndex())
-            {
-                for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
-                    residual[dofIdx][eqIdx] -= Opm::scalarValue(sourceRate[eqIdx])*scvVolume;
-            }
-            else {
-                for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
-                    sourceRate[eqIdx] *= scvVolume;
-                    residual[dofIdx][eqIdx] -= sourceRate[eqIdx];
-                }
-            }
+        // deal with the source term
+        asImp_().computeSource(sourceRate, elemCtx, dofIdx, /*timeIdx=*/0);
 
-            Opm::Valgrind::CheckDefined(residual[dofIdx]);
+        // if the model uses extensive quantities in its storage term, and we use
+        // automatic differention and current DOF is also not the one we currently
+        // focus on, the storage term does not need any derivatives!
+        if (!extensiveStorageTerm &&
+            !std::is_same<Scalar, Evaluation>::value &&
+            !elemCtx.isFocusDof(dofIdx))
+        {
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                residual[dofIdx][eqIdx] -= Opm::scalarValue(sourceRate[eqIdx])*scvVolume;
         }
-
-#if !defined NDEBUG
-        // in debug mode, ensure that the residual is well-defined
-        size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
-        for (unsigned i=0; i < numDof; i++) {
-            for (unsigned j = 0; j < numEq; ++ j) {
-                assert(Opm::isfinite(residual[i][j]));
-                Opm::Valgrind::CheckDefined(residual[i][j]);
+        else {
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                sourceRate[eqIdx] *= scvVolume;
+                residual[dofIdx][eqIdx] -= sourceRate[eqIdx];
             }
         }
-#endif
+
+        Opm::Valgrind::CheckDefined(residual[dofIdx]);
     }
 
 
@@ -153,9 +153,11 @@ public:
                                          "at the same time as grid adaptivity");
 
             std::string outputDir = asImp_().outputDir();
+            bool nativeVtkOutput = EWOMS_GET_PARAM(TypeTag, bool, EnableNativeVtkOutput);
 
             defaultVtkWriter_ =
-                new VtkMultiWriter(asyncVtkOutput, gridView_, outputDir, asImp_().name());
+                new VtkMultiWriter(asyncVtkOutput, gridView_, outputDir, asImp_().name(),
+                                   /*multiFileName=*/"", nativeVtkOutput);
         }
     }
 
@@ -178,6 +180,9 @@ public:
                              "before the simulation bails out");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncVtkOutput,
                              "Dispatch a separate thread to write the VTK output");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableNativeVtkOutput,
+                             "Write the VTK output directly from the output buffers instead "
+                             "of using Dune's VTK writer (sequential runs only)");
         EWOMS_REGISTER_PARAM(TypeTag, bool, ContinueOnConvergenceError,
                              "Continue with a non-converged solution instead of giving up "
                              "if we encounter a time step size smaller than the minimum time "
@@ -189,6 +189,11 @@ struct ThreadManager { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct ThreadsPerProcess { using type = UndefinedProperty; };
 
+//! The number of consecutive elements which a thread processes before it asks for more
+//! work in multi-threaded loops over the grid
+template<class TypeTag, class MyTypeTag>
+struct ElementChunkSize { using type = UndefinedProperty; };
+
 //! use locking to prevent race conditions when linearizing the global system of
 //! equations in multi-threaded mode. (setting this property to true is always save, but
 //! it may slightly deter performance in multi-threaded simlations and some
@@ -196,6 +201,17 @@ struct ThreadsPerProcess { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct UseLinearizationLock { using type = UndefinedProperty; };
 
+/*!
+ * \brief Specify whether the global Jacobian is assembled using a coloring of the grid
+ *        elements.
+ *
+ * If this is enabled, the elements are partitioned into colors such that no two elements
+ * of the same color write to the same entry of the global linear system. The colors are
+ * then linearized one after another without any locking.
+ */
+template<class TypeTag, class MyTypeTag>
+struct EnableColoredLinearization { using type = UndefinedProperty; };
+
 // high-level simulation control
 
 /*!
@@ -234,6 +250,16 @@ struct EnableVtkOutput { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct EnableAsyncVtkOutput { using type = UndefinedProperty; };
 
+/*!
+ * \brief Specify whether the VTK output should be written by Opm::VtkNativeWriter.
+ *
+ * This writer streams the output buffers directly to disk using the "appended raw"
+ * format. If it is used, the VtkOutputFormat property is ignored. It is only used for
+ * sequential simulations.
+ */
+template<class TypeTag, class MyTypeTag>
+struct EnableNativeVtkOutput { using type = UndefinedProperty; };
+
 /*!
  * \brief Specify the format the VTK output is written to disk
  *
@@ -302,6 +328,18 @@ struct EnableIntensiveQuantityCache { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct EnableStorageCache { using type = UndefinedProperty; };
 
+/*!
+ * \brief Specify whether the finite volume geometry of all elements should be kept in
+ *        memory.
+ *
+ * This avoids evaluating the geometries of the grid every time an element is visited,
+ * but comes at the cost of higher memory consumption: For three-dimensional grids, about
+ * 32 bytes per sub-control volume and 60 to 84 bytes per face of each element are
+ * required (see FvBaseStencilGeometryCache).
+ */
+template<class TypeTag, class MyTypeTag>
+struct EnableStencilCache { using type = UndefinedProperty; };
+
 /*!
  * \brief Specify whether to use the already calculated solutions as
  *        starting values of the intensive quantities.
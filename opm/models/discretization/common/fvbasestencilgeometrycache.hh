@@ -0,0 +1,311 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::FvBaseStencilGeometryCache
+ */
+#ifndef EWOMS_FV_BASE_STENCIL_GEOMETRY_CACHE_HH
+#define EWOMS_FV_BASE_STENCIL_GEOMETRY_CACHE_HH
+
+#include <dune/common/fvector.hh>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief Stores the finite volume geometry of all elements of a grid view in flat
+ *        arrays.
+ *
+ * The data is kept in structure-of-arrays form: The sub-control volumes of all elements
+ * are stored consecutively in the arrays for the volumes and the positions of the
+ * degrees of freedom, and the faces are stored consecutively in the arrays for the
+ * interior and exterior indices, the areas, the normals and the integration points. For
+ * each element, the interior faces come first and are followed by the boundary
+ * faces. The local positions of the integration points are only stored for stencils
+ * which require them.
+ *
+ * The stencils are not stored themselves. Instead, they provide a storeGeometry()
+ * method to add the data of an element and an update() overload which restores their
+ * geometric part from this object without querying the Dune geometries.
+ *
+ * The memory required is 14 bytes per element plus 'sizeof(Scalar) +
+ * dimWorld*sizeof(CoordScalar)' per sub-control volume and '2*sizeof(unsigned short) +
+ * sizeof(Scalar) + dimWorld*(sizeof(Scalar) + sizeof(CoordScalar))' per face, i.e., 32
+ * and 60 bytes for three-dimensional grids and double precision. If the local positions
+ * of the integration points are stored, this increases by 'dim*sizeof(CoordScalar)'
+ * per face. The actual number of bytes allocated is returned by memoryUsage().
+ */
+template <class Scalar, class GridView>
+class FvBaseStencilGeometryCache
+{
+    enum { dim = GridView::dimension };
+    enum { dimWorld = GridView::dimensionworld };
+
+    using CoordScalar = typename GridView::ctype;
+
+public:
+    using GlobalPosition = Dune::FieldVector<CoordScalar, dimWorld>;
+    using LocalPosition = Dune::FieldVector<CoordScalar, dim>;
+    using WorldVector = Dune::FieldVector<Scalar, dimWorld>;
+
+    /*!
+     * \brief Remove all data and allocate the per-element arrays.
+     *
+     * \param numElements The number of elements of the grid view.
+     */
+    void reset(std::size_t numElements)
+    {
+        std::vector<unsigned>(numElements, 0).swap(dofBegin_);
+        std::vector<unsigned>(numElements, 0).swap(faceBegin_);
+        std::vector<unsigned short>(numElements, 0).swap(numDof_);
+        std::vector<unsigned short>(numElements, 0).swap(numInteriorFaces_);
+        std::vector<unsigned short>(numElements, 0).swap(numBoundaryFaces_);
+
+        std::vector<Scalar>().swap(dofVolume_);
+        std::vector<GlobalPosition>().swap(dofPos_);
+
+        std::vector<unsigned short>().swap(faceInteriorIdx_);
+        std::vector<unsigned short>().swap(faceExteriorIdx_);
+        std::vector<Scalar>().swap(faceArea_);
+        std::vector<WorldVector>().swap(faceNormal_);
+        std::vector<GlobalPosition>().swap(faceIntegrationPos_);
+        std::vector<LocalPosition>().swap(faceLocalPos_);
+
+        curElemIdx_ = 0;
+    }
+
+    /*!
+     * \brief Release the excess capacity of the arrays after all elements were added.
+     */
+    void shrinkToFit()
+    {
+        dofVolume_.shrink_to_fit();
+        dofPos_.shrink_to_fit();
+
+        faceInteriorIdx_.shrink_to_fit();
+        faceExteriorIdx_.shrink_to_fit();
+        faceArea_.shrink_to_fit();
+        faceNormal_.shrink_to_fit();
+        faceIntegrationPos_.shrink_to_fit();
+        faceLocalPos_.shrink_to_fit();
+    }
+
+    /*!
+     * \brief Start adding the data of an element.
+     *
+     * The elements can be added in any order, but the sub-control volumes and faces of
+     * an element must be added before the next element is started.
+     *
+     * \param elemIdx The index of the element given by the element mapper.
+     */
+    void beginElement(unsigned elemIdx)
+    {
+        curElemIdx_ = elemIdx;
+        dofBegin_[elemIdx] = static_cast<unsigned>(dofVolume_.size());
+        faceBegin_[elemIdx] = static_cast<unsigned>(faceArea_.size());
+    }
+
+    /*!
+     * \brief Add a sub-control volume to the current element.
+     */
+    void addDof(Scalar volume, const GlobalPosition& pos)
+    {
+        dofVolume_.push_back(volume);
+        dofPos_.push_back(pos);
+        ++numDof_[curElemIdx_];
+    }
+
+    /*!
+     * \brief Add an interior face to the current element.
+     *
+     * All interior faces of an element must be added before its boundary faces.
+     */
+    void addInteriorFace(unsigned short interiorIdx,
+                         unsigned short exteriorIdx,
+                         Scalar area,
+                         const WorldVector& normal,
+                         const GlobalPosition& integrationPos)
+    {
+        assert(numBoundaryFaces_[curElemIdx_] == 0);
+
+        addFace_(interiorIdx, exteriorIdx, area, normal, integrationPos);
+        ++numInteriorFaces_[curElemIdx_];
+    }
+
+    /*!
+     * \brief Add a boundary face to the current element.
+     */
+    void addBoundaryFace(unsigned short interiorIdx,
+                         unsigned short exteriorIdx,
+                         Scalar area,
+                         const WorldVector& normal,
+                         const GlobalPosition& integrationPos)
+    {
+        addFace_(interiorIdx, exteriorIdx, area, normal, integrationPos);
+        ++numBoundaryFaces_[curElemIdx_];
+    }
+
+    /*!
+     * \brief Set the local position of the integration point of the face which was
+     *        added last.
+     *
+     * This must be called for either all faces or for none.
+     */
+    void addFaceLocalPos(const LocalPosition& localPos)
+    {
+        faceLocalPos_.push_back(localPos);
+        assert(faceLocalPos_.size() == faceArea_.size());
+    }
+
+    /*!
+     * \brief Returns the number of sub-control volumes of an element.
+     */
+    unsigned numDof(unsigned elemIdx) const
+    { return numDof_[elemIdx]; }
+
+    /*!
+     * \brief Returns the number of interior faces of an element.
+     */
+    unsigned numInteriorFaces(unsigned elemIdx) const
+    { return numInteriorFaces_[elemIdx]; }
+
+    /*!
+     * \brief Returns the number of boundary faces of an element.
+     */
+    unsigned numBoundaryFaces(unsigned elemIdx) const
+    { return numBoundaryFaces_[elemIdx]; }
+
+    /*!
+     * \brief Returns the index of the first sub-control volume of an element in the
+     *        flat arrays.
+     */
+    unsigned dofBegin(unsigned elemIdx) const
+    { return dofBegin_[elemIdx]; }
+
+    /*!
+     * \brief Returns the index of the first interior face of an element in the flat
+     *        arrays.
+     */
+    unsigned interiorFaceBegin(unsigned elemIdx) const
+    { return faceBegin_[elemIdx]; }
+
+    /*!
+     * \brief Returns the index of the first boundary face of an element in the flat
+     *        arrays.
+     */
+    unsigned boundaryFaceBegin(unsigned elemIdx) const
+    { return faceBegin_[elemIdx] + numInteriorFaces_[elemIdx]; }
+
+    Scalar dofVolume(unsigned idx) const
+    { return dofVolume_[idx]; }
+
+    const GlobalPosition& dofPos(unsigned idx) const
+    { return dofPos_[idx]; }
+
+    unsigned short faceInteriorIndex(unsigned idx) const
+    { return faceInteriorIdx_[idx]; }
+
+    unsigned short faceExteriorIndex(unsigned idx) const
+    { return faceExteriorIdx_[idx]; }
+
+    Scalar faceArea(unsigned idx) const
+    { return faceArea_[idx]; }
+
+    const WorldVector& faceNormal(unsigned idx) const
+    { return faceNormal_[idx]; }
+
+    const GlobalPosition& faceIntegrationPos(unsigned idx) const
+    { return faceIntegrationPos_[idx]; }
+
+    const LocalPosition& faceLocalPos(unsigned idx) const
+    {
+        assert(idx < faceLocalPos_.size());
+        return faceLocalPos_[idx];
+    }
+
+    /*!
+     * \brief Returns the number of bytes allocated for the cached geometry.
+     */
+    std::size_t memoryUsage() const
+    {
+        return
+            dofBegin_.capacity()*sizeof(unsigned)
+            + faceBegin_.capacity()*sizeof(unsigned)
+            + numDof_.capacity()*sizeof(unsigned short)
+            + numInteriorFaces_.capacity()*sizeof(unsigned short)
+            + numBoundaryFaces_.capacity()*sizeof(unsigned short)
+            + dofVolume_.capacity()*sizeof(Scalar)
+            + dofPos_.capacity()*sizeof(GlobalPosition)
+            + faceInteriorIdx_.capacity()*sizeof(unsigned short)
+            + faceExteriorIdx_.capacity()*sizeof(unsigned short)
+            + faceArea_.capacity()*sizeof(Scalar)
+            + faceNormal_.capacity()*sizeof(WorldVector)
+            + faceIntegrationPos_.capacity()*sizeof(GlobalPosition)
+            + faceLocalPos_.capacity()*sizeof(LocalPosition);
+    }
+
+private:
+    void addFace_(unsigned short interiorIdx,
+                  unsigned short exteriorIdx,
+                  Scalar area,
+                  const WorldVector& normal,
+                  const GlobalPosition& integrationPos)
+    {
+        faceInteriorIdx_.push_back(interiorIdx);
+        faceExteriorIdx_.push_back(exteriorIdx);
+        faceArea_.push_back(area);
+        faceNormal_.push_back(normal);
+        faceIntegrationPos_.push_back(integrationPos);
+    }
+
+    // per element
+    std::vector<unsigned> dofBegin_;
+    std::vector<unsigned> faceBegin_;
+    std::vector<unsigned short> numDof_;
+    std::vector<unsigned short> numInteriorFaces_;
+    std::vector<unsigned short> numBoundaryFaces_;
+
+    // per sub-control volume
+    std::vector<Scalar> dofVolume_;
+    std::vector<GlobalPosition> dofPos_;
+
+    // per face
+    std::vector<unsigned short> faceInteriorIdx_;
+    std::vector<unsigned short> faceExteriorIdx_;
+    std::vector<Scalar> faceArea_;
+    std::vector<WorldVector> faceNormal_;
+    std::vector<GlobalPosition> faceIntegrationPos_;
+    std::vector<LocalPosition> faceLocalPos_;
+
+    unsigned curElemIdx_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,178 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::FvBaseVectorAdLocalLinearizer
+ */
+#ifndef EWOMS_FV_BASE_VECTOR_AD_LOCAL_LINEARIZER_HH
+#define EWOMS_FV_BASE_VECTOR_AD_LOCAL_LINEARIZER_HH
+
+#include "fvbaseadlocallinearizer.hh"
+
+namespace Opm {
+// forward declaration
+template<class TypeTag>
+class FvBaseVectorAdLocalLinearizer;
+}
+
+namespace Opm::Properties {
+
+// declare the property tags required for the vector mode automatic differentiation
+// local linearizer
+
+namespace TTag {
+struct VectorAutoDiffLocalLinearizer { using InheritsFrom = std::tuple<AutoDiffLocalLinearizer>; };
+} // namespace TTag
+
+// set the properties to be spliced in
+template<class TypeTag>
+struct LocalLinearizer<TypeTag, TTag::VectorAutoDiffLocalLinearizer>
+{ using type = Opm::FvBaseVectorAdLocalLinearizer<TypeTag>; };
+
+//! Set the function evaluation w.r.t. the primary variables of all primary DOFs of a
+//! stencil
+template<class TypeTag>
+struct Evaluation<TypeTag, TTag::VectorAutoDiffLocalLinearizer>
+{
+private:
+    static const unsigned numEq = getPropValue<TypeTag, Properties::NumEq>();
+    static const unsigned maxPrimaryDof = GetPropType<TypeTag, Properties::Stencil>::maxPrimaryDof;
+
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+
+public:
+    using type = Opm::DenseAd::Evaluation<Scalar, numEq*maxPrimaryDof>;
+};
+
+} // namespace Opm::Properties
+
+namespace Opm {
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief Calculates the local residual and its Jacobian for a single element of the grid
+ *        using a single evaluation of the local residual.
+ *
+ * In contrast to FvBaseAdLocalLinearizer, which evaluates the local residual once for
+ * each primary degree of freedom of the element, the evaluations used by this class
+ * store the derivatives w.r.t. the primary variables of all primary DOFs of the stencil
+ * at once: The derivative w.r.t. the primary variable 'pvIdx' of the local DOF 'dofIdx'
+ * is located at the index 'dofIdx*numEq + pvIdx'. As a consequence, each face flux and
+ * each storage term is only evaluated once per element.
+ *
+ * The price for this is that the intensive quantities of the current solution need to
+ * be recalculated for each element (i.e., the intensive quantity cache is not used for
+ * them) and that all operations on evaluations get more expensive by the maximum
+ * number of primary DOFs of a stencil. This pays off for the vertex centered finite
+ * volume discretization, in particular if the fluxes are expensive or if P1 finite
+ * element gradients are used. For the element centered finite volume discretization,
+ * the result is the same as for FvBaseAdLocalLinearizer.
+ */
+template<class TypeTag>
+class FvBaseVectorAdLocalLinearizer : public FvBaseAdLocalLinearizer<TypeTag>
+{
+    using ParentType = FvBaseAdLocalLinearizer<TypeTag>;
+
+    using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+    using Element = typename GridView::template Codim<0>::Entity;
+
+    enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
+
+public:
+    /*!
+     * \brief Compute an element's local Jacobian matrix and evaluate its residual.
+     *
+     * \copydetails FvBaseAdLocalLinearizer::linearize(const Element&)
+     */
+    void linearize(const Element& element)
+    {
+        linearize(*this->internalElemContext_, element);
+    }
+
+    /*!
+     * \brief Compute an element's local Jacobian matrix and evaluate its residual.
+     *
+     * \copydetails FvBaseAdLocalLinearizer::linearize(ElementContext&, const Element&)
+     */
+    void linearize(ElementContext& elemCtx, const Element& elem)
+    {
+        elemCtx.updateStencil(elem);
+        elemCtx.setFocusAllPrimaryDofs();
+        elemCtx.updateAllIntensiveQuantities();
+
+        // update the weights of the primary variables for the context
+        this->model_().updatePVWeights(elemCtx);
+
+        // resize the internal arrays of the linearizer
+        this->resize_(elemCtx);
+        this->reset_(elemCtx);
+
+        // compute the local residual and its derivatives w.r.t. all primary DOFs
+        elemCtx.updateAllExtensiveQuantities();
+        this->localResidual_.eval(elemCtx);
+
+        // convert the local Jacobian matrix and the right hand side from the data
+        // structures used by the automatic differentiation code to the conventional
+        // ones used by the linear solver.
+        updateVectorLinearization_(elemCtx);
+    }
+
+protected:
+    /*!
+     * \brief Updates the current local Jacobian matrix with the partial derivatives of
+     *        all equations w.r.t. the primary variables of all primary DOFs.
+     */
+    void updateVectorLinearization_(const ElementContext& elemCtx)
+    {
+        const auto& resid = this->localResidual_.residual();
+
+        size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+        for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; dofIdx++)
+            for (unsigned eqIdx = 0; eqIdx < numEq; eqIdx++)
+                this->residual_[dofIdx][eqIdx] = resid[dofIdx][eqIdx].value();
+
+        size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
+        for (unsigned dofIdx = 0; dofIdx < numDof; dofIdx++) {
+            for (unsigned focusDofIdx = 0; focusDofIdx < numPrimaryDof; focusDofIdx++) {
+                for (unsigned eqIdx = 0; eqIdx < numEq; eqIdx++) {
+                    for (unsigned pvIdx = 0; pvIdx < numEq; pvIdx++) {
+                        // A[dofIdx][focusDofIdx][eqIdx][pvIdx] is the partial derivative
+                        // of the residual function 'eqIdx' for the degree of freedom
+                        // 'dofIdx' with regard to the variable 'pvIdx' of the degree of
+                        // freedom 'focusDofIdx'
+                        this->jacobian_[dofIdx][focusDofIdx][eqIdx][pvIdx] =
+                            resid[dofIdx][eqIdx].derivative(focusDofIdx*numEq + pvIdx);
+                        Opm::Valgrind::CheckDefined(this->jacobian_[dofIdx][focusDofIdx][eqIdx][pvIdx]);
+                    }
+                }
+            }
+        }
+    }
+};
+
+} // namespace Opm
+
+#endif
@@ -28,6 +28,7 @@
 #ifndef EWOMS_ECFV_STENCIL_HH
 #define EWOMS_ECFV_STENCIL_HH
 
+#include <opm/models/discretization/common/fvbasestencilgeometrycache.hh>
 #include <opm/models/utils/quadraturegeometries.hh>
 
 #include <opm/material/common/ConditionalStorage.hpp>
@@ -72,6 +73,10 @@ class EcfvStencil
 public:
     using Entity = Element       ;
     using Mapper = ElementMapper ;
+    using GeometryCache = FvBaseStencilGeometryCache<Scalar, GridView>;
+
+    //! upper bound for the number of primary degrees of freedom of a stencil
+    enum { maxPrimaryDof = 1 };
 
     using LocalGeometry = typename Element::Geometry;
 
@@ -95,6 +100,14 @@ public:
             : element_(element)
         { update(); }
 
+        SubControlVolume(const Element& element,
+                         const GlobalPosition& centerPos,
+                         Scalar volume)
+            : centerPos_(centerPos)
+            , volume_(volume)
+            , element_(element)
+        {}
+
         void update(const Element& element)
         { element_ = element; }
 
@@ -164,6 +177,20 @@ public:
             area_ = geometry.volume();
         }
 
+        EcfvSubControlVolumeFace(unsigned localNeighborIdx,
+                                 Scalar area,
+                                 const WorldVector& normal,
+                                 const GlobalPosition& integrationPos)
+        {
+            exteriorIdx_ = static_cast<unsigned short>(localNeighborIdx);
+
+            if (needNormal)
+                (*normal_) = normal;
+            if (needIntegrationPos)
+                (*integrationPos_) = integrationPos;
+            area_ = area;
+        }
+
         /*!
          * \brief Returns the local index of the degree of freedom to
          *        the face's interior.
@@ -268,6 +295,91 @@ public:
         updateTopology(element);
     }
 
+    /*!
+     * \brief Update the stencil using the finite volume geometry stored by a cache.
+     *
+     * The neighbors of the element still need to be determined, but the geometries of
+     * the element, its neighbors and its intersections are not evaluated.
+     *
+     * \param element The element for which the stencil ought to be updated.
+     * \param cache The cache which contains the geometry of the element.
+     * \param elemIdx The index of the element in the cache.
+     */
+    void update(const Element& element, const GeometryCache& cache, unsigned elemIdx)
+    {
+        unsigned dofIdx = cache.dofBegin(elemIdx);
+        unsigned faceIdx = cache.interiorFaceBegin(elemIdx);
+        unsigned bfIdx = cache.boundaryFaceBegin(elemIdx);
+
+        // add the "center" element of the stencil
+        subControlVolumes_.clear();
+        subControlVolumes_.emplace_back(element, cache.dofPos(dofIdx), cache.dofVolume(dofIdx));
+        ++dofIdx;
+        elements_.clear();
+        elements_.emplace_back(element);
+
+        interiorFaces_.clear();
+        boundaryFaces_.clear();
+
+        // the intersections are visited in the same order as by storeGeometry()
+        auto isIt = gridView_.ibegin(element);
+        const auto& endIsIt = gridView_.iend(element);
+        for (; isIt != endIsIt; ++isIt) {
+            const auto& intersection = *isIt;
+            if (intersection.neighbor()) {
+                elements_.emplace_back( intersection.outside() );
+                subControlVolumes_.emplace_back(elements_.back(),
+                                                cache.dofPos(dofIdx),
+                                                cache.dofVolume(dofIdx));
+                ++dofIdx;
+                interiorFaces_.emplace_back(cache.faceExteriorIndex(faceIdx),
+                                            cache.faceArea(faceIdx),
+                                            cache.faceNormal(faceIdx),
+                                            cache.faceIntegrationPos(faceIdx));
+                ++faceIdx;
+            }
+            else {
+                boundaryFaces_.emplace_back(cache.faceExteriorIndex(bfIdx),
+                                            cache.faceArea(bfIdx),
+                                            cache.faceNormal(bfIdx),
+                                            cache.faceIntegrationPos(bfIdx));
+                ++bfIdx;
+            }
+        }
+
+        assert(numDof() == cache.numDof(elemIdx));
+        assert(numInteriorFaces() == cache.numInteriorFaces(elemIdx));
+        assert(numBoundaryFaces() == cache.numBoundaryFaces(elemIdx));
+    }
+
+    /*!
+     * \brief Add the finite volume geometry of the current element to a cache.
+     *
+     * \param cache The cache to which the geometry is added.
+     * \param elemIdx The index of the element in the cache.
+     */
+    void storeGeometry(GeometryCache& cache, unsigned elemIdx) const
+    {
+        cache.beginElement(elemIdx);
+
+        for (const auto& scv : subControlVolumes_)
+            cache.addDof(scv.volume(), scv.globalPos());
+
+        for (const auto& face : interiorFaces_)
+            cache.addInteriorFace(face.interiorIndex(),
+                                  face.exteriorIndex(),
+                                  face.area(),
+                                  needFaceNormal ? face.normal() : WorldVector(0.0),
+                                  needFaceIntegrationPos ? face.integrationPos() : GlobalPosition(0.0));
+
+        for (const auto& face : boundaryFaces_)
+            cache.addBoundaryFace(face.interiorIndex(),
+                                  face.exteriorIndex(),
+                                  face.area(),
+                                  needFaceNormal ? face.normal() : WorldVector(0.0),
+                                  face.integrationPos());
+    }
+
     void updateCenterGradients()
     {
         assert(false); // not yet implemented
@@ -176,7 +176,7 @@ public:
             QuantityType value(0.0);
             for (unsigned vertIdx = 0; vertIdx < elemCtx.numDof(/*timeIdx=*/0); ++vertIdx) {
                 if (std::is_same<QuantityType, Scalar>::value ||
-                    elemCtx.focusDofIndex() == vertIdx)
+                    elemCtx.isFocusDof(vertIdx))
                     value += quantityCallback(vertIdx)*p1Value_[fapIdx][vertIdx];
                 else
                     value += Toolbox::value(quantityCallback(vertIdx))*p1Value_[fapIdx][vertIdx];
@@ -225,7 +225,7 @@ public:
             QuantityType value(0.0);
             for (unsigned vertIdx = 0; vertIdx < elemCtx.numDof(/*timeIdx=*/0); ++vertIdx) {
                 if (std::is_same<QuantityType, Scalar>::value ||
-                    elemCtx.focusDofIndex() == vertIdx)
+                    elemCtx.isFocusDof(vertIdx))
                 {
                     const auto& tmp = quantityCallback(vertIdx);
                     for (unsigned k = 0; k < tmp.size(); ++k)
@@ -276,7 +276,7 @@ public:
             quantityGrad = 0.0;
             for (unsigned vertIdx = 0; vertIdx < elemCtx.numDof(/*timeIdx=*/0); ++vertIdx) {
                 if (std::is_same<QuantityType, Scalar>::value ||
-                    elemCtx.focusDofIndex() == vertIdx)
+                    elemCtx.isFocusDof(vertIdx))
                 {
                     const auto& dofVal = quantityCallback(vertIdx);
                     const auto& tmp = p1Gradient_[fapIdx][vertIdx];
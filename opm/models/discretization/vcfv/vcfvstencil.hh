@@ -28,6 +28,7 @@
 #ifndef EWOMS_VCFV_STENCIL_HH
 #define EWOMS_VCFV_STENCIL_HH
 
+#include <opm/models/discretization/common/fvbasestencilgeometrycache.hh>
 #include <opm/models/utils/quadraturegeometries.hh>
 
 #include <opm/material/common/Unused.hpp>
@@ -726,6 +727,12 @@ public:
     //! exported Mapper type
     using Mapper = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
 
+    //! exported type of the cache for the finite volume geometry of all elements
+    using GeometryCache = FvBaseStencilGeometryCache<Scalar, GridView>;
+
+    //! upper bound for the number of primary degrees of freedom of a stencil
+    enum { maxPrimaryDof = maxNC };
+
     class ScvGeometry
     {
     public:
@@ -1015,9 +1022,77 @@ public:
         updateScvGeometry(e);
     }
 
+    /*!
+     * \brief Update the stencil using the finite volume geometry stored by a cache.
+     *
+     * Only the reference element of the element is queried, its geometry is not
+     * evaluated.
+     *
+     * \param e The element for which the stencil ought to be updated.
+     * \param cache The cache which contains the geometry of the element.
+     * \param elemIdx The index of the element in the cache.
+     */
+    void update(const Element& e, const GeometryCache& cache, unsigned elemIdx)
+    {
+        element_ = e;
+
+        numVertices = e.subEntities(/*codim=*/dim);
+        numEdges = e.subEntities(/*codim=*/dim-1);
+        numFaces = (dim<3)?0:e.subEntities(/*codim=*/1);
+        numBoundarySegments_ = cache.numBoundaryFaces(elemIdx);
+        geometryType_ = e.type();
+
+        assert(numVertices == cache.numDof(elemIdx));
+        assert(numEdges == cache.numInteriorFaces(elemIdx));
+
+        const auto& referenceElement = Dune::ReferenceElements<CoordScalar,dim>::general(geometryType_);
+        unsigned dofIdx = cache.dofBegin(elemIdx);
+        for (unsigned vertexIdx = 0; vertexIdx < numVertices; vertexIdx++, dofIdx++) {
+            subContVol[vertexIdx].local = referenceElement.position(static_cast<int>(vertexIdx), dim);
+            subContVol[vertexIdx].global = cache.dofPos(dofIdx);
+            subContVol[vertexIdx].volume_ = cache.dofVolume(dofIdx);
+        }
+
+        unsigned faceIdx = cache.interiorFaceBegin(elemIdx);
+        for (unsigned k = 0; k < numEdges; k++, faceIdx++)
+            restoreFace_(subContVolFace[k], cache, faceIdx);
+
+        unsigned bfIdx = cache.boundaryFaceBegin(elemIdx);
+        for (unsigned k = 0; k < numBoundarySegments_; k++, bfIdx++)
+            restoreFace_(boundaryFace_[k], cache, bfIdx);
+
+        updateScvGeometry(element_);
+    }
+
+    /*!
+     * \brief Add the finite volume geometry of the current element to a cache.
+     *
+     * \param cache The cache to which the geometry is added.
+     * \param elemIdx The index of the element in the cache.
+     */
+    void storeGeometry(GeometryCache& cache, unsigned elemIdx) const
+    {
+        cache.beginElement(elemIdx);
+
+        for (unsigned vertexIdx = 0; vertexIdx < numVertices; vertexIdx++)
+            cache.addDof(subContVol[vertexIdx].volume_, subContVol[vertexIdx].global);
+
+        for (unsigned k = 0; k < numEdges; k++) {
+            const auto& face = subContVolFace[k];
+            cache.addInteriorFace(face.i, face.j, face.area_, face.normal_, face.ipGlobal_);
+            cache.addFaceLocalPos(face.ipLocal_);
+        }
+
+        for (unsigned k = 0; k < numBoundarySegments_; k++) {
+            const auto& face = boundaryFace_[k];
+            cache.addBoundaryFace(face.i, face.j, face.area_, face.normal_, face.ipGlobal_);
+            cache.addFaceLocalPos(face.ipLocal_);
+        }
+    }
+
     void updateScvGeometry(const Element& element)
     {
-        auto geomType = element.geometry().type();
+        auto geomType = element.type();
 
         // get the local geometries of the sub control volumes
         if (geomType.isTriangle() || geomType.isTetrahedron()) {
@@ -1108,6 +1183,16 @@ public:
     }
 
 private:
+    static void restoreFace_(SubControlVolumeFace& face, const GeometryCache& cache, unsigned faceIdx)
+    {
+        face.i = cache.faceInteriorIndex(faceIdx);
+        face.j = cache.faceExteriorIndex(faceIdx);
+        face.ipLocal_ = cache.faceLocalPos(faceIdx);
+        face.ipGlobal_ = cache.faceIntegrationPos(faceIdx);
+        face.normal_ = cache.faceNormal(faceIdx);
+        face.area_ = cache.faceArea(faceIdx);
+    }
+
 #if __GNUC__ || __clang__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
@@ -104,14 +104,13 @@ public:
         ParentType::update(elemCtx, dofIdx, timeIdx);
         EnergyIntensiveQuantities::updateTemperatures_(fluidState_, elemCtx, dofIdx, timeIdx);
 
-        const auto& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
         const auto& problem = elemCtx.problem();
-        Scalar flashTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, FlashTolerance);
+        Scalar flashTolerance = elemCtx.model().flashTolerance();
 
         // extract the total molar densities of the components
         ComponentVector cTotal;
         for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
-            cTotal[compIdx] = priVars.makeEvaluation(cTot0Idx + compIdx, timeIdx);
+            cTotal[compIdx] = elemCtx.makeEvaluation(dofIdx, cTot0Idx + compIdx, timeIdx);
 
         const auto *hint = elemCtx.thermodynamicHint(dofIdx, timeIdx);
         if (hint) {
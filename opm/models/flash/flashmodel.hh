@@ -216,7 +216,9 @@ class FlashModel
 public:
     FlashModel(Simulator& simulator)
         : ParentType(simulator)
-    {}
+    {
+        flashTolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, FlashTolerance);
+    }
 
     /*!
      * \brief Register all run-time parameters for the immiscible model.
@@ -245,6 +247,13 @@ public:
     static std::string name()
     { return "flash"; }
 
+    /*!
+     * \brief Returns the maximum tolerance for the flash solver to consider the solution
+     *        converged.
+     */
+    Scalar flashTolerance() const
+    { return flashTolerance_; }
+
     /*!
      * \copydoc FvBaseDiscretization::primaryVarName
      */
@@ -331,6 +340,9 @@ public:
         if (enableEnergy)
             this->addOutputModule(new Opm::VtkEnergyModule<TypeTag>(this->simulator_));
     }
+
+private:
+    Scalar flashTolerance_;
 };
 
 } // namespace Opm
@@ -100,7 +100,6 @@ public:
         ExtensiveQuantities extQuants;
         extQuants.updateBoundary(context, bfIdx, timeIdx, fluidState);
         const auto& insideIntQuants = context.intensiveQuantities(bfIdx, timeIdx);
-        unsigned focusDofIdx = context.focusDofIndex();
         unsigned interiorDofIdx = context.interiorScvIndex(bfIdx, timeIdx);
 
         ////////
@@ -114,12 +113,12 @@ public:
             // mass conservation
             Evaluation density;
             if  (pBoundary > pInside) {
-                if (focusDofIdx == interiorDofIdx)
+                if (context.isFocusDof(interiorDofIdx))
                     density = fluidState.density(phaseIdx);
                 else
                     density = Opm::getValue(fluidState.density(phaseIdx));
             }
-            else if (focusDofIdx == interiorDofIdx)
+            else if (context.isFocusDof(interiorDofIdx))
                 density = insideIntQuants.fluidState().density(phaseIdx);
             else
                 density = Opm::getValue(insideIntQuants.fluidState().density(phaseIdx));
@@ -133,12 +132,12 @@ public:
             if (enableEnergy) {
                 Evaluation specificEnthalpy;
                 if (pBoundary > pInside) {
-                    if (focusDofIdx == interiorDofIdx)
+                    if (context.isFocusDof(interiorDofIdx))
                         specificEnthalpy = fluidState.enthalpy(phaseIdx);
                     else
                         specificEnthalpy = Opm::getValue(fluidState.enthalpy(phaseIdx));
                 }
-                else if (focusDofIdx == interiorDofIdx)
+                else if (context.isFocusDof(interiorDofIdx))
                     specificEnthalpy = insideIntQuants.fluidState().enthalpy(phaseIdx);
                 else
                     specificEnthalpy = Opm::getValue(insideIntQuants.fluidState().enthalpy(phaseIdx));
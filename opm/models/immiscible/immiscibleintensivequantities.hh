@@ -104,7 +104,7 @@ public:
 
         Evaluation sumSat = 0.0;
         for (unsigned phaseIdx = 0; phaseIdx < numPhases - 1; ++phaseIdx) {
-            const Evaluation& Salpha = priVars.makeEvaluation(saturation0Idx + phaseIdx, timeIdx);
+            const Evaluation& Salpha = elemCtx.makeEvaluation(dofIdx, saturation0Idx + phaseIdx, timeIdx);
             fluidState_.setSaturation(phaseIdx, Salpha);
             sumSat += Salpha;
         }
@@ -118,7 +118,7 @@ public:
         MaterialLaw::relativePermeabilities(relativePermeability_, materialParams, fluidState_);
         Opm::Valgrind::CheckDefined(relativePermeability_);
 
-        const Evaluation& p0 = priVars.makeEvaluation(pressure0Idx, timeIdx);
+        const Evaluation& p0 = elemCtx.makeEvaluation(dofIdx, pressure0Idx, timeIdx);
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
             fluidState_.setPressure(phaseIdx, p0 + (pC[phaseIdx] - pC[0]));
 
@@ -136,7 +136,6 @@ public:
         ////////
         // advective fluxes of all components in all phases
         ////////
-        unsigned focusDofIdx = elemCtx.focusDofIndex();
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             // data attached to upstream DOF of the current phase.
             unsigned upIdx = static_cast<unsigned>(extQuants.upstreamIndex(phaseIdx));
@@ -145,7 +144,7 @@ public:
 
             // add advective flux of current component in current phase.
             const Evaluation& rho = up.fluidState().density(phaseIdx);
-            if (focusDofIdx == upIdx)
+            if (elemCtx.isFocusDof(upIdx))
                 flux[conti0EqIdx + phaseIdx] += extQuants.volumeFlux(phaseIdx)*rho;
             else
                 flux[conti0EqIdx + phaseIdx] += extQuants.volumeFlux(phaseIdx)*Toolbox::value(rho);
@@ -29,6 +29,8 @@
 
 #include "baseoutputwriter.hh"
 
+#include <opm/material/common/Unused.hpp>
+
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/models/utils/propertysystem.hh>
 #include <opm/models/utils/basicproperties.hh>
@@ -75,6 +77,7 @@ class BaseOutputModule
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using GridView = GetPropType<TypeTag, Properties::GridView>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
     using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
     using DiscBaseOutputModule = GetPropType<TypeTag, Properties::DiscBaseOutputModule>;
 
@@ -105,6 +108,15 @@ public:
     virtual ~BaseOutputModule()
     {}
 
+    /*!
+     * \brief Look up the run-time parameters which are the same for all elements and
+     *        degrees of freedom of an output step.
+     *
+     * This is called by the model once per output step before allocBuffers().
+     */
+    void beginOutputStep()
+    { enableVtkOutput_ = EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput); }
+
     /*!
      * \brief Allocate memory for the scalar fields we would like to
      *        write to disk.
@@ -125,6 +137,18 @@ public:
      */
     virtual void processElement(const ElementContext& elemCtx) = 0;
 
+    /*!
+     * \brief Modify the internal buffers according to the intensive quantities of a
+     *        single degree of freedom
+     *
+     * This method is only called if dofDataOnly() returns true and the intensive
+     * quantities of all degrees of freedom are available from the model's cache. In
+     * this case, it is called instead of processElement().
+     */
+    virtual void processDof(unsigned globalDofIdx OPM_UNUSED,
+                            const IntensiveQuantities& intQuants OPM_UNUSED)
+    { throw std::logic_error("Output modules which only need per-DOF data must implement processDof()"); }
+
     /*!
      * \brief Add all buffers to the VTK output writer.
      */
@@ -143,6 +167,18 @@ public:
     virtual bool needExtensiveQuantities() const
     { return false; }
 
+    /*!
+     * \brief Returns true iff the module only needs the intensive quantities of the
+     *        individual degrees of freedom to do its job.
+     *
+     * If this is the case for all output modules of a model and the intensive
+     * quantities of all degrees of freedom are cached, the output fields are prepared
+     * without looping over the elements of the grid, i.e., processDof() is called
+     * instead of processElement(). The default is 'false'.
+     */
+    virtual bool dofDataOnly() const
+    { return false; }
+
 protected:
     enum BufferType {
         //! Buffer contains data associated with the degrees of freedom
@@ -497,6 +533,7 @@ protected:
     { baseWriter.attachTensorVertexData(buffer, name); }
 
     const Simulator& simulator_;
+    bool enableVtkOutput_ = true;
 };
 
 #if __GNUC__ || __clang__
@@ -0,0 +1,659 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::BinaryRestart
+ */
+#ifndef EWOMS_BINARY_RESTART_HH
+#define EWOMS_BINARY_RESTART_HH
+
+#include "restart.hh"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+
+namespace Opm {
+
+//! \cond SKIP_THIS
+namespace BinaryRestartDetail {
+
+// the tags which precede the raw bytes of the numbers in the binary streams
+static const char signedTag = 'i';
+static const char unsignedTag = 'u';
+static const char doubleTag = 'd';
+static const char longDoubleTag = 'e';
+
+/*!
+ * \brief Number formatting facet which writes the raw bytes of numbers instead of their
+ *        decimal representation.
+ *
+ * Each number is preceeded by a tag which specifies how it is stored.
+ */
+class NumPut : public std::num_put<char>
+{
+protected:
+    iter_type do_put(iter_type out, std::ios_base&, char_type, bool v) const override
+    { return putRaw_(out, unsignedTag, static_cast<unsigned long long>(v)); }
+
+    iter_type do_put(iter_type out, std::ios_base&, char_type, long v) const override
+    { return putRaw_(out, signedTag, static_cast<long long>(v)); }
+
+    iter_type do_put(iter_type out, std::ios_base&, char_type, unsigned long v) const override
+    { return putRaw_(out, unsignedTag, static_cast<unsigned long long>(v)); }
+
+    iter_type do_put(iter_type out, std::ios_base&, char_type, long long v) const override
+    { return putRaw_(out, signedTag, v); }
+
+    iter_type do_put(iter_type out, std::ios_base&, char_type, unsigned long long v) const override
+    { return putRaw_(out, unsignedTag, v); }
+
+    iter_type do_put(iter_type out, std::ios_base&, char_type, double v) const override
+    { return putRaw_(out, doubleTag, v); }
+
+    iter_type do_put(iter_type out, std::ios_base&, char_type, long double v) const override
+    { return putRaw_(out, longDoubleTag, v); }
+
+    iter_type do_put(iter_type out, std::ios_base&, char_type, const void* v) const override
+    { return putRaw_(out, unsignedTag, static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(v))); }
+
+private:
+    template <class T>
+    static iter_type putRaw_(iter_type out, char tag, const T& value)
+    {
+        char buf[sizeof(T)];
+        std::memcpy(buf, &value, sizeof(T));
+
+        *out++ = tag;
+        for (unsigned i = 0; i < sizeof(T); ++i)
+            *out++ = buf[i];
+        return out;
+    }
+};
+
+/*!
+ * \brief Number parsing facet which reads numbers written by NumPut.
+ *
+ * Whitespace between numbers is skipped, so that the data written by the (text based)
+ * serialization methods of the simulator objects can be read back unmodified.
+ */
+class NumGet : public std::num_get<char>
+{
+    struct Number
+    {
+        char tag;
+        long long i;
+        unsigned long long u;
+        double d;
+        long double e;
+    };
+
+protected:
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, bool& v) const override
+    { return getInteger_(in, end, err, v); }
+
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, long& v) const override
+    { return getInteger_(in, end, err, v); }
+
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, unsigned short& v) const override
+    { return getInteger_(in, end, err, v); }
+
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, unsigned int& v) const override
+    { return getInteger_(in, end, err, v); }
+
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, unsigned long& v) const override
+    { return getInteger_(in, end, err, v); }
+
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, long long& v) const override
+    { return getInteger_(in, end, err, v); }
+
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, unsigned long long& v) const override
+    { return getInteger_(in, end, err, v); }
+
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, float& v) const override
+    { return getFloatingPoint_(in, end, err, v); }
+
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, double& v) const override
+    { return getFloatingPoint_(in, end, err, v); }
+
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, long double& v) const override
+    { return getFloatingPoint_(in, end, err, v); }
+
+    iter_type do_get(iter_type in, iter_type end, std::ios_base&, std::ios_base::iostate& err, void*& v) const override
+    {
+        unsigned long long tmp = 0;
+        in = getInteger_(in, end, err, tmp);
+        v = reinterpret_cast<void*>(static_cast<std::uintptr_t>(tmp));
+        return in;
+    }
+
+private:
+    template <class T>
+    static iter_type getInteger_(iter_type in, iter_type end, std::ios_base::iostate& err, T& v)
+    {
+        Number n;
+        in = getNumber_(in, end, err, n);
+        if (err & std::ios_base::failbit)
+            return in;
+
+        if (n.tag == signedTag
+            && n.i >= static_cast<long long>(std::numeric_limits<T>::min())
+            && (n.i < 0 || static_cast<unsigned long long>(n.i) <= static_cast<unsigned long long>(std::numeric_limits<T>::max())))
+            v = static_cast<T>(n.i);
+        else if (n.tag == unsignedTag
+                 && n.u <= static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+            v = static_cast<T>(n.u);
+        else
+            err |= std::ios_base::failbit;
+
+        return in;
+    }
+
+    template <class T>
+    static iter_type getFloatingPoint_(iter_type in, iter_type end, std::ios_base::iostate& err, T& v)
+    {
+        Number n;
+        in = getNumber_(in, end, err, n);
+        if (err & std::ios_base::failbit)
+            return in;
+
+        switch (n.tag) {
+        case signedTag: v = static_cast<T>(n.i); break;
+        case unsignedTag: v = static_cast<T>(n.u); break;
+        case doubleTag: v = static_cast<T>(n.d); break;
+        case longDoubleTag: v = static_cast<T>(n.e); break;
+        }
+
+        return in;
+    }
+
+    static iter_type getNumber_(iter_type in, iter_type end, std::ios_base::iostate& err, Number& n)
+    {
+        // skip the separators written by the serialization code
+        while (in != end && std::isspace(*in, std::locale::classic()))
+            ++in;
+
+        if (in == end) {
+            err |= std::ios_base::eofbit | std::ios_base::failbit;
+            return in;
+        }
+
+        n.tag = *in++;
+        switch (n.tag) {
+        case signedTag: return getRaw_(in, end, err, n.i);
+        case unsignedTag: return getRaw_(in, end, err, n.u);
+        case doubleTag: return getRaw_(in, end, err, n.d);
+        case longDoubleTag: return getRaw_(in, end, err, n.e);
+        }
+
+        err |= std::ios_base::failbit;
+        return in;
+    }
+
+    template <class T>
+    static iter_type getRaw_(iter_type in, iter_type end, std::ios_base::iostate& err, T& value)
+    {
+        char buf[sizeof(T)];
+        for (unsigned i = 0; i < sizeof(T); ++i) {
+            if (in == end) {
+                err |= std::ios_base::eofbit | std::ios_base::failbit;
+                return in;
+            }
+            buf[i] = *in++;
+        }
+
+        std::memcpy(&value, buf, sizeof(T));
+        return in;
+    }
+};
+
+/*!
+ * \brief Returns a locale which causes streams to read and write numbers in binary.
+ */
+inline const std::locale& binaryLocale()
+{
+    static const std::locale loc(std::locale(std::locale::classic(), new NumPut), new NumGet);
+    return loc;
+}
+
+/*!
+ * \brief Continues the 64 bit FNV-1a hash of a sequence of bytes.
+ */
+inline std::uint64_t updateChecksum(std::uint64_t hash, const char* data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*!
+ * \brief Computes the 64 bit FNV-1a hash of a sequence of bytes.
+ */
+inline std::uint64_t checksum(const char* data, size_t size)
+{ return updateChecksum(14695981039346656037ULL, data, size); }
+
+/*!
+ * \brief Stream buffer which forwards the written characters to another stream buffer
+ *        and computes their number and their checksum on the fly.
+ *
+ * This allows to write the payload of a section directly to the restart file instead
+ * of assembling it in memory first.
+ */
+class ChecksumStreamBuf : public std::streambuf
+{
+public:
+    ChecksumStreamBuf()
+    { reset(nullptr); }
+
+    /*!
+     * \brief Start a new sequence of bytes which is forwarded to a given stream buffer.
+     */
+    void reset(std::streambuf* target)
+    {
+        target_ = target;
+        size_ = 0;
+        checksum_ = BinaryRestartDetail::checksum(nullptr, 0);
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+
+    /*!
+     * \brief The number of bytes written since the last reset.
+     *
+     * This is only up to date after the stream buffer has been synchronized.
+     */
+    std::uint64_t size() const
+    { return size_; }
+
+    /*!
+     * \brief The checksum of the bytes written since the last reset.
+     *
+     * This is only up to date after the stream buffer has been synchronized.
+     */
+    std::uint64_t checksum() const
+    { return checksum_; }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (!flush_())
+            return traits_type::eof();
+
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override
+    { return flush_() ? 0 : -1; }
+
+private:
+    bool flush_()
+    {
+        std::streamsize n = pptr() - pbase();
+        if (n == 0)
+            return true;
+        if (!target_)
+            return false;
+
+        checksum_ = updateChecksum(checksum_, pbase(), static_cast<size_t>(n));
+        size_ += static_cast<std::uint64_t>(n);
+        bool success = (target_->sputn(pbase(), n) == n);
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+        return success;
+    }
+
+    std::array<char, 4096> buffer_;
+    std::streambuf* target_;
+    std::uint64_t size_;
+    std::uint64_t checksum_;
+};
+
+} // namespace BinaryRestartDetail
+//! \endcond
+
+/*!
+ * \brief Load or save a state of a problem to/from the harddisk using a binary format.
+ *
+ * This class features the same interface as Opm::Restart, i.e., it can be used with
+ * the serialize() and deserialize() methods of the simulator objects without modifying
+ * them. In contrast to the text format, numbers are stored using their raw binary
+ * representation which avoids the expensive conversion from and to text and makes the
+ * restart files considerably smaller. Also, every section of the file is checksummed,
+ * so that corrupted restart files are detected.
+ *
+ * The file starts with a header that consists of a magic string, the version of the
+ * file format and a marker for the byte order. It is followed by the sections; each
+ * of them consists of its name, the size of its payload, the checksum of the payload
+ * and the payload itself.
+ */
+class BinaryRestart
+{
+    static const char* fileMagic_()
+    { return "OPMBRST"; }
+
+    static std::uint32_t formatVersion_()
+    { return 1; }
+
+    static std::uint32_t byteOrderMarker_()
+    { return 0x01020304; }
+
+public:
+    BinaryRestart()
+        : sectionOutStream_(&sectionOutBuf_)
+    {
+        sectionOutStream_.imbue(BinaryRestartDetail::binaryLocale());
+        sectionInStream_.imbue(BinaryRestartDetail::binaryLocale());
+
+        // the separators are skipped when parsing numbers. since the raw bytes of a
+        // number may look like whitespace, they must not be skipped before that.
+        sectionInStream_.unsetf(std::ios::skipws);
+    }
+
+    /*!
+     * \brief Returns the name of the file which is (de-)serialized.
+     */
+    const std::string& fileName() const
+    { return fileName_; }
+
+    /*!
+     * \brief Write the current state of the model to disk.
+     *
+     * \param simulator The simulator which ought to be serialized
+     * \param toMemory If true, the file is not written. Instead, the serialized data is
+     *                 kept in memory until it is retrieved using takeSerializedData().
+     */
+    template <class Simulator>
+    void serializeBegin(Simulator& simulator, bool toMemory = false)
+    {
+        const std::string magicCookie = Restart::magicRestartCookie_(simulator.gridView());
+        fileName_ = Restart::restartFileName_(simulator.gridView(),
+                                              simulator.problem().outputDir(),
+                                              simulator.problem().name(),
+                                              simulator.time(),
+                                              ".brs");
+
+        if (toMemory) {
+            outBuffer_.str("");
+            outStream_ = &outBuffer_;
+        }
+        else {
+            outFile_.open(fileName_.c_str(), std::ios::out | std::ios::binary);
+            outStream_ = &outFile_;
+        }
+
+        if (!outStream_->good())
+            throw std::runtime_error("Restart file '"+fileName_+"' could not be opened properly");
+
+        // write the file header
+        outStream_->write(fileMagic_(), static_cast<std::streamsize>(std::strlen(fileMagic_()) + 1));
+        writeRaw_(formatVersion_());
+        writeRaw_(byteOrderMarker_());
+
+        serializeSectionBegin(magicCookie);
+        serializeSectionEnd();
+    }
+
+    /*!
+     * \brief The output stream to write the serialized data.
+     */
+    std::ostream& serializeStream()
+    { return sectionOutStream_; }
+
+    /*!
+     * \brief Start a new section in the serialized output.
+     *
+     * The payload of the section is written directly to the output. The size and the
+     * checksum which precede it are filled in by serializeSectionEnd().
+     */
+    void serializeSectionBegin(const std::string& cookie)
+    {
+        sectionCookie_ = cookie;
+
+        writeRaw_(static_cast<std::uint64_t>(sectionCookie_.size()));
+        outStream_->write(sectionCookie_.data(), static_cast<std::streamsize>(sectionCookie_.size()));
+        sectionHeaderPos_ = outStream_->tellp();
+        writeRaw_(static_cast<std::uint64_t>(0));
+        writeRaw_(static_cast<std::uint64_t>(0));
+
+        sectionOutBuf_.reset(outStream_->rdbuf());
+        sectionOutStream_.clear();
+    }
+
+    /*!
+     * \brief End of a section in the serialized output.
+     */
+    void serializeSectionEnd()
+    {
+        sectionOutStream_.flush();
+        bool success = sectionOutStream_.good();
+
+        // fill in the size and the checksum of the payload
+        std::streampos sectionEndPos = outStream_->tellp();
+        outStream_->seekp(sectionHeaderPos_);
+        writeRaw_(sectionOutBuf_.size());
+        writeRaw_(sectionOutBuf_.checksum());
+        outStream_->seekp(sectionEndPos);
+
+        if (!success || !outStream_->good())
+            throw std::runtime_error("Could not write section '"+sectionCookie_+"' to restart file '"
+                                     +fileName_+"'");
+
+        sectionOutBuf_.reset(nullptr);
+    }
+
+    /*!
+     * \brief Serialize all leaf entities of a codim in a gridView.
+     *
+     * The actual work is done by Serializer::serialize(Entity)
+     */
+    template <int codim, class Serializer, class GridView>
+    void serializeEntities(Serializer& serializer, const GridView& gridView)
+    {
+        std::ostringstream oss;
+        oss << "Entities: Codim " << codim;
+        serializeSectionBegin(oss.str());
+
+        using Iterator = typename GridView::template Codim<codim>::Iterator;
+
+        Iterator it = gridView.template begin<codim>();
+        const Iterator& endIt = gridView.template end<codim>();
+        for (; it != endIt; ++it)
+            serializer.serializeEntity(sectionOutStream_, *it);
+
+        serializeSectionEnd();
+    }
+
+    /*!
+     * \brief Finish the restart file.
+     */
+    void serializeEnd()
+    {
+        if (outStream_ == &outFile_)
+            outFile_.close();
+    }
+
+    /*!
+     * \brief Returns the data which was serialized to memory and clears the buffer.
+     *
+     * This only makes sense if serializeBegin() was called with toMemory=true. The
+     * returned data is the content of the file returned by fileName().
+     */
+    std::string takeSerializedData()
+    {
+        std::string data = outBuffer_.str();
+        outBuffer_.str("");
+        return data;
+    }
+
+    /*!
+     * \brief Start reading a restart file at a certain simulated
+     *        time.
+     */
+    template <class Simulator, class Scalar>
+    void deserializeBegin(Simulator& simulator, Scalar t)
+    {
+        fileName_ = Restart::restartFileName_(simulator.gridView(),
+                                              simulator.problem().outputDir(),
+                                              simulator.problem().name(),
+                                              t,
+                                              ".brs");
+
+        inStream_.open(fileName_.c_str(), std::ios::in | std::ios::binary);
+        if (!inStream_.good())
+            throw std::runtime_error("Restart file '"+fileName_+"' could not be opened properly");
+
+        // check the file header
+        std::string magic(std::strlen(fileMagic_()) + 1, '\0');
+        inStream_.read(&magic[0], static_cast<std::streamsize>(magic.size()));
+        if (!inStream_.good() || std::strcmp(magic.c_str(), fileMagic_()) != 0)
+            throw std::runtime_error("File '"+fileName_+"' is not a binary restart file");
+
+        if (readRaw_<std::uint32_t>() != formatVersion_())
+            throw std::runtime_error("Restart file '"+fileName_+"' uses an unsupported version "
+                                     "of the binary format");
+
+        if (readRaw_<std::uint32_t>() != byteOrderMarker_())
+            throw std::runtime_error("Restart file '"+fileName_+"' was written on a machine "
+                                     "with a different byte order");
+
+        const std::string magicCookie = Restart::magicRestartCookie_(simulator.gridView());
+
+        deserializeSectionBegin(magicCookie);
+        deserializeSectionEnd();
+    }
+
+    /*!
+     * \brief The input stream to read the data which ought to be
+     *        deserialized.
+     */
+    std::istream& deserializeStream()
+    { return sectionInStream_; }
+
+    /*!
+     * \brief Start reading a new section of the restart file.
+     */
+    void deserializeSectionBegin(const std::string& cookie)
+    {
+        std::string sectionCookie(readRaw_<std::uint64_t>(), '\0');
+        inStream_.read(&sectionCookie[0], static_cast<std::streamsize>(sectionCookie.size()));
+        if (!inStream_.good() || sectionCookie != cookie)
+            throw std::runtime_error("Could not start section '"+cookie+"'");
+
+        std::string payload(readRaw_<std::uint64_t>(), '\0');
+        std::uint64_t expectedChecksum = readRaw_<std::uint64_t>();
+        inStream_.read(&payload[0], static_cast<std::streamsize>(payload.size()));
+        if (!inStream_.good())
+            throw std::runtime_error("Encountered unexpected EOF in restart file.");
+
+        if (BinaryRestartDetail::checksum(payload.data(), payload.size()) != expectedChecksum)
+            throw std::runtime_error("Section '"+cookie+"' of restart file '"+fileName_+"' is corrupted");
+
+        sectionInStream_.str(payload);
+        sectionInStream_.clear();
+    }
+
+    /*!
+     * \brief End of a section in the serialized output.
+     */
+    void deserializeSectionEnd()
+    {
+        char c;
+        while (sectionInStream_.get(c)) {
+            if (!std::isspace(c, std::locale::classic()))
+                throw std::logic_error("Encountered unread values while deserializing");
+        }
+    }
+
+    /*!
+     * \brief Deserialize all leaf entities of a codim in a grid.
+     *
+     * The actual work is done by Deserializer::deserialize(Entity)
+     */
+    template <int codim, class Deserializer, class GridView>
+    void deserializeEntities(Deserializer& deserializer, const GridView& gridView)
+    {
+        std::ostringstream oss;
+        oss << "Entities: Codim " << codim;
+        deserializeSectionBegin(oss.str());
+
+        using Iterator = typename GridView::template Codim<codim>::Iterator;
+        Iterator it = gridView.template begin<codim>();
+        const Iterator& endIt = gridView.template end<codim>();
+        for (; it != endIt; ++it) {
+            if (!sectionInStream_.good())
+                throw std::runtime_error("Restart file is corrupted");
+
+            deserializer.deserializeEntity(sectionInStream_, *it);
+        }
+
+        deserializeSectionEnd();
+    }
+
+    /*!
+     * \brief Stop reading the restart file.
+     */
+    void deserializeEnd()
+    { inStream_.close(); }
+
+private:
+    template <class T>
+    void writeRaw_(const T& value)
+    { outStream_->write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    template <class T>
+    T readRaw_()
+    {
+        T value;
+        inStream_.read(reinterpret_cast<char*>(&value), sizeof(T));
+        if (!inStream_.good())
+            throw std::runtime_error("Encountered unexpected EOF in restart file.");
+        return value;
+    }
+
+    std::string fileName_;
+    std::ifstream inStream_;
+    std::ofstream outFile_;
+    std::ostringstream outBuffer_;
+    std::ostream* outStream_ = &outFile_;
+
+    std::string sectionCookie_;
+    std::streampos sectionHeaderPos_;
+    BinaryRestartDetail::ChecksumStreamBuf sectionOutBuf_;
+    std::ostream sectionOutStream_;
+    std::istringstream sectionInStream_;
+};
+} // namespace Opm
+
+#endif
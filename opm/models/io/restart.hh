@@ -39,6 +39,9 @@ namespace Opm {
  */
 class Restart
 {
+    // the binary restart format uses the same file names and magic cookies
+    friend class BinaryRestart;
+
     /*!
      * \brief Create a magic cookie for restart files, so that it is
      *        unlikely to load a restart file for an incorrectly.
@@ -73,7 +76,8 @@ class Restart
     static const std::string restartFileName_(const GridView& gridView,
                                               const std::string& outputDir,
                                               const std::string& simName,
-                                              Scalar t)
+                                              Scalar t,
+                                              const std::string& extension = ".ers")
     {
         std::string dir = outputDir;
         if (dir == ".")
@@ -83,7 +87,7 @@ class Restart
 
         int rank = gridView.comm().rank();
         std::ostringstream oss;
-        oss << dir << simName << "_time=" << t << "_rank=" << rank << ".ers";
+        oss << dir << simName << "_time=" << t << "_rank=" << rank << extension;
         return oss.str();
     }
 
@@ -96,9 +100,13 @@ public:
 
     /*!
      * \brief Write the current state of the model to disk.
+     *
+     * \param simulator The simulator which ought to be serialized
+     * \param toMemory If true, the file is not written. Instead, the serialized data is
+     *                 kept in memory until it is retrieved using takeSerializedData().
      */
     template <class Simulator>
-    void serializeBegin(Simulator& simulator)
+    void serializeBegin(Simulator& simulator, bool toMemory = false)
     {
         const std::string magicCookie = magicRestartCookie_(simulator.gridView());
         fileName_ = restartFileName_(simulator.gridView(),
@@ -107,8 +115,15 @@ public:
                                      simulator.time());
 
         // open output file and write magic cookie
-        outStream_.open(fileName_.c_str());
-        outStream_.precision(20);
+        if (toMemory) {
+            outBuffer_.str("");
+            outStream_ = &outBuffer_;
+        }
+        else {
+            outFile_.open(fileName_.c_str());
+            outStream_ = &outFile_;
+        }
+        outStream_->precision(20);
 
         serializeSectionBegin(magicCookie);
         serializeSectionEnd();
@@ -118,19 +133,19 @@ public:
      * \brief The output stream to write the serialized data.
      */
     std::ostream& serializeStream()
-    { return outStream_; }
+    { return *outStream_; }
 
     /*!
      * \brief Start a new section in the serialized output.
      */
     void serializeSectionBegin(const std::string& cookie)
-    { outStream_ << cookie << "\n"; }
+    { *outStream_ << cookie << "\n"; }
 
     /*!
      * \brief End of a section in the serialized output.
      */
     void serializeSectionEnd()
-    { outStream_ << "\n"; }
+    { *outStream_ << "\n"; }
 
     /*!
      * \brief Serialize all leaf entities of a codim in a gridView.
@@ -151,8 +166,8 @@ public:
         Iterator it = gridView.template begin<codim>();
         const Iterator& endIt = gridView.template end<codim>();
         for (; it != endIt; ++it) {
-            serializer.serializeEntity(outStream_, *it);
-            outStream_ << "\n";
+            serializer.serializeEntity(*outStream_, *it);
+            *outStream_ << "\n";
         }
 
         serializeSectionEnd();
@@ -162,7 +177,23 @@ public:
      * \brief Finish the restart file.
      */
     void serializeEnd()
-    { outStream_.close(); }
+    {
+        if (outStream_ == &outFile_)
+            outFile_.close();
+    }
+
+    /*!
+     * \brief Returns the data which was serialized to memory and clears the buffer.
+     *
+     * This only makes sense if serializeBegin() was called with toMemory=true. The
+     * returned data is the content of the file returned by fileName().
+     */
+    std::string takeSerializedData()
+    {
+        std::string data = outBuffer_.str();
+        outBuffer_.str("");
+        return data;
+    }
 
     /*!
      * \brief Start reading a restart file at a certain simulated
@@ -268,7 +299,9 @@ public:
 private:
     std::string fileName_;
     std::ifstream inStream_;
-    std::ofstream outStream_;
+    std::ofstream outFile_;
+    std::ostringstream outBuffer_;
+    std::ostream* outStream_ = &outFile_;
 };
 } // namespace Opm
 
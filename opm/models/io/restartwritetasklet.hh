@@ -0,0 +1,92 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::RestartWriteTasklet
+ */
+#ifndef EWOMS_RESTART_WRITE_TASKLET_HH
+#define EWOMS_RESTART_WRITE_TASKLET_HH
+
+#include <opm/models/parallel/tasklets.hh>
+
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace Opm {
+
+/*!
+ * \brief Writes the data of a restart file which was serialized to memory.
+ *
+ * Since the tasklet runner only prints the exceptions thrown by tasklets, errors
+ * which occur while writing the file are kept and can be rethrown by the thread which
+ * dispatched the tasklet after the write has been completed.
+ */
+class RestartWriteTasklet : public TaskletInterface
+{
+public:
+    RestartWriteTasklet(const std::string& fileName, std::string&& data)
+        : fileName_(fileName)
+        , data_(std::move(data))
+    { }
+
+    void run() final
+    {
+        try {
+            std::ofstream os(fileName_.c_str(), std::ios::out | std::ios::binary);
+            os.write(data_.data(), static_cast<std::streamsize>(data_.size()));
+            os.close();
+            if (!os.good())
+                throw std::runtime_error("Could not write restart file '"+fileName_+"'");
+        }
+        catch (...) {
+            error_ = std::current_exception();
+        }
+
+        // free the memory of the serialized data as soon as possible
+        std::string().swap(data_);
+    }
+
+    /*!
+     * \brief Rethrow the exception which was thrown while writing the file.
+     *
+     * This must only be called after the tasklet has been run, i.e., after a
+     * barrier of the tasklet runner.
+     */
+    void rethrowError() const
+    {
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+private:
+    std::string fileName_;
+    std::string data_;
+    std::exception_ptr error_;
+};
+
+} // namespace Opm
+
+#endif
@@ -131,7 +131,7 @@ public:
      */
     void allocBuffers()
     {
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         if (!enableEnergy)
@@ -153,7 +153,7 @@ public:
      */
     void processElement(const ElementContext& elemCtx)
     {
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         if (!enableEnergy)
@@ -143,7 +143,7 @@ public:
      */
     void allocBuffers()
     {
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         if (!enablePolymer)
@@ -169,7 +169,7 @@ public:
      */
     void processElement(const ElementContext& elemCtx)
     {
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         if (!enablePolymer)
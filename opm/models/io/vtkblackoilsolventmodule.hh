@@ -129,7 +129,7 @@ public:
      */
     void allocBuffers()
     {
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         if (!enableSolvent)
@@ -151,7 +151,7 @@ public:
      */
     void processElement(const ElementContext& elemCtx)
     {
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         if (!enableSolvent)
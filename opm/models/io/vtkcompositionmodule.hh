@@ -101,6 +101,7 @@ class VtkCompositionModule : public BaseOutputModule<TypeTag>
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
 
     using GridView = GetPropType<TypeTag, Properties::GridView>;
 
@@ -168,64 +169,82 @@ public:
      */
     void processElement(const ElementContext& elemCtx)
     {
-        using Toolbox = Opm::MathToolbox<Evaluation>;
-
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         for (unsigned i = 0; i < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++i) {
             unsigned I = elemCtx.globalSpaceIndex(i, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(i, /*timeIdx=*/0);
-            const auto& fs = intQuants.fluidState();
-
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-                    if (moleFracOutput_())
-                        moleFrac_[phaseIdx][compIdx][I] = Toolbox::value(fs.moleFraction(phaseIdx, compIdx));
-                    if (massFracOutput_())
-                        massFrac_[phaseIdx][compIdx][I] = Toolbox::value(fs.massFraction(phaseIdx, compIdx));
-                    if (molarityOutput_())
-                        molarity_[phaseIdx][compIdx][I] = Toolbox::value(fs.molarity(phaseIdx, compIdx));
-
-                    if (fugacityCoeffOutput_())
-                        fugacityCoeff_[phaseIdx][compIdx][I] =
-                            Toolbox::value(fs.fugacityCoefficient(phaseIdx, compIdx));
-                }
-            }
+            processDof(I, elemCtx.intensiveQuantities(i, /*timeIdx=*/0));
+        }
+    }
+
+    /*!
+     * \brief Modify the internal buffers according to the intensive quantities of a
+     *        single degree of freedom
+     */
+    void processDof(unsigned I, const IntensiveQuantities& intQuants)
+    {
+        if (!this->enableVtkOutput_)
+            return;
 
+        using Toolbox = Opm::MathToolbox<Evaluation>;
+
+        const auto& fs = intQuants.fluidState();
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
-                if (totalMassFracOutput_()) {
-                    Scalar compMass = 0;
-                    Scalar totalMass = 0;
-                    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-                        totalMass += Toolbox::value(fs.density(phaseIdx)) * Toolbox::value(fs.saturation(phaseIdx));
-                        compMass +=
-                            Toolbox::value(fs.density(phaseIdx))
-                            *Toolbox::value(fs.saturation(phaseIdx))
-                            *Toolbox::value(fs.massFraction(phaseIdx, compIdx));
-                    }
-                    totalMassFrac_[compIdx][I] = compMass / totalMass;
+                if (moleFracOutput_())
+                    moleFrac_[phaseIdx][compIdx][I] = Toolbox::value(fs.moleFraction(phaseIdx, compIdx));
+                if (massFracOutput_())
+                    massFrac_[phaseIdx][compIdx][I] = Toolbox::value(fs.massFraction(phaseIdx, compIdx));
+                if (molarityOutput_())
+                    molarity_[phaseIdx][compIdx][I] = Toolbox::value(fs.molarity(phaseIdx, compIdx));
+
+                if (fugacityCoeffOutput_())
+                    fugacityCoeff_[phaseIdx][compIdx][I] =
+                        Toolbox::value(fs.fugacityCoefficient(phaseIdx, compIdx));
+            }
+        }
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            if (totalMassFracOutput_()) {
+                Scalar compMass = 0;
+                Scalar totalMass = 0;
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                    totalMass += Toolbox::value(fs.density(phaseIdx)) * Toolbox::value(fs.saturation(phaseIdx));
+                    compMass +=
+                        Toolbox::value(fs.density(phaseIdx))
+                        *Toolbox::value(fs.saturation(phaseIdx))
+                        *Toolbox::value(fs.massFraction(phaseIdx, compIdx));
                 }
-                if (totalMoleFracOutput_()) {
-                    Scalar compMoles = 0;
-                    Scalar totalMoles = 0;
-                    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-                        totalMoles +=
-                            Toolbox::value(fs.molarDensity(phaseIdx))
-                            *Toolbox::value(fs.saturation(phaseIdx));
-                        compMoles +=
-                            Toolbox::value(fs.molarDensity(phaseIdx))
-                            *Toolbox::value(fs.saturation(phaseIdx))
-                            *Toolbox::value(fs.moleFraction(phaseIdx, compIdx));
-                    }
-                    totalMoleFrac_[compIdx][I] = compMoles / totalMoles;
+                totalMassFrac_[compIdx][I] = compMass / totalMass;
+            }
+            if (totalMoleFracOutput_()) {
+                Scalar compMoles = 0;
+                Scalar totalMoles = 0;
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                    totalMoles +=
+                        Toolbox::value(fs.molarDensity(phaseIdx))
+                        *Toolbox::value(fs.saturation(phaseIdx));
+                    compMoles +=
+                        Toolbox::value(fs.molarDensity(phaseIdx))
+                        *Toolbox::value(fs.saturation(phaseIdx))
+                        *Toolbox::value(fs.moleFraction(phaseIdx, compIdx));
                 }
-                if (fugacityOutput_())
-                    fugacity_[compIdx][I] = Toolbox::value(intQuants.fluidState().fugacity(/*phaseIdx=*/0, compIdx));
+                totalMoleFrac_[compIdx][I] = compMoles / totalMoles;
             }
+            if (fugacityOutput_())
+                fugacity_[compIdx][I] = Toolbox::value(intQuants.fluidState().fugacity(/*phaseIdx=*/0, compIdx));
         }
     }
 
+    /*!
+     * \brief The composition only depends on the intensive quantities of the
+     *        individual degrees of freedom.
+     */
+    bool dofDataOnly() const
+    { return true; }
+
     /*!
      * \brief Add all buffers to the VTK output writer.
      */
@@ -190,7 +190,7 @@ public:
      */
     void processElement(const ElementContext& elemCtx)
     {
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         const auto& fractureMapper = elemCtx.simulator().vanguard().fractureMapper();
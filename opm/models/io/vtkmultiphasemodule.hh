@@ -131,6 +131,7 @@ class VtkMultiPhaseModule : public BaseOutputModule<TypeTag>
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
 
     using GridView = GetPropType<TypeTag, Properties::GridView>;
     using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
@@ -237,17 +238,13 @@ public:
      */
     void processElement(const ElementContext& elemCtx)
     {
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         const auto& problem = elemCtx.problem();
         for (unsigned i = 0; i < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++i) {
             unsigned I = elemCtx.globalSpaceIndex(i, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(i, /*timeIdx=*/0);
-            const auto& fs = intQuants.fluidState();
-
-            if (extrusionFactorOutput_()) extrusionFactor_[I] = intQuants.extrusionFactor();
-            if (porosityOutput_()) porosity_[I] = Opm::getValue(intQuants.porosity());
+            processDof(I, elemCtx.intensiveQuantities(i, /*timeIdx=*/0));
 
             if (intrinsicPermeabilityOutput_()) {
                 const auto& K = problem.intrinsicPermeability(elemCtx, i, /*timeIdx=*/0);
@@ -255,26 +252,6 @@ public:
                     for (unsigned colIdx = 0; colIdx < K.cols; ++colIdx)
                         intrinsicPermeability_[I][rowIdx][colIdx] = K[rowIdx][colIdx];
             }
-
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
-                    continue;
-                }
-                if (pressureOutput_())
-                    pressure_[phaseIdx][I] = Opm::getValue(fs.pressure(phaseIdx));
-                if (densityOutput_())
-                    density_[phaseIdx][I] = Opm::getValue(fs.density(phaseIdx));
-                if (saturationOutput_())
-                    saturation_[phaseIdx][I] = Opm::getValue(fs.saturation(phaseIdx));
-                if (mobilityOutput_())
-                    mobility_[phaseIdx][I] = Opm::getValue(intQuants.mobility(phaseIdx));
-                if (relativePermeabilityOutput_())
-                    relativePermeability_[phaseIdx][I] = Opm::getValue(intQuants.relativePermeability(phaseIdx));
-                if (viscosityOutput_())
-                    viscosity_[phaseIdx][I] = Opm::getValue(fs.viscosity(phaseIdx));
-                if (averageMolarMassOutput_())
-                    averageMolarMass_[phaseIdx][I] = Opm::getValue(fs.averageMolarMass(phaseIdx));
-            }
         }
 
         if (potentialGradientOutput_()) {
@@ -401,6 +378,54 @@ public:
         }
     }
 
+    /*!
+     * \brief Modify the internal buffers according to the intensive quantities of a
+     *        single degree of freedom
+     */
+    void processDof(unsigned I, const IntensiveQuantities& intQuants)
+    {
+        if (!this->enableVtkOutput_)
+            return;
+
+        const auto& fs = intQuants.fluidState();
+
+        if (extrusionFactorOutput_()) extrusionFactor_[I] = intQuants.extrusionFactor();
+        if (porosityOutput_()) porosity_[I] = Opm::getValue(intQuants.porosity());
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                continue;
+            }
+            if (pressureOutput_())
+                pressure_[phaseIdx][I] = Opm::getValue(fs.pressure(phaseIdx));
+            if (densityOutput_())
+                density_[phaseIdx][I] = Opm::getValue(fs.density(phaseIdx));
+            if (saturationOutput_())
+                saturation_[phaseIdx][I] = Opm::getValue(fs.saturation(phaseIdx));
+            if (mobilityOutput_())
+                mobility_[phaseIdx][I] = Opm::getValue(intQuants.mobility(phaseIdx));
+            if (relativePermeabilityOutput_())
+                relativePermeability_[phaseIdx][I] = Opm::getValue(intQuants.relativePermeability(phaseIdx));
+            if (viscosityOutput_())
+                viscosity_[phaseIdx][I] = Opm::getValue(fs.viscosity(phaseIdx));
+            if (averageMolarMassOutput_())
+                averageMolarMass_[phaseIdx][I] = Opm::getValue(fs.averageMolarMass(phaseIdx));
+        }
+    }
+
+    /*!
+     * \brief The intrinsic permeability, the velocities and the potential gradients
+     *        require the element context, everything else can be written using the
+     *        intensive quantities of the individual degrees of freedom.
+     */
+    bool dofDataOnly() const
+    {
+        return
+            !intrinsicPermeabilityOutput_()
+            && !velocityOutput_()
+            && !potentialGradientOutput_();
+    }
+
     /*!
      * \brief Returns true iff the module needs to access the extensive quantities of a
      * context to do its job.
@@ -31,6 +31,7 @@
 #include "vtkscalarfunction.hh"
 #include "vtkvectorfunction.hh"
 #include "vtktensorfunction.hh"
+#include "vtknativewriter.hh"
 
 #include <opm/models/io/baseoutputwriter.hh>
 #include <opm/models/parallel/tasklets.hh>
@@ -49,6 +50,7 @@
 #endif
 
 #include <list>
+#include <memory>
 #include <string>
 #include <limits>
 #include <sstream>
@@ -76,7 +78,9 @@ class VtkMultiWriter : public BaseOutputWriter
         {
             std::string fileName;
             // write the actual data as vtu or vtp (plus the pieces file in the parallel case)
-            if (multiWriter_.commSize_ > 1)
+            if (multiWriter_.nativeWriter_)
+                fileName = multiWriter_.nativeWriter_->write(/*name=*/multiWriter_.outputDir_ + "/" + multiWriter_.curOutFileName_);
+            else if (multiWriter_.commSize_ > 1)
                 fileName = multiWriter_.curWriter_->pwrite(/*name=*/multiWriter_.curOutFileName_,
                                                            /*path=*/multiWriter_.outputDir_,
                                                            /*extendPath=*/"",
@@ -113,13 +117,24 @@ public:
     using TensorBuffer = BaseOutputWriter::TensorBuffer;
 
     using VtkWriter = Dune::VTKWriter<GridView>;
+    using NativeWriter = Opm::VtkNativeWriter<GridView>;
     using FunctionPtr = std::shared_ptr< Dune::VTKFunction< GridView > >;
 
+    /*!
+     * \brief The constructor.
+     *
+     * If nativeWriting is true, the files are written by Opm::VtkNativeWriter in the
+     * "appended raw" format instead of using Dune::VTKWriter in the format specified by
+     * the vtkFormat template argument. Since the native writer only supports sequential
+     * runs of grids with a dimension larger than one, Dune::VTKWriter is used
+     * regardless of this argument in all other cases.
+     */
     VtkMultiWriter(bool asyncWriting,
                    const GridView& gridView,
                    const std::string& outputDir,
                    const std::string& simName = "",
-                   std::string multiFileName = "")
+                   std::string multiFileName = "",
+                   bool nativeWriting = false)
         : gridView_(gridView)
         , elementMapper_(gridView, Dune::mcmgElementLayout())
         , vertexMapper_(gridView, Dune::mcmgVertexLayout())
@@ -138,6 +153,9 @@ public:
 
         commRank_ = gridView.comm().rank();
         commSize_ = gridView.comm().size();
+
+        if (nativeWriting && commSize_ == 1 && dim > 1)
+            nativeWriter_.reset(new NativeWriter(gridView_, elementMapper_, vertexMapper_));
     }
 
     ~VtkMultiWriter()
@@ -167,6 +185,9 @@ public:
     {
         elementMapper_.update();
         vertexMapper_.update();
+
+        if (nativeWriter_)
+            nativeWriter_->invalidateGrid();
     }
 
     /*!
@@ -186,7 +207,8 @@ public:
         curTime_ = t;
         curOutFileName_ = fileName_();
 
-        curWriter_ = new VtkWriter(gridView_, Dune::VTK::conforming);
+        if (!nativeWriter_)
+            curWriter_ = new VtkWriter(gridView_, Dune::VTK::conforming);
         ++curWriterNum_;
     }
 
@@ -239,6 +261,11 @@ public:
     {
         sanitizeScalarBuffer_(buf);
 
+        if (nativeWriter_) {
+            nativeWriter_->addVertexData(buf, name);
+            return;
+        }
+
         using VtkFn = Opm::VtkScalarFunction<GridView, VertexMapper>;
         FunctionPtr fnPtr(new VtkFn(name,
                                     gridView_,
@@ -267,6 +294,11 @@ public:
     {
         sanitizeScalarBuffer_(buf);
 
+        if (nativeWriter_) {
+            nativeWriter_->addCellData(buf, name);
+            return;
+        }
+
         using VtkFn = Opm::VtkScalarFunction<GridView, ElementMapper>;
         FunctionPtr fnPtr(new VtkFn(name,
                                     gridView_,
@@ -296,6 +328,11 @@ public:
     {
         sanitizeVectorBuffer_(buf);
 
+        if (nativeWriter_) {
+            nativeWriter_->addVertexData(buf, name);
+            return;
+        }
+
         using VtkFn = Opm::VtkVectorFunction<GridView, VertexMapper>;
         FunctionPtr fnPtr(new VtkFn(name,
                                     gridView_,
@@ -316,6 +353,11 @@ public:
             std::ostringstream oss;
             oss << name <<  "[" << colIdx << "]";
 
+            if (nativeWriter_) {
+                nativeWriter_->addVertexData(buf, colIdx, oss.str());
+                continue;
+            }
+
             FunctionPtr fnPtr(new VtkFn(oss.str(),
                                         gridView_,
                                         vertexMapper_,
@@ -345,6 +387,11 @@ public:
     {
         sanitizeVectorBuffer_(buf);
 
+        if (nativeWriter_) {
+            nativeWriter_->addCellData(buf, name);
+            return;
+        }
+
         using VtkFn = Opm::VtkVectorFunction<GridView, ElementMapper>;
         FunctionPtr fnPtr(new VtkFn(name,
                                     gridView_,
@@ -365,6 +412,11 @@ public:
             std::ostringstream oss;
             oss << name <<  "[" << colIdx << "]";
 
+            if (nativeWriter_) {
+                nativeWriter_->addCellData(buf, colIdx, oss.str());
+                continue;
+            }
+
             FunctionPtr fnPtr(new VtkFn(oss.str(),
                                         gridView_,
                                         elementMapper_,
@@ -529,6 +581,8 @@ private:
         // discard managed objects and the current VTK writer
         delete curWriter_;
         curWriter_ = nullptr;
+        if (nativeWriter_)
+            nativeWriter_->clear();
         while (managedScalarBuffers_.begin() != managedScalarBuffers_.end()) {
             delete managedScalarBuffers_.front();
             managedScalarBuffers_.pop_front();
@@ -552,6 +606,7 @@ private:
     int commRank_; // rank of the current process in the communicator
 
     VtkWriter *curWriter_;
+    std::unique_ptr<NativeWriter> nativeWriter_;
     double curTime_;
     std::string curOutFileName_;
     int curWriterNum_;
@@ -0,0 +1,381 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::VtkNativeWriter
+ */
+#ifndef EWOMS_VTK_NATIVE_WRITER_HH
+#define EWOMS_VTK_NATIVE_WRITER_HH
+
+#include <opm/models/io/baseoutputwriter.hh>
+
+#include <dune/grid/io/file/vtk/common.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Writes unstructured grid VTK files directly from the output buffers.
+ *
+ * In contrast to Dune::VTKWriter, the fields are not evaluated via a virtual function
+ * call for each corner of each element. Instead, the buffers are streamed to the file
+ * as contiguous blocks of the "appended raw" VTK format. Since the fields are written
+ * in single precision, their values are converted in chunks of fixed size on the way,
+ * i.e., no copy of a whole field is made. Also, the points and the
+ * connectivity of the grid are only computed once and reused for all files written
+ * until invalidateGrid() is called.
+ *
+ * This writer only produces the output of a single process and is thus limited to
+ * sequential runs.
+ */
+template <class GridView>
+class VtkNativeWriter
+{
+    enum { dim = GridView::dimension };
+    enum { dimWorld = GridView::dimensionworld };
+
+    using Mapper = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
+
+    using ScalarBuffer = BaseOutputWriter::ScalarBuffer;
+    using VectorBuffer = BaseOutputWriter::VectorBuffer;
+    using TensorBuffer = BaseOutputWriter::TensorBuffer;
+
+    enum class FieldKind { scalar, vector, tensorColumn };
+
+    struct Field
+    {
+        std::string name;
+        FieldKind kind;
+        const void* buf;
+        unsigned numComponents;
+        unsigned tensorColumn;
+    };
+
+public:
+    VtkNativeWriter(const GridView& gridView,
+                    const Mapper& elementMapper,
+                    const Mapper& vertexMapper)
+        : gridView_(gridView)
+        , elementMapper_(elementMapper)
+        , vertexMapper_(vertexMapper)
+    { }
+
+    /*!
+     * \brief Discard the cached points and connectivity of the grid.
+     *
+     * This must be called if the grid was changed.
+     */
+    void invalidateGrid()
+    {
+        gridIsCached_ = false;
+        cellOrder_.clear();
+        pointsBlock_.clear();
+        connectivityBlock_.clear();
+        offsetsBlock_.clear();
+        typesBlock_.clear();
+    }
+
+    /*!
+     * \brief Remove all fields which were attached to the writer.
+     */
+    void clear()
+    {
+        pointFields_.clear();
+        cellFields_.clear();
+    }
+
+    void addVertexData(const ScalarBuffer& buf, const std::string& name)
+    { pointFields_.push_back(Field{name, FieldKind::scalar, &buf, 1, 0}); }
+
+    void addCellData(const ScalarBuffer& buf, const std::string& name)
+    { cellFields_.push_back(Field{name, FieldKind::scalar, &buf, 1, 0}); }
+
+    void addVertexData(const VectorBuffer& buf, const std::string& name)
+    { pointFields_.push_back(Field{name, FieldKind::vector, &buf, vectorComponents_(buf), 0}); }
+
+    void addCellData(const VectorBuffer& buf, const std::string& name)
+    { cellFields_.push_back(Field{name, FieldKind::vector, &buf, vectorComponents_(buf), 0}); }
+
+    void addVertexData(const TensorBuffer& buf, unsigned colIdx, const std::string& name)
+    { pointFields_.push_back(Field{name, FieldKind::tensorColumn, &buf, tensorComponents_(buf), colIdx}); }
+
+    void addCellData(const TensorBuffer& buf, unsigned colIdx, const std::string& name)
+    { cellFields_.push_back(Field{name, FieldKind::tensorColumn, &buf, tensorComponents_(buf), colIdx}); }
+
+    /*!
+     * \brief Write all attached fields to a file.
+     *
+     * \param name The name of the file without its extension
+     * \return The name of the written file
+     */
+    std::string write(const std::string& name)
+    {
+        if (!gridIsCached_)
+            updateGrid_();
+
+        const std::string fileName = name + ".vtu";
+        std::ofstream os(fileName.c_str(), std::ios::out | std::ios::binary);
+        if (!os.good())
+            throw std::runtime_error("Could not open VTK file '"+fileName+"'");
+
+        // the appended blocks consist of the size of their payload followed by the
+        // payload itself. since the offsets of the blocks must be known for the XML
+        // header, we need to figure out the sizes of all blocks first.
+        std::uint64_t offset = 0;
+        auto nextOffset = [&offset](std::uint64_t payloadSize) {
+            std::uint64_t result = offset;
+            offset += sizeof(std::uint64_t) + payloadSize;
+            return result;
+        };
+
+        os << "<?xml version=\"1.0\"?>\n"
+           << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+           << (isLittleEndian_() ? "LittleEndian" : "BigEndian")
+           << "\" header_type=\"UInt64\">\n"
+           << " <UnstructuredGrid>\n"
+           << "  <Piece NumberOfPoints=\"" << numPoints_ << "\" NumberOfCells=\"" << cellOrder_.size() << "\">\n";
+
+        os << "   <PointData>\n";
+        for (const auto& field : pointFields_)
+            writeArrayHeader_(os, "Float32", field.name, field.numComponents,
+                              nextOffset(numPoints_*field.numComponents*sizeof(float)));
+        os << "   </PointData>\n";
+
+        os << "   <CellData>\n";
+        for (const auto& field : cellFields_)
+            writeArrayHeader_(os, "Float32", field.name, field.numComponents,
+                              nextOffset(cellOrder_.size()*field.numComponents*sizeof(float)));
+        os << "   </CellData>\n";
+
+        os << "   <Points>\n";
+        writeArrayHeader_(os, "Float32", "Coordinates", 3, nextOffset(pointsBlock_.size()));
+        os << "   </Points>\n";
+
+        os << "   <Cells>\n";
+        writeArrayHeader_(os, "Int64", "connectivity", 1, nextOffset(connectivityBlock_.size()));
+        writeArrayHeader_(os, "Int64", "offsets", 1, nextOffset(offsetsBlock_.size()));
+        writeArrayHeader_(os, "UInt8", "types", 1, nextOffset(typesBlock_.size()));
+        os << "   </Cells>\n";
+
+        os << "  </Piece>\n"
+           << " </UnstructuredGrid>\n"
+           << " <AppendedData encoding=\"raw\">\n"
+           << "_";
+
+        for (const auto& field : pointFields_)
+            writeFieldBlock_(os, field, numPoints_, /*cellOrder=*/nullptr);
+        for (const auto& field : cellFields_)
+            writeFieldBlock_(os, field, cellOrder_.size(), &cellOrder_);
+
+        writeBlock_(os, pointsBlock_.data(), pointsBlock_.size());
+        writeBlock_(os, connectivityBlock_.data(), connectivityBlock_.size());
+        writeBlock_(os, offsetsBlock_.data(), offsetsBlock_.size());
+        writeBlock_(os, typesBlock_.data(), typesBlock_.size());
+
+        os << "\n </AppendedData>\n"
+           << "</VTKFile>\n";
+
+        if (!os.good())
+            throw std::runtime_error("Could not write VTK file '"+fileName+"'");
+
+        return fileName;
+    }
+
+private:
+    static bool isLittleEndian_()
+    {
+        const std::uint16_t tmp = 1;
+        return *reinterpret_cast<const unsigned char*>(&tmp) == 1;
+    }
+
+    // vectors with two components are padded to three, so that they are treated as
+    // vectors by the visualization tools. (this is what Dune::VTKWriter does as well.)
+    static unsigned vectorComponents_(const VectorBuffer& buf)
+    {
+        unsigned n = buf.empty() ? 1 : static_cast<unsigned>(buf[0].size());
+        return (n == 2) ? 3 : n;
+    }
+
+    static unsigned tensorComponents_(const TensorBuffer& buf)
+    {
+        unsigned n = buf.empty() ? 1 : static_cast<unsigned>(buf[0].M());
+        return (n == 2) ? 3 : n;
+    }
+
+    static void writeArrayHeader_(std::ostream& os,
+                                  const std::string& type,
+                                  const std::string& name,
+                                  unsigned numComponents,
+                                  std::uint64_t offset)
+    {
+        os << "    <DataArray type=\"" << type << "\" Name=\"" << name << "\""
+           << " NumberOfComponents=\"" << numComponents << "\""
+           << " format=\"appended\" offset=\"" << offset << "\"/>\n";
+    }
+
+    static void writeBlock_(std::ostream& os, const void* data, std::uint64_t size)
+    {
+        os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        os.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+
+    // write the block of a field. the values are converted to single precision in
+    // chunks of a fixed size which are streamed to the file, so that no copy of the
+    // whole field is required.
+    void writeFieldBlock_(std::ostream& os,
+                          const Field& field,
+                          size_t numEntities,
+                          const std::vector<unsigned>* cellOrder)
+    {
+        const unsigned numComp = field.numComponents;
+        std::uint64_t size = numEntities*numComp*sizeof(float);
+        os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+
+        for (size_t beginIdx = 0; beginIdx < numEntities; beginIdx += chunkSize_) {
+            size_t endIdx = std::min(beginIdx + chunkSize_, numEntities);
+            extractField_(chunk_, field, beginIdx, endIdx, cellOrder);
+            os.write(reinterpret_cast<const char*>(chunk_.data()),
+                     static_cast<std::streamsize>(chunk_.size()*sizeof(float)));
+        }
+    }
+
+    // copy the values of a range of entities of a field to a contiguous array of single
+    // precision numbers
+    static void extractField_(std::vector<float>& values,
+                              const Field& field,
+                              size_t beginIdx,
+                              size_t endIdx,
+                              const std::vector<unsigned>* cellOrder)
+    {
+        const unsigned numComp = field.numComponents;
+        values.assign((endIdx - beginIdx)*numComp, 0.0f);
+
+        for (size_t i = beginIdx; i < endIdx; ++i) {
+            size_t idx = cellOrder ? (*cellOrder)[i] : i;
+            float* dest = values.data() + (i - beginIdx)*numComp;
+
+            switch (field.kind) {
+            case FieldKind::scalar:
+                dest[0] = static_cast<float>((*static_cast<const ScalarBuffer*>(field.buf))[idx]);
+                break;
+
+            case FieldKind::vector: {
+                const auto& v = (*static_cast<const VectorBuffer*>(field.buf))[idx];
+                for (unsigned c = 0; c < v.size(); ++c)
+                    dest[c] = static_cast<float>(v[c]);
+                break;
+            }
+
+            case FieldKind::tensorColumn: {
+                const auto& t = (*static_cast<const TensorBuffer*>(field.buf))[idx];
+                for (unsigned c = 0; c < t.M(); ++c)
+                    dest[c] = static_cast<float>(t[c][field.tensorColumn]);
+                break;
+            }
+            }
+        }
+    }
+
+    template <class T>
+    static void appendRaw_(std::string& block, const T& value)
+    { block.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    // compute the points and the connectivity of the grid in the VTK format
+    void updateGrid_()
+    {
+        invalidateGrid();
+
+        // the points are numbered like the vertices
+        numPoints_ = vertexMapper_.size();
+        std::vector<float> coords(3*numPoints_, 0.0f);
+        const auto& vEndIt = gridView_.template end</*codim=*/dim>();
+        for (auto vIt = gridView_.template begin</*codim=*/dim>(); vIt != vEndIt; ++vIt) {
+            const auto& pos = vIt->geometry().corner(0);
+            size_t vIdx = static_cast<size_t>(vertexMapper_.index(*vIt));
+            for (unsigned k = 0; k < dimWorld; ++k)
+                coords[3*vIdx + k] = static_cast<float>(pos[k]);
+        }
+        pointsBlock_.assign(reinterpret_cast<const char*>(coords.data()), coords.size()*sizeof(float));
+
+        // the cells are written in the order in which they are visited by the grid
+        // iterator. since the cell data is indexed by the element mapper, we remember
+        // the mapping between the two.
+        std::int64_t numCorners = 0;
+        const auto& eEndIt = gridView_.template end</*codim=*/0>();
+        for (auto eIt = gridView_.template begin</*codim=*/0>(); eIt != eEndIt; ++eIt) {
+            const auto& elem = *eIt;
+            cellOrder_.push_back(static_cast<unsigned>(elementMapper_.index(elem)));
+
+            const Dune::GeometryType gt = elem.type();
+            const auto vtkType = Dune::VTK::geometryType(gt);
+            if (vtkType == Dune::VTK::polygon || vtkType == Dune::VTK::polyhedron)
+                throw std::logic_error("The native VTK writer does not support polygonal or "
+                                       "polyhedral elements");
+
+            unsigned n = static_cast<unsigned>(elem.subEntities(dim));
+            for (unsigned i = 0; i < n; ++i) {
+                unsigned duneCornerIdx = static_cast<unsigned>(Dune::VTK::renumber(gt, static_cast<int>(i)));
+                appendRaw_(connectivityBlock_,
+                           static_cast<std::int64_t>(vertexMapper_.subIndex(elem, duneCornerIdx, dim)));
+            }
+
+            numCorners += n;
+            appendRaw_(offsetsBlock_, numCorners);
+            appendRaw_(typesBlock_, static_cast<std::uint8_t>(vtkType));
+        }
+
+        gridIsCached_ = true;
+    }
+
+    const GridView gridView_;
+    const Mapper& elementMapper_;
+    const Mapper& vertexMapper_;
+
+    std::vector<Field> pointFields_;
+    std::vector<Field> cellFields_;
+
+    // the number of entities which are converted to single precision at once
+    static constexpr size_t chunkSize_ = 4096;
+    std::vector<float> chunk_;
+
+    // the cached description of the grid
+    bool gridIsCached_ = false;
+    size_t numPoints_ = 0;
+    std::vector<unsigned> cellOrder_;
+    std::string pointsBlock_;
+    std::string connectivityBlock_;
+    std::string offsetsBlock_;
+    std::string typesBlock_;
+};
+
+} // namespace Opm
+
+#endif
@@ -73,6 +73,7 @@ class VtkPrimaryVarsModule : public BaseOutputModule<TypeTag>
 
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
     using GridView = GetPropType<TypeTag, Properties::GridView>;
 
     static const int vtkFormat = getPropValue<TypeTag, Properties::VtkOutputFormat>();
@@ -122,7 +123,7 @@ public:
      */
     void processElement(const ElementContext& elemCtx)
     {
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         const auto& elementMapper = elemCtx.model().elementMapper();
@@ -132,18 +133,36 @@ public:
 
         for (unsigned i = 0; i < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++i) {
             unsigned I = elemCtx.globalSpaceIndex(i, /*timeIdx=*/0);
-            const auto& priVars = elemCtx.primaryVars(i, /*timeIdx=*/0);
+            processDof(I, elemCtx.intensiveQuantities(i, /*timeIdx=*/0));
+        }
+    }
+
+    /*!
+     * \brief Modify the internal buffers according to a single degree of freedom
+     */
+    void processDof(unsigned globalDofIdx, const IntensiveQuantities& intQuants OPM_UNUSED)
+    {
+        if (!this->enableVtkOutput_)
+            return;
+
+        const auto& priVars = this->simulator_.model().solution(/*timeIdx=*/0)[globalDofIdx];
 
-            if (dofIndexOutput_())
-                dofIndex_[I] = I;
+        if (dofIndexOutput_())
+            dofIndex_[globalDofIdx] = globalDofIdx;
 
-            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
-                if (primaryVarsOutput_() && !primaryVars_[eqIdx].empty())
-                    primaryVars_[eqIdx][I] = priVars[eqIdx];
-            }
+        for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+            if (primaryVarsOutput_() && !primaryVars_[eqIdx].empty())
+                primaryVars_[eqIdx][globalDofIdx] = priVars[eqIdx];
         }
     }
 
+    /*!
+     * \brief The process rank is the only quantity of this module which is associated
+     *        with the elements of the grid.
+     */
+    bool dofDataOnly() const
+    { return !processRankOutput_(); }
+
     /*!
      * \brief Add all buffers to the VTK output writer.
      */
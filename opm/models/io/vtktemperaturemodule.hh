@@ -69,6 +69,7 @@ class VtkTemperatureModule : public BaseOutputModule<TypeTag>
 
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
 
     using GridView = GetPropType<TypeTag, Properties::GridView>;
     using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
@@ -107,21 +108,38 @@ public:
      */
     void processElement(const ElementContext& elemCtx)
     {
-        using Toolbox = Opm::MathToolbox<Evaluation>;
-
-        if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+        if (!this->enableVtkOutput_)
             return;
 
         for (unsigned i = 0; i < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++i) {
             unsigned I = elemCtx.globalSpaceIndex(i, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(i, /*timeIdx=*/0);
-            const auto& fs = intQuants.fluidState();
-
-            if (temperatureOutput_())
-                temperature_[I] = Toolbox::value(fs.temperature(/*phaseIdx=*/0));
+            processDof(I, elemCtx.intensiveQuantities(i, /*timeIdx=*/0));
         }
     }
 
+    /*!
+     * \brief Modify the internal buffers according to the intensive quantities of a
+     *        single degree of freedom
+     */
+    void processDof(unsigned globalDofIdx, const IntensiveQuantities& intQuants)
+    {
+        if (!this->enableVtkOutput_)
+            return;
+
+        using Toolbox = Opm::MathToolbox<Evaluation>;
+
+        const auto& fs = intQuants.fluidState();
+        if (temperatureOutput_())
+            temperature_[globalDofIdx] = Toolbox::value(fs.temperature(/*phaseIdx=*/0));
+    }
+
+    /*!
+     * \brief The temperature only depends on the intensive quantities of the
+     *        individual degrees of freedom.
+     */
+    bool dofDataOnly() const
+    { return true; }
+
     /*!
      * \brief Add all buffers to the VTK output writer.
      */
@@ -105,12 +105,11 @@ public:
         ParentType::checkDefined();
 
         typename FluidSystem::template ParameterCache<Evaluation> paramCache;
-        const auto& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
 
         // set the phase saturations
         Evaluation sumSat = 0;
         for (unsigned phaseIdx = 0; phaseIdx < numPhases - 1; ++phaseIdx) {
-            const Evaluation& val = priVars.makeEvaluation(saturation0Idx + phaseIdx, timeIdx);
+            const Evaluation& val = elemCtx.makeEvaluation(dofIdx, saturation0Idx + phaseIdx, timeIdx);
             fluidState_.setSaturation(phaseIdx, val);
             sumSat += val;
         }
@@ -128,14 +127,14 @@ public:
         Evaluation capPress[numPhases];
         MaterialLaw::capillaryPressures(capPress, materialParams, fluidState_);
         // add to the pressure of the first fluid phase
-        const Evaluation& pressure0 = priVars.makeEvaluation(pressure0Idx, timeIdx);
+        const Evaluation& pressure0 = elemCtx.makeEvaluation(dofIdx, pressure0Idx, timeIdx);
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
             fluidState_.setPressure(phaseIdx, pressure0 + (capPress[phaseIdx] - capPress[0]));
 
         ComponentVector fug;
         // retrieve component fugacities
         for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
-            fug[compIdx] = priVars.makeEvaluation(fugacity0Idx + compIdx, timeIdx);
+            fug[compIdx] = elemCtx.makeEvaluation(dofIdx, fugacity0Idx + compIdx, timeIdx);
 
         // calculate phase compositions
         const auto *hint = elemCtx.thermodynamicHint(dofIdx, timeIdx);
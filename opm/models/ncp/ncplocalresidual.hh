@@ -138,7 +138,6 @@ public:
     {
         const auto& extQuants = elemCtx.extensiveQuantities(scvfIdx, timeIdx);
 
-        unsigned focusDofIdx = elemCtx.focusDofIndex();
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             // data attached to upstream and the downstream DOFs
             // of the current phase
@@ -148,7 +147,7 @@ public:
             // this is a bit hacky because it is specific to the element-centered
             // finite volume scheme. (N.B. that if finite differences are used to
             // linearize the system of equations, it does not matter.)
-            if (upIdx == focusDofIdx) {
+            if (elemCtx.isFocusDof(upIdx)) {
                 Evaluation tmp =
                     up.fluidState().molarDensity(phaseIdx)
                     * extQuants.volumeFlux(phaseIdx);
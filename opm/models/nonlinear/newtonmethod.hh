@@ -33,6 +33,7 @@
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/models/utils/timer.hh>
 #include <opm/models/utils/timerguard.hh>
+#include <opm/models/parallel/collectivebatch.hh>
 #include <opm/simulators/linalg/linalgproperties.hh>
 
 #include <opm/material/densead/Math.hpp>
@@ -45,8 +46,13 @@
 #include <dune/common/version.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <algorithm>
+#include <exception>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <type_traits>
+#include <utility>
 
 #include <unistd.h>
 
@@ -125,6 +131,21 @@ struct NewtonTargetIterations { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct NewtonMaxIterations { using type = UndefinedProperty; };
 
+/*!
+ * \brief Specifies whether the relative tolerance of the linear solver is adapted to
+ *        the progress of the Newton method.
+ *
+ * If this is enabled, the linear systems of the early Newton iterations are solved less
+ * accurately using the forcing terms of Eisenstat and Walker.
+ */
+template<class TypeTag, class MyTypeTag>
+struct NewtonAdaptiveLinearTolerance { using type = UndefinedProperty; };
+
+//! The largest relative tolerance which is passed to the linear solver if the
+//! tolerance is adapted to the progress of the Newton method
+template<class TypeTag, class MyTypeTag>
+struct NewtonMaxLinearTolerance { using type = UndefinedProperty; };
+
 // set default values for the properties
 template<class TypeTag>
 struct NewtonMethod<TypeTag, TTag::NewtonMethod> { using type = Opm::NewtonMethod<TypeTag>; };
@@ -152,10 +173,50 @@ template<class TypeTag>
 struct NewtonTargetIterations<TypeTag, TTag::NewtonMethod> { static constexpr int value = 10; };
 template<class TypeTag>
 struct NewtonMaxIterations<TypeTag, TTag::NewtonMethod> { static constexpr int value = 18; };
+template<class TypeTag>
+struct NewtonAdaptiveLinearTolerance<TypeTag, TTag::NewtonMethod> { static constexpr bool value = false; };
+template<class TypeTag>
+struct NewtonMaxLinearTolerance<TypeTag, TTag::NewtonMethod>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.1;
+};
 
 } // namespace Opm::Properties
 
 namespace Opm {
+namespace NewtonDetail {
+// detect whether a linear solver backend allows to specify the relative tolerance for
+// each linear solve
+template <class LinearSolverBackend, class = void>
+struct SupportsRelativeTolerance : std::false_type {};
+
+template <class LinearSolverBackend>
+struct SupportsRelativeTolerance<LinearSolverBackend,
+                                 std::void_t<decltype(std::declval<LinearSolverBackend&>().setRelativeTolerance(0.0)),
+                                             decltype(std::declval<const LinearSolverBackend&>().iterations())> >
+    : std::true_type {};
+
+// detect whether a linear solver backend reports the number of iterations of the last
+// linear solve
+template <class LinearSolverBackend, class = void>
+struct ReportsIterations : std::false_type {};
+
+template <class LinearSolverBackend>
+struct ReportsIterations<LinearSolverBackend,
+                         std::void_t<decltype(std::declval<const LinearSolverBackend&>().iterations())> >
+    : std::true_type {};
+
+// detect whether a linear solver backend keeps statistics about all of its linear solves
+template <class LinearSolverBackend, class = void>
+struct ProvidesSolverSummary : std::false_type {};
+
+template <class LinearSolverBackend>
+struct ProvidesSolverSummary<LinearSolverBackend,
+                             std::void_t<decltype(std::declval<const LinearSolverBackend&>().solverSummary())> >
+    : std::true_type {};
+} // namespace NewtonDetail
+
 /*!
  * \ingroup Newton
  * \brief The multi-dimensional Newton method.
@@ -190,13 +251,26 @@ public:
         , endIterMsgStream_(std::ostringstream::out)
         , linearSolver_(simulator)
         , comm_(Dune::MPIHelper::getCommunicator())
+        , collectives_(comm_)
         , convergenceWriter_(asImp_())
     {
         lastError_ = 1e100;
         error_ = 1e100;
         tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonTolerance);
 
+        // the remaining parameters are used in each iteration, so we retrieve them only
+        // once
+        newtonVerbose_ = EWOMS_GET_PARAM(TypeTag, bool, NewtonVerbose);
+        newtonWriteConvergence_ = EWOMS_GET_PARAM(TypeTag, bool, NewtonWriteConvergence);
+        newtonMaxError_ = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxError);
+        newtonTargetIterations_ = EWOMS_GET_PARAM(TypeTag, int, NewtonTargetIterations);
+        newtonMaxIterations_ = EWOMS_GET_PARAM(TypeTag, int, NewtonMaxIterations);
+        adaptiveLinearTolerance_ = EWOMS_GET_PARAM(TypeTag, bool, NewtonAdaptiveLinearTolerance);
+        maxLinearTolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxLinearTolerance);
+
         numIterations_ = 0;
+        linearTolerance_ = maxLinearTolerance_;
+        numLinearIterations_ = 0;
     }
 
     /*!
@@ -225,6 +299,12 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonMaxError,
                              "The maximum error tolerated by the Newton "
                              "method to which does not cause an abort");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, NewtonAdaptiveLinearTolerance,
+                             "Adapt the relative tolerance of the linear solver to the "
+                             "reduction of the error of the Newton method (Eisenstat-Walker)");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonMaxLinearTolerance,
+                             "The largest relative tolerance of the linear solver if it is "
+                             "adapted to the progress of the Newton method");
     }
 
     /*!
@@ -329,6 +409,9 @@ public:
 
         Opm::TimerGuard prePostProcessTimerGuard(prePostProcessTimer_);
 
+        // make sure that no values of an aborted solve are reduced
+        collectives_.clear();
+
         // tell the implementation that we begin solving
         prePostProcessTimer_.start();
         asImp_().begin_(nextSolution);
@@ -364,11 +447,15 @@ public:
                 linearizeTimer_.start();
                 asImp_().linearizeDomain_();
                 asImp_().linearizeAuxiliaryEquations_();
+
+                // make sure that the pre-processing and the linearization succeeded on
+                // all processes before the linear solver exchanges data with its peers
+                collectives_.sync();
                 linearizeTimer_.stop();
 
                 solveTimer_.start();
                 auto& residual = linearizer.residual();
-                const auto& jacobian = linearizer.jacobian();
+                auto& jacobian = linearizer.jacobian();
                 linearSolver_.prepare(jacobian, residual);
                 linearSolver_.setResidual(residual);
                 linearSolver_.getResidual(residual);
@@ -405,8 +492,10 @@ public:
                 // solve A x = b, where b is the residual, A is its Jacobian and x is the
                 // update of the solution
                 linearSolver_.setMatrix(jacobian);
+                asImp_().updateLinearTolerance_();
                 solutionUpdate = 0.0;
                 bool converged = linearSolver_.solve(solutionUpdate);
+                asImp_().recordLinearIterations_();
                 solveTimer_.stop();
 
                 if (!converged) {
@@ -497,6 +586,19 @@ public:
                       << updateTimer_.realTimeElapsed() << "("
                       << 100 * updateTimer_.realTimeElapsed()/elapsedTot << "%)"
                       << "\n" << std::flush;
+            if (NewtonDetail::ReportsIterations<LinearSolverBackend>::value) {
+                std::cout << "Linear iterations: " << numLinearIterations_;
+                if (adaptiveLinearTolerance_ && linearToleranceSupported_())
+                    std::cout << " (using adaptive tolerances)";
+                std::cout << "\n" << std::flush;
+            }
+            if constexpr (NewtonDetail::ProvidesSolverSummary<LinearSolverBackend>::value) {
+                const auto& summary = linearSolver_.solverSummary();
+                if (summary.numMixedPrecisionSolves() > 0)
+                    std::cout << "Mixed precision linear solves so far: "
+                              << summary.numMixedPrecisionSolves() << " (fell back to full precision: "
+                              << summary.numPrecisionFallbacks() << ")\n" << std::flush;
+            }
         }
 
 
@@ -550,6 +652,16 @@ public:
     std::ostringstream& endIterMsg()
     { return endIterMsgStream_; }
 
+    /*!
+     * \brief Returns the batch of collective operations of the current Newton iteration.
+     *
+     * Values which need to be reduced over all processes can be added to this batch.
+     * The Newton method synchronizes the batch after the linearization, after the error
+     * has been computed and at the end of each iteration.
+     */
+    CollectiveBatch& collectives()
+    { return collectives_; }
+
     /*!
      * \brief Causes the solve() method to discared the structure of the linear system of
      *        equations the next time it is called.
@@ -587,7 +699,7 @@ protected:
      */
     bool verbose_() const
     {
-        return EWOMS_GET_PARAM(TypeTag, bool, NewtonVerbose) && (comm_.rank() == 0);
+        return newtonVerbose_ && (comm_.rank() == 0);
     }
 
     /*!
@@ -599,8 +711,10 @@ protected:
     void begin_(const SolutionVector& u  OPM_UNUSED)
     {
         numIterations_ = 0;
+        linearTolerance_ = maxLinearTolerance_;
+        numLinearIterations_ = 0;
 
-        if (EWOMS_GET_PARAM(TypeTag, bool, NewtonWriteConvergence))
+        if (newtonWriteConvergence_)
             convergenceWriter_.beginTimeStep();
     }
 
@@ -611,7 +725,8 @@ protected:
     {
         // start with a clean message stream
         endIterMsgStream_.str("");
-        const auto& comm = simulator_.gridView().comm();
+        collectives_.resetNumSyncs();
+
         bool succeeded = true;
         try {
             problem().beginIteration();
@@ -624,10 +739,8 @@ protected:
                       << "\n"  << std::flush;
         }
 
-        succeeded = comm.min(succeeded);
-
-        if (!succeeded)
-            throw Opm::NumericalIssue("pre processing of the problem failed");
+        // whether all processes succeeded is checked together with the linearization
+        collectives_.addStatus(succeeded, "pre processing of the problem failed");
 
         lastError_ = error_;
     }
@@ -638,50 +751,158 @@ protected:
      */
     void linearizeDomain_()
     {
-        model().linearizer().linearizeDomain();
+        model().linearizer().linearizeDomain(collectives_);
     }
 
     void linearizeAuxiliaryEquations_()
     {
-        model().linearizer().linearizeAuxiliaryEquations();
+        model().linearizer().linearizeAuxiliaryEquations(collectives_);
         model().linearizer().finalize();
     }
 
     void preSolve_(const SolutionVector& currentSolution  OPM_UNUSED,
                    const GlobalEqVector& currentResidual)
     {
-        const auto& constraintsMap = model().linearizer().constraintsMap();
         lastError_ = error_;
-        Scalar newtonMaxError = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxError);
-
-        // calculate the error as the maximum weighted tolerance of
-        // the solution's residual
-        error_ = 0;
-        for (unsigned dofIdx = 0; dofIdx < currentResidual.size(); ++dofIdx) {
-            // do not consider auxiliary DOFs for the error
-            if (dofIdx >= model().numGridDof() || model().dofTotalVolume(dofIdx) <= 0.0)
-                continue;
-
-            // also do not consider DOFs which are constraint
-            if (enableConstraints_()) {
-                if (constraintsMap.count(dofIdx) > 0)
-                    continue;
+        Scalar newtonMaxError = newtonMaxError_;
+
+        // take the other processes into account. the residual must have been
+        // synchronized with the peer processes by the linear solver at this point, so
+        // the error cannot be reduced together with the status of the linearization.
+        Scalar localError = asImp_().localError_(currentResidual);
+        collectives_.addMax(static_cast<double>(localError),
+                            [this, newtonMaxError](double globalError)
+                            {
+                                error_ = globalError;
+
+                                // make sure that the error never grows beyond the
+                                // maximum allowed one
+                                if (error_ > newtonMaxError)
+                                    throw Opm::NumericalIssue("Newton: Error "+std::to_string(double(error_))
+                                                              +" is larger than maximum allowed error of "
+                                                              +std::to_string(double(newtonMaxError)));
+                            });
+        collectives_.sync();
+    }
+
+    /*!
+     * \brief Pass the relative tolerance of the next linear solve to the linear solver.
+     *
+     * If the NewtonAdaptiveLinearTolerance parameter is enabled, the tolerance is
+     * determined using "choice 2" of Eisenstat and Walker (SIAM J. Sci. Comput. 17,
+     * 1996): eta_k = gamma*(error_k/error_k-1)^alpha with gamma = 0.9 and alpha = 2. If
+     * the tolerance of the previous iteration was large, eta_k is not allowed to
+     * become much smaller than gamma*eta_k-1^alpha. Also, the tolerance is not made
+     * smaller than what is required to reach the tolerance of the Newton method, and
+     * it is never larger than NewtonMaxLinearTolerance. The linear solver is expected to
+     * never use a tolerance which is smaller than its own configured one.
+     */
+    void updateLinearTolerance_()
+    {
+        if constexpr (NewtonDetail::SupportsRelativeTolerance<LinearSolverBackend>::value) {
+            if (!adaptiveLinearTolerance_)
+                return;
+
+            const Scalar gamma = 0.9;
+            Scalar eta = maxLinearTolerance_;
+            if (numIterations_ > 0 && lastError_ > 0.0) {
+                Scalar ratio = error_/lastError_;
+                eta = gamma*ratio*ratio;
+
+                // safeguard against tolerances which decrease too quickly
+                Scalar etaSafe = gamma*linearTolerance_*linearTolerance_;
+                if (etaSafe > 0.1)
+                    eta = std::max(eta, etaSafe);
+
+                // do not solve more accurately than required to reach the tolerance of
+                // the Newton method
+                if (error_ > 0.0)
+                    eta = std::max(eta, Scalar(0.5*tolerance()/error_));
+
+                eta = std::min(eta, maxLinearTolerance_);
             }
 
-            const auto& r = currentResidual[dofIdx];
-            for (unsigned eqIdx = 0; eqIdx < r.size(); ++eqIdx)
-                error_ = Opm::max(std::abs(r[eqIdx] * model().eqWeight(dofIdx, eqIdx)), error_);
+            linearTolerance_ = eta;
+            linearSolver_.setRelativeTolerance(linearTolerance_);
+            endIterMsg() << ", linear tolerance=" << linearTolerance_;
         }
+    }
 
-        // take the other processes into account
-        error_ = comm_.max(error_);
+    /*!
+     * \brief Keep track of the number of iterations of the linear solver.
+     */
+    void recordLinearIterations_()
+    {
+        if constexpr (NewtonDetail::ReportsIterations<LinearSolverBackend>::value) {
+            int numIterations = static_cast<int>(linearSolver_.iterations());
+            numLinearIterations_ += numIterations;
+            endIterMsg() << ", linear iterations=" << numIterations;
+        }
+    }
 
-        // make sure that the error never grows beyond the maximum
-        // allowed one
-        if (error_ > newtonMaxError)
-            throw Opm::NumericalIssue("Newton: Error "+std::to_string(double(error_))
-                                        +" is larger than maximum allowed error of "
-                                        +std::to_string(double(newtonMaxError)));
+    static constexpr bool linearToleranceSupported_()
+    { return NewtonDetail::SupportsRelativeTolerance<LinearSolverBackend>::value; }
+
+    /*!
+     * \brief Returns the error of the solution on the local process.
+     *
+     * By default, this is the maximum weighted residual of all equations.
+     */
+    Scalar localError_(const GlobalEqVector& currentResidual) const
+    { return maxWeightedResidual_(currentResidual, [](unsigned) { return true; }); }
+
+    /*!
+     * \brief Returns the maximum of the weighted residual of the local grid DOFs.
+     *
+     * Auxiliary DOFs, DOFs without volume and constraint DOFs are not considered. The
+     * work is distributed over all threads, each of which computes its own maximum.
+     *
+     * \param currentResidual The residual of the current solution
+     * \param considerEq A functor which returns true if the equation with a given index
+     *                   is to be considered
+     */
+    template <class EqFilter>
+    Scalar maxWeightedResidual_(const GlobalEqVector& currentResidual,
+                                const EqFilter& considerEq) const
+    {
+        const auto& linearizer = model().linearizer();
+        int numGridDof = static_cast<int>(std::min(currentResidual.size(), model().numGridDof()));
+
+        Scalar error = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            Scalar threadError = 0.0;
+#ifdef _OPENMP
+#pragma omp for schedule(static) nowait
+#endif
+            for (int i = 0; i < numGridDof; ++i) {
+                unsigned dofIdx = static_cast<unsigned>(i);
+
+                // do not consider DOFs without volume for the error
+                if (model().dofTotalVolume(dofIdx) <= 0.0)
+                    continue;
+
+                // also do not consider DOFs which are constraint
+                if (enableConstraints_() && linearizer.isConstraintDof(dofIdx))
+                    continue;
+
+                const auto& r = currentResidual[dofIdx];
+                for (unsigned eqIdx = 0; eqIdx < r.size(); ++eqIdx) {
+                    if (!considerEq(eqIdx))
+                        continue;
+                    threadError = Opm::max(std::abs(r[eqIdx] * model().eqWeight(dofIdx, eqIdx)), threadError);
+                }
+            }
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            error = Opm::max(error, threadError);
+        }
+
+        return error;
     }
 
     /*!
@@ -703,7 +924,6 @@ protected:
         // loop over the auxiliary modules and ask them to post process the solution
         // vector.
         auto& model = simulator_.model();
-        const auto& comm = simulator_.gridView().comm();
         for (unsigned i = 0; i < model.numAuxiliaryModules(); ++i) {
             auto& auxMod = *model.auxiliaryModule(i);
 
@@ -719,10 +939,8 @@ protected:
                           << "\n"  << std::flush;
             }
 
-            succeeded = comm.min(succeeded);
-
-            if (!succeeded)
-                throw Opm::NumericalIssue("post processing of an auxilary equation failed");
+            // this is checked at the end of the iteration
+            collectives_.addStatus(succeeded, "post processing of an auxilary equation failed");
         }
     }
 
@@ -745,7 +963,8 @@ protected:
                  const GlobalEqVector& solutionUpdate,
                  const GlobalEqVector& currentResidual)
     {
-        const auto& constraintsMap = model().linearizer().constraintsMap();
+        const auto& linearizer = model().linearizer();
+        const auto& constraintsMap = linearizer.constraintsMap();
 
         // first, write out the current solution to make convergence
         // analysis possible
@@ -755,33 +974,46 @@ protected:
         if (!std::isfinite(solutionUpdate.one_norm()))
             throw Opm::NumericalIssue("Non-finite update!");
 
-        size_t numGridDof = model().numGridDof();
-        for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
-            if (enableConstraints_()) {
-                if (constraintsMap.count(dofIdx) > 0) {
-                    const auto& constraints = constraintsMap.at(dofIdx);
-                    asImp_().updateConstraintDof_(dofIdx,
-                                                  nextSolution[dofIdx],
+        // the primary variables of the degrees of freedom are updated independently
+        // of each other, so this can be done by all threads. (this requires the
+        // updatePrimaryVariables_() method of the concrete Newton method to be thread
+        // safe.)
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+        int numGridDof = static_cast<int>(model().numGridDof());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
+            // if an exception occurs in the parallel block, it won't escape the block, so
+            // we tuck it away and rethrow it after the loop
+            try {
+                unsigned globalDofIdx = static_cast<unsigned>(dofIdx);
+                if (enableConstraints_() && linearizer.isConstraintDof(globalDofIdx)) {
+                    const auto& constraints = constraintsMap.at(globalDofIdx);
+                    asImp_().updateConstraintDof_(globalDofIdx,
+                                                  nextSolution[globalDofIdx],
                                                   constraints);
                 }
                 else
-                    asImp_().updatePrimaryVariables_(dofIdx,
-                                                     nextSolution[dofIdx],
-                                                     currentSolution[dofIdx],
-                                                     solutionUpdate[dofIdx],
-                                                     currentResidual[dofIdx]);
+                    asImp_().updatePrimaryVariables_(globalDofIdx,
+                                                     nextSolution[globalDofIdx],
+                                                     currentSolution[globalDofIdx],
+                                                     solutionUpdate[globalDofIdx],
+                                                     currentResidual[globalDofIdx]);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> take(exceptionLock);
+                exceptionPtr = std::current_exception();
             }
-            else
-                asImp_().updatePrimaryVariables_(dofIdx,
-                                                 nextSolution[dofIdx],
-                                                 currentSolution[dofIdx],
-                                                 solutionUpdate[dofIdx],
-                                                 currentResidual[dofIdx]);
         }
 
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+
         // update the DOFs of the auxiliary equations
         size_t numDof = model().numTotalDof();
-        for (size_t dofIdx = numGridDof; dofIdx < numDof; ++dofIdx) {
+        for (size_t dofIdx = static_cast<size_t>(numGridDof); dofIdx < numDof; ++dofIdx) {
             nextSolution[dofIdx] = currentSolution[dofIdx];
             nextSolution[dofIdx] -= solutionUpdate[dofIdx];
         }
@@ -817,7 +1049,7 @@ protected:
     void writeConvergence_(const SolutionVector& currentSolution,
                            const GlobalEqVector& solutionUpdate)
     {
-        if (EWOMS_GET_PARAM(TypeTag, bool, NewtonWriteConvergence)) {
+        if (newtonWriteConvergence_) {
             convergenceWriter_.beginIteration();
             convergenceWriter_.writeFields(currentSolution, solutionUpdate);
             convergenceWriter_.endIteration();
@@ -835,7 +1067,6 @@ protected:
     {
         ++numIterations_;
 
-        const auto& comm = simulator_.gridView().comm();
         bool succeeded = true;
         try {
             problem().endIteration();
@@ -848,18 +1079,34 @@ protected:
                       << "\n"  << std::flush;
         }
 
-        succeeded = comm.min(succeeded);
+        collectives_.addStatus(succeeded, "post processing of the problem failed");
 
-        if (!succeeded)
-            throw Opm::NumericalIssue("post processing of the problem failed");
+        // let the implementation add its own values before everything which was
+        // gathered during the update of the solution is reduced using a single
+        // collective operation
+        asImp_().endIterationLocal_();
+        collectives_.sync();
 
         if (asImp_().verbose_()) {
             std::cout << "Newton iteration " << numIterations_ << ""
                       << " error: " << error_
-                      << endIterMsg().str() << "\n" << std::flush;
+                      << endIterMsg().str()
+                      << ", collectives=" << collectives_.numSyncs()
+                      << "\n" << std::flush;
         }
     }
 
+    /*!
+     * \brief Process the result of a Newton iteration on the local process.
+     *
+     * This is called by endIteration_() after the problem has post-processed the
+     * iteration, but before the values of the iteration are reduced over all
+     * processes. Implementations can thus add their own values to the batch of
+     * collective operations.
+     */
+    void endIterationLocal_()
+    { }
+
     /*!
      * \brief Returns true iff another Newton iteration should be done.
      */
@@ -889,7 +1136,7 @@ protected:
      */
     void end_()
     {
-        if (EWOMS_GET_PARAM(TypeTag, bool, NewtonWriteConvergence))
+        if (newtonWriteConvergence_)
             convergenceWriter_.endTimeStep();
     }
 
@@ -911,10 +1158,10 @@ protected:
 
     // optimal number of iterations we want to achieve
     int targetIterations_() const
-    { return EWOMS_GET_PARAM(TypeTag, int, NewtonTargetIterations); }
+    { return newtonTargetIterations_; }
     // maximum number of iterations we do before giving up
     int maxIterations_() const
-    { return EWOMS_GET_PARAM(TypeTag, int, NewtonMaxIterations); }
+    { return newtonMaxIterations_; }
 
     static bool enableConstraints_()
     { return getPropValue<TypeTag, Properties::EnableConstraints>(); }
@@ -932,9 +1179,23 @@ protected:
     Scalar lastError_;
     Scalar tolerance_;
 
+    bool newtonVerbose_;
+    bool newtonWriteConvergence_;
+    Scalar newtonMaxError_;
+    int newtonTargetIterations_;
+    int newtonMaxIterations_;
+
     // actual number of iterations done so far
     int numIterations_;
 
+    // the relative tolerance of the linear solver (Eisenstat-Walker)
+    bool adaptiveLinearTolerance_;
+    Scalar maxLinearTolerance_;
+    Scalar linearTolerance_;
+
+    // the number of linear iterations of the current Newton solve
+    int numLinearIterations_;
+
     // the linear solver
     LinearSolverBackend linearSolver_;
 
@@ -942,6 +1203,9 @@ protected:
     // or MPI)
     CollectiveCommunication comm_;
 
+    // the values which need to be reduced over all processes in the current iteration
+    CollectiveBatch collectives_;
+
     // the object which writes the convergence behaviour of the Newton
     // method to disk
     ConvergenceWriter convergenceWriter_;
@@ -0,0 +1,145 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::ChunkScheduler
+ */
+#ifndef EWOMS_CHUNK_SCHEDULER_HH
+#define EWOMS_CHUNK_SCHEDULER_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Hands out contiguous chunks of an index range to the threads of a parallel
+ *        region.
+ *
+ * The index range [0, size) is initially split into one contiguous slice per thread.
+ * Each thread takes chunks from the front of its own slice and, once this is exhausted,
+ * steals chunks from the slices of the other threads. All bookkeeping is done using
+ * atomic counters, i.e., no locks are involved.
+ *
+ * Usage example:
+ *
+ * \code
+ * Opm::ChunkScheduler scheduler(numElements, numThreads, chunkSize);
+ * #pragma omp parallel
+ * {
+ *     size_t begin, end;
+ *     while (scheduler.nextChunk(threadId, begin, end)) {
+ *         for (size_t idx = begin; idx < end; ++idx)
+ *             doSomething(idx);
+ *     }
+ * }
+ * \endcode
+ *
+ * ATTENTION: This class must be instantiated in a sequential context!
+ */
+class ChunkScheduler
+{
+    // each slice gets its own cache line to avoid false sharing between the threads
+    struct alignas(64) Slice_
+    {
+        std::atomic<size_t> next;
+        size_t end;
+    };
+
+public:
+    /*!
+     * \brief Create a scheduler for the index range [0, size).
+     *
+     * \param size The number of indices to be handed out
+     * \param numThreads The maximum number of threads which take part in the loop
+     * \param chunkSize The number of consecutive indices which are handed out at once
+     */
+    ChunkScheduler(size_t size, unsigned numThreads, size_t chunkSize)
+        : slices_(std::max(numThreads, 1u))
+        , chunkSize_(std::max<size_t>(chunkSize, 1))
+    {
+        size_t numSlices = slices_.size();
+        for (size_t sliceIdx = 0; sliceIdx < numSlices; ++sliceIdx) {
+            slices_[sliceIdx].next = (size*sliceIdx)/numSlices;
+            slices_[sliceIdx].end = (size*(sliceIdx + 1))/numSlices;
+        }
+    }
+
+    ChunkScheduler(const ChunkScheduler&) = delete;
+
+    /*!
+     * \brief Retrieve the next chunk of indices which ought to be processed by a thread.
+     *
+     * If there is no work left, false is returned. Otherwise, the chunk is given by the
+     * half-open range [begin, end).
+     *
+     * \param threadId The index of the calling thread
+     */
+    bool nextChunk(unsigned threadId, size_t& begin, size_t& end)
+    {
+        size_t numSlices = slices_.size();
+        for (size_t i = 0; i < numSlices; ++i) {
+            // start with the thread's own slice, then try to steal from the others
+            Slice_& slice = slices_[(threadId + i) % numSlices];
+            if (slice.next.load(std::memory_order_relaxed) >= slice.end)
+                continue;
+
+            size_t first = slice.next.fetch_add(chunkSize_, std::memory_order_relaxed);
+            if (first < slice.end) {
+                begin = first;
+                end = std::min(first + chunkSize_, slice.end);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*!
+     * \brief Make sure that no further chunks are handed out.
+     *
+     * Chunks which have already been handed out are not affected by this.
+     */
+    void setFinished()
+    {
+        for (auto& slice : slices_)
+            slice.next.store(slice.end, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Returns the number of indices which are handed out at once.
+     */
+    size_t chunkSize() const
+    { return chunkSize_; }
+
+private:
+    std::vector<Slice_> slices_;
+    size_t chunkSize_;
+};
+
+} // namespace Opm
+
+#endif
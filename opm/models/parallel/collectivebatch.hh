@@ -0,0 +1,317 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::CollectiveBatch
+ */
+#ifndef EWOMS_COLLECTIVE_BATCH_HH
+#define EWOMS_COLLECTIVE_BATCH_HH
+
+#include <opm/material/common/Exceptions.hpp>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Gathers status flags, maxima and sums which need to be reduced over all
+ *        processes and reduces all of them using a single collective operation.
+ *
+ * The values are registered using addStatus(), addMax() and addSum(). The reduction is
+ * done by sync(). After the reduction, the results for the maxima and the sums are
+ * passed to the functors which were specified when the values were registered. If the
+ * status of any registered operation was negative on any process, sync() throws an
+ * Opm::NumericalIssue exception on all processes instead.
+ *
+ * Note that all processes must register the same values in the same order.
+ *
+ * Usage example:
+ *
+ * \code
+ * Opm::CollectiveBatch collectives(gridView.comm());
+ * collectives.addStatus(succeeded, "Linearization failed");
+ * collectives.addMax(localError, [&](double e) { error = e; });
+ * collectives.addSum(numSwitched, [&](double n) { totalSwitched = n; });
+ * collectives.sync();
+ * \endcode
+ */
+class CollectiveBatch
+{
+public:
+    using ResultFunctor = std::function<void(double)>;
+
+    /*!
+     * \brief Create a batch for the processes of a communicator.
+     *
+     * The communicator can either be a raw MPI communicator or a Dune collective
+     * communication object. If it is not based on MPI, no communication takes place.
+     */
+    template <class Communicator>
+    explicit CollectiveBatch(const Communicator& comm)
+        : numSyncs_(0)
+    {
+#if HAVE_MPI
+        if constexpr (std::is_convertible<Communicator, MPI_Comm>::value)
+            comm_ = comm;
+        else
+            comm_ = MPI_COMM_SELF;
+        commSize_ = -1;
+        op_ = MPI_OP_NULL;
+        bufferType_ = MPI_DATATYPE_NULL;
+        bufferTypeSize_ = 0;
+#endif // HAVE_MPI
+    }
+
+    CollectiveBatch(const CollectiveBatch&) = delete;
+    CollectiveBatch& operator=(const CollectiveBatch&) = delete;
+
+    ~CollectiveBatch()
+    {
+#if HAVE_MPI
+        int finalized;
+        MPI_Finalized(&finalized);
+        if (finalized)
+            return;
+
+        if (bufferType_ != MPI_DATATYPE_NULL)
+            MPI_Type_free(&bufferType_);
+        if (op_ != MPI_OP_NULL)
+            MPI_Op_free(&op_);
+#endif // HAVE_MPI
+    }
+
+    /*!
+     * \brief Register the status of an operation.
+     *
+     * \param succeeded True if the operation was successful on the local process
+     * \param failureMessage The message of the exception which is thrown by sync() if
+     *                       the operation failed on any process
+     */
+    void addStatus(bool succeeded, const std::string& failureMessage)
+    {
+        statusFailed_.push_back(succeeded ? 0.0 : 1.0);
+        failureMessages_.push_back(failureMessage);
+    }
+
+    /*!
+     * \brief Register a value of which the maximum over all processes is required.
+     */
+    void addMax(double value, const ResultFunctor& resultFunctor)
+    {
+        maxValues_.push_back(value);
+        maxFunctors_.push_back(resultFunctor);
+    }
+
+    /*!
+     * \brief Register a value of which the sum over all processes is required.
+     */
+    void addSum(double value, const ResultFunctor& resultFunctor)
+    {
+        sumValues_.push_back(value);
+        sumFunctors_.push_back(resultFunctor);
+    }
+
+    /*!
+     * \brief Returns true if no values are registered.
+     */
+    bool empty() const
+    { return statusFailed_.empty() && maxValues_.empty() && sumValues_.empty(); }
+
+    /*!
+     * \brief Reduce all registered values over all processes using a single collective
+     *        operation and pass the results to the functors.
+     *
+     * Afterwards, the batch is empty. If no values are registered, no communication
+     * takes place.
+     */
+    void sync()
+    {
+        if (empty())
+            return;
+
+        // the buffer starts with the number of entries which are reduced by taking the
+        // maximum. (the status flags are reduced by taking the maximum of "failed".)
+        // this is followed by the entries which are summed up.
+        size_t numMax = statusFailed_.size() + maxValues_.size();
+        buffer_.resize(1 + numMax + sumValues_.size());
+        buffer_[0] = static_cast<double>(numMax);
+        auto bufIt = buffer_.begin() + 1;
+        bufIt = std::copy(statusFailed_.begin(), statusFailed_.end(), bufIt);
+        bufIt = std::copy(maxValues_.begin(), maxValues_.end(), bufIt);
+        std::copy(sumValues_.begin(), sumValues_.end(), bufIt);
+
+        allreduce_();
+        ++numSyncs_;
+
+        // move the registered functors out of the way before calling them, so that they
+        // may register values for the next synchronization
+        std::vector<std::string> failureMessages;
+        std::vector<ResultFunctor> maxFunctors;
+        std::vector<ResultFunctor> sumFunctors;
+        failureMessages.swap(failureMessages_);
+        maxFunctors.swap(maxFunctors_);
+        sumFunctors.swap(sumFunctors_);
+        size_t numStatus = statusFailed_.size();
+        statusFailed_.clear();
+        maxValues_.clear();
+        sumValues_.clear();
+
+        for (size_t i = 0; i < numStatus; ++i)
+            if (buffer_[1 + i] > 0.0)
+                throw Opm::NumericalIssue(failureMessages[i]);
+
+        for (size_t i = 0; i < maxFunctors.size(); ++i)
+            if (maxFunctors[i])
+                maxFunctors[i](buffer_[1 + numStatus + i]);
+
+        for (size_t i = 0; i < sumFunctors.size(); ++i)
+            if (sumFunctors[i])
+                sumFunctors[i](buffer_[1 + numMax + i]);
+    }
+
+    /*!
+     * \brief Discard all registered values without communicating.
+     *
+     * This must only be done if all processes do it at the same time.
+     */
+    void clear()
+    {
+        statusFailed_.clear();
+        failureMessages_.clear();
+        maxValues_.clear();
+        maxFunctors_.clear();
+        sumValues_.clear();
+        sumFunctors_.clear();
+    }
+
+    /*!
+     * \brief Returns the number of collective operations done by sync() since the last
+     *        call to resetNumSyncs().
+     */
+    unsigned numSyncs() const
+    { return numSyncs_; }
+
+    /*!
+     * \brief Reset the counter for the collective operations.
+     */
+    void resetNumSyncs()
+    { numSyncs_ = 0; }
+
+private:
+    void allreduce_()
+    {
+#if HAVE_MPI
+        if (commSize_ < 0) {
+            int initialized;
+            MPI_Initialized(&initialized);
+            if (!initialized)
+                return;
+
+            MPI_Comm_size(comm_, &commSize_);
+        }
+
+        if (commSize_ == 1)
+            return;
+
+        // the reduction operation is created on first use and the data type is only
+        // re-created if the size of the buffer changes, which usually only happens
+        // during the first iterations.
+        if (op_ == MPI_OP_NULL)
+            MPI_Op_create(&CollectiveBatch::reduce_, /*commute=*/1, &op_);
+
+        // the whole buffer is a single element of a contiguous data type. this makes
+        // sure that MPI does not split it into segments, so the reduction function
+        // always sees the header.
+        if (bufferTypeSize_ != buffer_.size()) {
+            if (bufferType_ != MPI_DATATYPE_NULL)
+                MPI_Type_free(&bufferType_);
+            MPI_Type_contiguous(static_cast<int>(buffer_.size()), MPI_DOUBLE, &bufferType_);
+            MPI_Type_commit(&bufferType_);
+            bufferTypeSize_ = buffer_.size();
+        }
+
+        MPI_Allreduce(MPI_IN_PLACE,
+                      buffer_.data(),
+                      /*count=*/1,
+                      bufferType_,
+                      op_,
+                      comm_);
+#endif // HAVE_MPI
+    }
+
+#if HAVE_MPI
+    static void reduce_(void* inBuf, void* inOutBuf, int* len, MPI_Datatype* dataType)
+    {
+        int typeSize;
+        MPI_Type_size(*dataType, &typeSize);
+        size_t bufferSize = static_cast<size_t>(typeSize)/sizeof(double);
+
+        const double* in = static_cast<const double*>(inBuf);
+        double* inOut = static_cast<double*>(inOutBuf);
+        for (int elemIdx = 0; elemIdx < *len; ++elemIdx) {
+            size_t numMax = static_cast<size_t>(inOut[0]);
+            assert(numMax == static_cast<size_t>(in[0]));
+            for (size_t i = 1; i < 1 + numMax; ++i)
+                // this also propagates NaNs
+                if (!(in[i] <= inOut[i]))
+                    inOut[i] = in[i];
+            for (size_t i = 1 + numMax; i < bufferSize; ++i)
+                inOut[i] += in[i];
+
+            in += bufferSize;
+            inOut += bufferSize;
+        }
+    }
+#endif // HAVE_MPI
+
+    std::vector<double> statusFailed_;
+    std::vector<std::string> failureMessages_;
+    std::vector<double> maxValues_;
+    std::vector<ResultFunctor> maxFunctors_;
+    std::vector<double> sumValues_;
+    std::vector<ResultFunctor> sumFunctors_;
+
+    std::vector<double> buffer_;
+    unsigned numSyncs_;
+
+#if HAVE_MPI
+    MPI_Comm comm_;
+    int commSize_;
+    MPI_Op op_;
+    MPI_Datatype bufferType_;
+    size_t bufferTypeSize_;
+#endif // HAVE_MPI
+};
+
+} // namespace Opm
+
+#endif
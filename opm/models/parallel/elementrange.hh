@@ -0,0 +1,111 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::ElementRange
+ */
+#ifndef EWOMS_ELEMENT_RANGE_HH
+#define EWOMS_ELEMENT_RANGE_HH
+
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief A flat list of the codim-0 entities of a grid view which allows random access.
+ *
+ * Iterating over a Dune grid view is inherently sequential. To allow multiple threads to
+ * work on disjoint parts of the grid without having to synchronize the iteration, this
+ * class stores the seeds of all elements of a grid view in an array. The array is only
+ * rebuilt if the sequence number of the grid changes, i.e., if the grid was adapted or
+ * re-distributed.
+ *
+ * This class is usually used in conjunction with Opm::ChunkScheduler.
+ */
+template <class GridView>
+class ElementRange
+{
+public:
+    using Grid = typename GridView::Grid;
+    using Element = typename GridView::template Codim<0>::Entity;
+    using ElementSeed = typename Element::EntitySeed;
+
+    ElementRange()
+        : grid_(nullptr)
+        , sequenceNumber_(-1)
+    { }
+
+    /*!
+     * \brief Build the list of element seeds unless it is already up to date.
+     *
+     * ATTENTION: This method must be called in a sequential context!
+     *
+     * \param gridView The grid view of which the elements ought to be considered
+     * \param sequenceNumber The number of times the grid has been changed
+     */
+    void update(const GridView& gridView, int sequenceNumber)
+    {
+        if (grid_ == &gridView.grid()
+            && sequenceNumber == sequenceNumber_
+            && static_cast<size_t>(gridView.size(/*codim=*/0)) == seeds_.size())
+            return;
+
+        grid_ = &gridView.grid();
+        seeds_.clear();
+        seeds_.reserve(static_cast<size_t>(gridView.size(/*codim=*/0)));
+        auto elemIt = gridView.template begin</*codim=*/0>();
+        const auto& elemEndIt = gridView.template end</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++elemIt)
+            seeds_.push_back(elemIt->seed());
+
+        sequenceNumber_ = sequenceNumber;
+    }
+
+    /*!
+     * \brief Returns the number of elements in the range.
+     */
+    size_t size() const
+    { return seeds_.size(); }
+
+    /*!
+     * \brief Returns the seed of the element with a given position in the range.
+     */
+    const ElementSeed& seed(size_t idx) const
+    { return seeds_[idx]; }
+
+    /*!
+     * \brief Returns the element with a given position in the range.
+     */
+    Element element(size_t idx) const
+    { return grid_->entity(seeds_[idx]); }
+
+private:
+    const Grid* grid_;
+    std::vector<ElementSeed> seeds_;
+    int sequenceNumber_;
+};
+
+} // namespace Opm
+
+#endif
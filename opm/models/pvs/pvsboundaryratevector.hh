@@ -90,7 +90,6 @@ public:
         ExtensiveQuantities extQuants;
         extQuants.updateBoundary(context, bfIdx, timeIdx, fluidState);
         const auto& insideIntQuants = context.intensiveQuantities(bfIdx, timeIdx);
-        unsigned focusDofIdx = context.focusDofIndex();
         unsigned interiorDofIdx = context.interiorScvIndex(bfIdx, timeIdx);
 
         ////////
@@ -100,12 +99,12 @@ public:
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             Evaluation density;
             if (fluidState.pressure(phaseIdx) > insideIntQuants.fluidState().pressure(phaseIdx)) {
-                if (focusDofIdx == interiorDofIdx)
+                if (context.isFocusDof(interiorDofIdx))
                     density = fluidState.density(phaseIdx);
                 else
                     density = Opm::getValue(fluidState.density(phaseIdx));
             }
-            else if (focusDofIdx == interiorDofIdx)
+            else if (context.isFocusDof(interiorDofIdx))
                 density = insideIntQuants.fluidState().density(phaseIdx);
             else
                 density = Opm::getValue(insideIntQuants.fluidState().density(phaseIdx));
@@ -113,12 +112,12 @@ public:
             for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
                 Evaluation molarity;
                 if (fluidState.pressure(phaseIdx) > insideIntQuants.fluidState().pressure(phaseIdx)) {
-                    if (focusDofIdx == interiorDofIdx)
+                    if (context.isFocusDof(interiorDofIdx))
                         molarity = fluidState.molarity(phaseIdx, compIdx);
                     else
                         molarity = Opm::getValue(fluidState.molarity(phaseIdx, compIdx));
                 }
-                else if (focusDofIdx == interiorDofIdx)
+                else if (context.isFocusDof(interiorDofIdx))
                     molarity = insideIntQuants.fluidState().molarity(phaseIdx, compIdx);
                 else
                     molarity = Opm::getValue(insideIntQuants.fluidState().molarity(phaseIdx, compIdx));
@@ -131,12 +130,12 @@ public:
             if (enableEnergy) {
                 Evaluation specificEnthalpy;
                 if (fluidState.pressure(phaseIdx) > insideIntQuants.fluidState().pressure(phaseIdx)) {
-                    if (focusDofIdx == interiorDofIdx)
+                    if (context.isFocusDof(interiorDofIdx))
                         specificEnthalpy = fluidState.enthalpy(phaseIdx);
                     else
                         specificEnthalpy = Opm::getValue(fluidState.enthalpy(phaseIdx));
                 }
-                else if (focusDofIdx == interiorDofIdx)
+                else if (context.isFocusDof(interiorDofIdx))
                     specificEnthalpy = insideIntQuants.fluidState().enthalpy(phaseIdx);
                 else
                     specificEnthalpy = Opm::getValue(insideIntQuants.fluidState().enthalpy(phaseIdx));
@@ -118,7 +118,12 @@ public:
         /////////////
         Evaluation sumSat = 0.0;
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            fluidState_.setSaturation(phaseIdx, priVars.explicitSaturationValue(phaseIdx, timeIdx));
+            // non-present phases have saturation 0, the one of the lowest present phase
+            // is given implicitly
+            Evaluation Salpha = 0.0;
+            if (priVars.phaseIsPresent(phaseIdx) && phaseIdx != priVars.lowestPresentPhaseIdx())
+                Salpha = elemCtx.makeEvaluation(dofIdx, switch0Idx + phaseIdx - 1, timeIdx);
+            fluidState_.setSaturation(phaseIdx, Salpha);
             Opm::Valgrind::CheckDefined(fluidState_.saturation(phaseIdx));
             sumSat += fluidState_.saturation(phaseIdx);
         }
@@ -137,7 +142,7 @@ public:
         MaterialLaw::capillaryPressures(pC, materialParams, fluidState_);
 
         // set the absolute phase pressures in the fluid state
-        const Evaluation& p0 = priVars.makeEvaluation(pressure0Idx, timeIdx);
+        const Evaluation& p0 = elemCtx.makeEvaluation(dofIdx, pressure0Idx, timeIdx);
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
             fluidState_.setPressure(phaseIdx, p0 + (pC[phaseIdx] - pC[0]));
 
@@ -159,7 +164,7 @@ public:
             // contain the complete composition of the phase
             Evaluation sumx = 0.0;
             for (unsigned compIdx = 1; compIdx < numComponents; ++compIdx) {
-                const Evaluation& x = priVars.makeEvaluation(switch0Idx + compIdx - 1, timeIdx);
+                const Evaluation& x = elemCtx.makeEvaluation(dofIdx, switch0Idx + compIdx - 1, timeIdx);
                 fluidState_.setMoleFraction(lowestPresentPhaseIdx, compIdx, x);
                 sumx += x;
             }
@@ -190,7 +195,7 @@ public:
 
                 if (!priVars.phaseIsPresent(switchPhaseIdx)) {
                     auxConstraints[auxIdx].set(lowestPresentPhaseIdx, compIdx,
-                                               priVars.makeEvaluation(switch0Idx + switchIdx, timeIdx));
+                                               elemCtx.makeEvaluation(dofIdx, switch0Idx + switchIdx, timeIdx));
                     ++auxIdx;
                 }
             }
@@ -198,7 +203,7 @@ public:
             for (; auxIdx < numAuxConstraints; ++auxIdx, ++switchIdx) {
                 unsigned compIdx = numPhases - numNonPresentPhases + auxIdx;
                 auxConstraints[auxIdx].set(lowestPresentPhaseIdx, compIdx,
-                                           priVars.makeEvaluation(switch0Idx + switchIdx, timeIdx));
+                                           elemCtx.makeEvaluation(dofIdx, switch0Idx + switchIdx, timeIdx));
             }
 
             // both phases are present, i.e. phase compositions are a result of the the
@@ -51,7 +51,9 @@
 #include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
 #include <opm/material/common/Exceptions.hpp>
 
+#include <exception>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -258,6 +260,7 @@ class PvsModel
     using PrimaryVariables = GetPropType<TypeTag, Properties::PrimaryVariables>;
     using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using Stencil = GetPropType<TypeTag, Properties::Stencil>;
     using Indices = GetPropType<TypeTag, Properties::Indices>;
 
     enum { numPhases = getPropValue<TypeTag, Properties::NumPhases>() };
@@ -266,7 +269,6 @@ class PvsModel
     enum { enableEnergy = getPropValue<TypeTag, Properties::EnableEnergy>() };
 
     using Element = typename GridView::template Codim<0>::Entity;
-    using ElementIterator = typename GridView::template Codim<0>::Iterator;
 
     using EnergyModule = Opm::EnergyModule<TypeTag, enableEnergy>;
 
@@ -276,6 +278,7 @@ public:
     {
         verbosity_ = EWOMS_GET_PARAM(TypeTag, int, PvsVerbosity);
         numSwitched_ = 0;
+        dofOwnersSeqNum_ = -1;
     }
 
     /*!
@@ -487,79 +490,116 @@ public:
      * \brief Do the primary variable switching after a Newton iteration.
      *
      * This is an internal method that needs to be public because it
-     * gets called by the Newton method after an update.
+     * gets called by the Newton method after an update. Whether all processes succeeded
+     * and the total number of switched DOFs are determined when the Newton method
+     * synchronizes its collective operations.
      */
     void switchPrimaryVars_()
     {
         numSwitched_ = 0;
 
-        int succeeded;
+        bool succeeded;
         try {
-            std::vector<bool> visited(this->numGridDof(), false);
-            ElementContext elemCtx(this->simulator_);
-
-            ElementIterator elemIt = this->gridView_.template begin<0>();
-            ElementIterator elemEndIt = this->gridView_.template end<0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const Element& elem = *elemIt;
-                if (elem.partitionType() != Dune::InteriorEntity)
-                    continue;
-                elemCtx.updateStencil(elem);
-
-                size_t numLocalDof = elemCtx.stencil(/*timeIdx=*/0).numPrimaryDof();
-                for (unsigned dofIdx = 0; dofIdx < numLocalDof; ++dofIdx) {
-                    unsigned globalIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-
-                    if (visited[globalIdx])
-                        continue;
-                    visited[globalIdx] = true;
-
-                    // compute the intensive quantities of the current degree of freedom
-                    auto& priVars = this->solution(/*timeIdx=*/0)[globalIdx];
-                    elemCtx.updateIntensiveQuantities(priVars, dofIdx, /*timeIdx=*/0);
-                    const IntensiveQuantities& intQuants = elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
-
-                    // evaluate primary variable switch
-                    short oldPhasePresence = priVars.phasePresence();
-
-                    // set the primary variables and the new phase state
-                    // from the current fluid state
-                    priVars.assignNaive(intQuants.fluidState());
-
-                    if (oldPhasePresence != priVars.phasePresence()) {
-                        if (verbosity_ > 1)
-                            printSwitchedPhases_(elemCtx,
-                                                 dofIdx,
-                                                 intQuants.fluidState(),
-                                                 oldPhasePresence,
-                                                 priVars);
-                        ++numSwitched_;
+            updateDofOwners_();
+
+            // to avoid a race condition if two threads handle an exception at the same
+            // time, we use an explicit lock to control access to the exception storage
+            // object amongst thread-local handlers
+            std::mutex exceptionLock;
+            std::exception_ptr exceptionPtr = nullptr;
+            std::mutex printLock;
+
+            // each degree of freedom is handled by the interior element which "owns"
+            // it. the loop is over the degrees of freedom, so no DOF is visited twice.
+            const auto& elemRange = this->elementRange();
+            int numGridDof = static_cast<int>(dofOwners_.size());
+            unsigned numSwitched = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+: numSwitched)
+#endif
+            {
+                // Attention: the variables below are thread specific and thus cannot be
+                // moved in front of the #pragma!
+                ElementContext elemCtx(this->simulator_);
+                int curElemIdx = -1;
+                try {
+#ifdef _OPENMP
+#pragma omp for schedule(static) nowait
+#endif
+                    for (int globalIdx = 0; globalIdx < numGridDof; ++globalIdx) {
+                        const auto& owner = dofOwners_[static_cast<size_t>(globalIdx)];
+                        if (owner.elemIdx < 0)
+                            continue; // not a DOF of an interior element
+
+                        // the DOFs of an element are usually numbered consecutively, so
+                        // the stencil can mostly be recycled
+                        if (owner.elemIdx != curElemIdx) {
+                            const Element elem = elemRange.element(static_cast<size_t>(owner.elemIdx));
+                            elemCtx.updatePrimaryStencil(elem);
+                            curElemIdx = owner.elemIdx;
+                        }
+                        unsigned dofIdx = owner.localDofIdx;
+
+                        // compute the intensive quantities of the current degree of
+                        // freedom. the cache cannot be used here because the primary
+                        // variables have just been updated by the Newton method.
+                        auto& priVars = this->solution(/*timeIdx=*/0)[static_cast<unsigned>(globalIdx)];
+                        elemCtx.updateIntensiveQuantities(priVars, dofIdx, /*timeIdx=*/0);
+                        const IntensiveQuantities* intQuants = &elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
+
+                        // evaluate primary variable switch
+                        short oldPhasePresence = priVars.phasePresence();
+
+                        // set the primary variables and the new phase state
+                        // from the current fluid state
+                        priVars.assignNaive(intQuants->fluidState());
+
+                        if (oldPhasePresence != priVars.phasePresence()) {
+                            if (verbosity_ > 1) {
+                                std::lock_guard<std::mutex> lock(printLock);
+                                printSwitchedPhases_(elemCtx,
+                                                     dofIdx,
+                                                     intQuants->fluidState(),
+                                                     oldPhasePresence,
+                                                     priVars);
+                            }
+                            ++numSwitched;
+                        }
                     }
                 }
-            }
+                catch (...) {
+                    std::lock_guard<std::mutex> take(exceptionLock);
+                    exceptionPtr = std::current_exception();
+                }
+            } // parallel block
+
+            if (exceptionPtr)
+                std::rethrow_exception(exceptionPtr);
 
-            succeeded = 1;
+            numSwitched_ = numSwitched;
+            succeeded = true;
         }
         catch (...)
         {
             std::cout << "rank " << this->simulator_.gridView().comm().rank()
                       << " caught an exception during primary variable switching"
                       << "\n"  << std::flush;
-            succeeded = 0;
+            succeeded = false;
         }
-        succeeded = this->simulator_.gridView().comm().min(succeeded);
 
-        if (!succeeded)
-            throw Opm::NumericalIssue("A process did not succeed in adapting the primary variables");
-
-        // make sure that if there was a variable switch in an
-        // other partition we will also set the switch flag
-        // for our partition.
-        numSwitched_ = this->gridView_.comm().sum(numSwitched_);
-
-        if (verbosity_ > 0)
-            this->simulator_.model().newtonMethod().endIterMsg()
-                << ", num switched=" << numSwitched_;
+        // make sure that if there was a variable switch in an other partition we will
+        // also set the switch flag for our partition. this is done by the Newton method
+        // together with its other collective operations at the end of the iteration.
+        auto& newtonMethod = this->simulator_.model().newtonMethod();
+        auto& collectives = newtonMethod.collectives();
+        collectives.addStatus(succeeded, "A process did not succeed in adapting the primary variables");
+        collectives.addSum(numSwitched_,
+                           [this, &newtonMethod](double totalSwitched)
+                           {
+                               numSwitched_ = static_cast<unsigned>(totalSwitched);
+                               if (verbosity_ > 0)
+                                   newtonMethod.endIterMsg() << ", num switched=" << numSwitched_;
+                           });
     }
 
     template <class FluidState>
@@ -600,6 +640,37 @@ public:
         std::cout << "\n"  << std::flush;
     }
 
+    // determine the interior element which is responsible for the primary variable
+    // switch of each degree of freedom. this only needs to be done if the grid changes.
+    void updateDofOwners_()
+    {
+        int seqNum = this->simulator_.vanguard().gridSequenceNumber();
+        if (dofOwnersSeqNum_ == seqNum && dofOwners_.size() == this->numGridDof())
+            return;
+
+        dofOwners_.assign(this->numGridDof(), DofOwner_{-1, 0});
+
+        const auto& elemRange = this->elementRange();
+        Stencil stencil(this->gridView_, this->dofMapper());
+        for (size_t elemIdx = 0; elemIdx < elemRange.size(); ++elemIdx) {
+            const Element elem = elemRange.element(elemIdx);
+            if (elem.partitionType() != Dune::InteriorEntity)
+                continue;
+
+            stencil.updatePrimaryTopology(elem);
+            for (unsigned dofIdx = 0; dofIdx < stencil.numPrimaryDof(); ++dofIdx) {
+                auto& owner = dofOwners_[stencil.globalSpaceIndex(dofIdx)];
+                if (owner.elemIdx >= 0)
+                    continue;
+
+                owner.elemIdx = static_cast<int>(elemIdx);
+                owner.localDofIdx = dofIdx;
+            }
+        }
+
+        dofOwnersSeqNum_ = seqNum;
+    }
+
     void registerOutputModules_()
     {
         ParentType::registerOutputModules_();
@@ -619,6 +690,16 @@ public:
     // iteration
     unsigned numSwitched_;
 
+    // the element index and the local index within this element of each DOF which
+    // is used for the primary variable switch. (-1 for DOFs of non-interior elements.)
+    struct DofOwner_
+    {
+        int elemIdx;
+        unsigned localDofIdx;
+    };
+    std::vector<DofOwner_> dofOwners_;
+    int dofOwnersSeqNum_;
+
     // verbosity of the model
     int verbosity_;
 };
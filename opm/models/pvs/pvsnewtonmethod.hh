@@ -121,14 +121,10 @@ protected:
     }
 
     /*!
-     * \copydoc NewtonMethod::endIteration_
+     * \copydoc NewtonMethod::endIterationLocal_
      */
-    void endIteration_(SolutionVector& uCurrentIter,
-                       const SolutionVector& uLastIter)
-    {
-        ParentType::endIteration_(uCurrentIter, uLastIter);
-        this->problem().model().switchPrimaryVars_();
-    }
+    void endIterationLocal_()
+    { this->problem().model().switchPrimaryVars_(); }
 
     void clampValue_(Scalar& val, Scalar minVal, Scalar maxVal) const
     { val = std::max(minVal, std::min(val, maxVal)); }
@@ -84,7 +84,6 @@ public:
         ExtensiveQuantities extQuants;
         extQuants.updateBoundary(context, bfIdx, timeIdx, fluidState);
         const auto& insideIntQuants = context.intensiveQuantities(bfIdx, timeIdx);
-        unsigned focusDofIdx = context.focusDofIndex();
         unsigned interiorDofIdx = context.interiorScvIndex(bfIdx, timeIdx);
 
         ////////
@@ -95,12 +94,12 @@ public:
         unsigned phaseIdx = liquidPhaseIdx;
         Evaluation density;
         if (fluidState.pressure(phaseIdx) > insideIntQuants.fluidState().pressure(phaseIdx)) {
-            if (focusDofIdx == interiorDofIdx)
+            if (context.isFocusDof(interiorDofIdx))
                 density = fluidState.density(phaseIdx);
             else
                 density = Opm::getValue(fluidState.density(phaseIdx));
         }
-        else if (focusDofIdx == interiorDofIdx)
+        else if (context.isFocusDof(interiorDofIdx))
             density = insideIntQuants.fluidState().density(phaseIdx);
         else
             density = Opm::getValue(insideIntQuants.fluidState().density(phaseIdx));
@@ -95,7 +95,6 @@ public:
         const auto& problem = elemCtx.problem();
         const typename MaterialLaw::Params& materialParams =
             problem.materialLawParams(elemCtx, dofIdx, timeIdx);
-        const auto& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
 
         /////////
         // calculate the pressures
@@ -110,7 +109,7 @@ public:
         // non-wetting pressure can be larger than the
         // reference pressure if the medium is fully
         // saturated by the wetting phase
-        const Evaluation& pW = priVars.makeEvaluation(pressureWIdx, timeIdx);
+        const Evaluation& pW = elemCtx.makeEvaluation(dofIdx, pressureWIdx, timeIdx);
         Evaluation pN =
             Toolbox::max(elemCtx.problem().referencePressure(elemCtx, dofIdx, /*timeIdx=*/0),
                          pW + (pC[gasPhaseIdx] - pC[liquidPhaseIdx]));
@@ -140,6 +140,14 @@ struct InitialTimeStepSize { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct RestartTime { using type = UndefinedProperty; };
 
+//! Specify whether restart files are written and read in binary format
+template<class TypeTag, class MyTypeTag>
+struct EnableBinaryRestartFiles { using type = UndefinedProperty; };
+
+//! Specify whether restart files are written by a separate thread
+template<class TypeTag, class MyTypeTag>
+struct EnableAsyncRestartOutput { using type = UndefinedProperty; };
+
 //! The name of the file with a number of forced time step lengths
 template<class TypeTag, class MyTypeTag>
 struct PredeterminedTimeStepsFile { using type = UndefinedProperty; };
@@ -270,6 +278,14 @@ struct RestartTime<TypeTag, TTag::NumericModel>
     static constexpr type value = -1e35;
 };
 
+//! By default, restart files are human readable
+template<class TypeTag>
+struct EnableBinaryRestartFiles<TypeTag, TTag::NumericModel> { static constexpr bool value = false; };
+
+//! By default, restart files are written synchronously
+template<class TypeTag>
+struct EnableAsyncRestartOutput<TypeTag, TTag::NumericModel> { static constexpr bool value = false; };
+
 //! By default, do not force any time steps
 template<class TypeTag>
 struct PredeterminedTimeStepsFile<TypeTag, TTag::NumericModel> { static constexpr auto value = ""; };
@@ -43,7 +43,9 @@
 #include <dune/common/classname.hh>
 #include <dune/common/parametertree.hh>
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <set>
 #include <list>
 #include <sstream>
@@ -173,6 +175,54 @@ struct ParamInfo
     }
 };
 
+//! \cond SKIP_THIS
+inline std::atomic<int>& retrievalForbiddenCounter_()
+{
+    static std::atomic<int> counter(0);
+    return counter;
+}
+
+inline void complainAboutRetrieval_(const char *paramName)
+{
+    // complain only once per parameter, else the output would be flooded
+    static std::mutex mutex;
+    static std::set<std::string> reportedParams;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!reportedParams.insert(paramName).second)
+        return;
+
+    std::cerr << "Warning: Run-time parameter '" << paramName << "' is retrieved "
+              << "inside a performance critical code section. Please retrieve its "
+              << "value beforehand.\n" << std::flush;
+}
+//! \endcond
+
+/*!
+ * \ingroup Parameter
+ *
+ * \brief Marks a performance critical code section in which run-time parameters
+ *        should not be retrieved.
+ *
+ * Retrieving a parameter involves a lookup in the parameter registry and parsing a
+ * string, so code which is executed for each element or degree of freedom should use
+ * values which were retrieved in advance. If debugging code is not explicitly turned
+ * off, a warning is printed for each parameter which is retrieved while an object of
+ * this class is alive.
+ */
+class ForbidParameterRetrieval
+{
+public:
+    ForbidParameterRetrieval()
+    { ++retrievalForbiddenCounter_(); }
+
+    ~ForbidParameterRetrieval()
+    { --retrievalForbiddenCounter_(); }
+
+    ForbidParameterRetrieval(const ForbidParameterRetrieval&) = delete;
+    ForbidParameterRetrieval& operator=(const ForbidParameterRetrieval&) = delete;
+};
+
 // forward declaration
 template <class TypeTag, class ParamType, class PropTag>
 const ParamType get(const char *propTagName,
@@ -1073,6 +1123,9 @@ private:
         // this is potentially quite expensive, it is only done if
         // debugging code is not explicitly turned off.
         check_(Dune::className<ParamType>(), propTagName, paramName);
+
+        if (retrievalForbiddenCounter_() > 0)
+            complainAboutRetrieval_(paramName);
 #endif
 
         if (errorIfNotRegistered) {
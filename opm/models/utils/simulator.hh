@@ -29,24 +29,52 @@
 #define EWOMS_SIMULATOR_HH
 
 #include <opm/models/io/restart.hh>
+#include <opm/models/io/binaryrestart.hh>
+#include <opm/models/io/restartwritetasklet.hh>
 #include <opm/models/utils/parametersystem.hh>
 
 #include <opm/models/utils/propertysystem.hh>
 #include <opm/models/utils/timer.hh>
 #include <opm/models/utils/timerguard.hh>
 #include <opm/models/parallel/mpiutil.hh>
+#include <opm/models/parallel/tasklets.hh>
 #include <opm/models/discretization/common/fvbaseproperties.hh>
 
 #include <dune/common/version.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <cstdlib>
+#include <exception>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <vector>
 #include <string>
 #include <memory>
+#include <stdexcept>
+#include <utility>
 
+namespace Opm {
+/*!
+ * \brief Terminate all processes of the simulation.
+ *
+ * MPI_Abort() terminates all processes, so the processes do not need to agree on
+ * whether one of them encountered a fatal error.
+ */
+inline void abortAllProcesses()
+{
+#if HAVE_MPI
+    int initialized;
+    MPI_Initialized(&initialized);
+    if (initialized)
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+#endif
+    std::abort();
+}
+} // namespace Opm
+
+// run some code and terminate all processes if it throws an exception on any of them.
+// this does not involve any communication unless an exception is thrown.
 #define EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(code)                      \
     {                                                                   \
         const auto& comm = Dune::MPIHelper::getCollectiveCommunication(); \
@@ -68,8 +96,8 @@
                       <<" Abort!" << std::endl;                         \
         }                                                               \
                                                                         \
-        if (comm.max(exceptionThrown))                                  \
-            std::abort();                                               \
+        if (exceptionThrown)                                            \
+            Opm::abortAllProcesses();                                   \
     }
 
 namespace Opm {
@@ -131,6 +159,10 @@ public:
 
         finished_ = false;
 
+        // if restart files are written asynchronously, this is done by a separate thread
+        if (EWOMS_GET_PARAM(TypeTag, bool, EnableAsyncRestartOutput))
+            restartTaskletRunner_.reset(new TaskletRunner(/*numWorkers=*/1));
+
         if (verbose_)
             std::cout << "Allocating the simulation vanguard\n" << std::flush;
 
@@ -242,6 +274,12 @@ public:
                              "The size of the initial time step [s]");
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, RestartTime,
                              "The simulation time at which a restart should be attempted [s]");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableBinaryRestartFiles,
+                             "Write and read restart files in a binary format instead of "
+                             "as text");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncRestartOutput,
+                             "Write restart files in a separate thread while the "
+                             "simulation continues");
         EWOMS_REGISTER_PARAM(TypeTag, std::string, PredeterminedTimeStepsFile,
                              "A file with a list of predetermined time step sizes (one "
                              "time step per line)");
@@ -636,14 +674,14 @@ public:
             // try to restart a previous simulation
             time_ = restartTime;
 
-            Opm::Restart res;
-            EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(res.deserializeBegin(*this, time_));
-            if (verbose_)
-                std::cout << "Deserialize from file '" << res.fileName() << "'\n" << std::flush;
-            EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(this->deserialize(res));
-            EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(problem_->deserialize(res));
-            EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(model_->deserialize(res));
-            EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(res.deserializeEnd());
+            if (EWOMS_GET_PARAM(TypeTag, bool, EnableBinaryRestartFiles)) {
+                Opm::BinaryRestart res;
+                deserializeAll_(res);
+            }
+            else {
+                Opm::Restart res;
+                deserializeAll_(res);
+            }
             if (verbose_)
                 std::cout << "Deserialization done."
                           << " Simulator time: " << time() << humanReadableTime(time())
@@ -790,6 +828,11 @@ public:
                 EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(serialize());
             writeTimer_.stop();
         }
+
+        // wait until the restart files which are written in the background are complete
+        writeTimer_.start();
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(finishRestartWrite_());
+        writeTimer_.stop();
         executionTimer_.stop();
 
         EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(problem_->finalize());
@@ -883,22 +926,20 @@ public:
      * The file will start with the prefix returned by the name()
      * method, has the current time of the simulation clock in it's
      * name and uses the extension <tt>.ers</tt>. (Ewoms ReStart
-     * file.)  See Opm::Restart for details.
+     * file.)  See Opm::Restart for details. If binary restart files
+     * are enabled, the extension is <tt>.brs</tt> and the file is
+     * written by Opm::BinaryRestart.
      */
     void serialize()
     {
-        using Restarter = Opm::Restart;
-        Restarter res;
-        res.serializeBegin(*this);
-        if (gridView().comm().rank() == 0)
-            std::cout << "Serialize to file '" << res.fileName() << "'"
-                      << ", next time step size: " << timeStepSize()
-                      << "\n" << std::flush;
-
-        this->serialize(res);
-        problem_->serialize(res);
-        model_->serialize(res);
-        res.serializeEnd();
+        if (EWOMS_GET_PARAM(TypeTag, bool, EnableBinaryRestartFiles)) {
+            Opm::BinaryRestart res;
+            serializeAll_(res);
+        }
+        else {
+            Opm::Restart res;
+            serializeAll_(res);
+        }
     }
 
     /*!
@@ -944,6 +985,62 @@ public:
     }
 
 private:
+    template <class Restarter>
+    void serializeAll_(Restarter& res)
+    {
+        // if restart files are written asynchronously, the state of the simulation is
+        // serialized to memory and the file is written by the worker thread. we allow at
+        // most one restart file to be in flight, so the memory needed for this is bounded
+        // by the size of a single restart file.
+        bool async = static_cast<bool>(restartTaskletRunner_);
+        if (async)
+            finishRestartWrite_();
+
+        res.serializeBegin(*this, /*toMemory=*/async);
+        if (gridView().comm().rank() == 0)
+            std::cout << "Serialize to file '" << res.fileName() << "'"
+                      << ", next time step size: " << timeStepSize()
+                      << "\n" << std::flush;
+
+        this->serialize(res);
+        problem_->serialize(res);
+        model_->serialize(res);
+        res.serializeEnd();
+
+        if (async) {
+            pendingRestartWrite_ =
+                std::make_shared<RestartWriteTasklet>(res.fileName(),
+                                                      res.takeSerializedData());
+            restartTaskletRunner_->dispatch(pendingRestartWrite_);
+        }
+    }
+
+    // wait until the restart file which is written in the background is complete and
+    // throw the exception which occurred while writing it (if any)
+    void finishRestartWrite_()
+    {
+        if (!restartTaskletRunner_)
+            return;
+
+        restartTaskletRunner_->barrier();
+
+        auto tasklet = std::move(pendingRestartWrite_);
+        if (tasklet)
+            tasklet->rethrowError();
+    }
+
+    template <class Restarter>
+    void deserializeAll_(Restarter& res)
+    {
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(res.deserializeBegin(*this, time_));
+        if (verbose_)
+            std::cout << "Deserialize from file '" << res.fileName() << "'\n" << std::flush;
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(this->deserialize(res));
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(problem_->deserialize(res));
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(model_->deserialize(res));
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(res.deserializeEnd());
+    }
+
     std::unique_ptr<Vanguard> vanguard_;
     std::unique_ptr<Model> model_;
     std::unique_ptr<Problem> problem_;
@@ -970,6 +1067,9 @@ private:
 
     bool finished_;
     bool verbose_;
+
+    std::unique_ptr<TaskletRunner> restartTaskletRunner_;
+    std::shared_ptr<RestartWriteTasklet> pendingRestartWrite_;
 };
 
 namespace Properties {
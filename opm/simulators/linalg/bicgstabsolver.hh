@@ -208,6 +208,9 @@ public:
             //
             // p_i = r_(i-1) + beta*(p_(i-1) - omega_(i-1)*v_(i-1))
             // y = p
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
             for (unsigned i = 0; i < n; ++i) {
                 // p_i = r_(i-1) + beta*(p_(i-1) - omega_(i-1)*v_(i-1))
                 auto tmp = v[i];
@@ -237,6 +240,9 @@ public:
 
             // h = x_(i-1) + alpha*y
             // s = r_(i-1) - alpha*v_i
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
             for (unsigned i = 0; i < n; ++i) {
                 auto tmp = y[i];
                 tmp *= alpha;
@@ -293,7 +299,11 @@ public:
 
             // x_i = h + omega_i*z
             // x = h; // not necessary because x and h are the same object
-            x.axpy(/*a=*/omega, /*y=*/z);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (unsigned i = 0; i < n; ++i)
+                x[i].axpy(/*a=*/omega, /*y=*/z[i]);
 
             // do convergence check and print terminal output
             convergenceCriterion_.update(/*curSol=*/x, /*delta=*/z, r);
@@ -322,7 +332,11 @@ public:
 
             // r_i = s - omega*t
             // r = s; // not necessary because r and s are the same object
-            r.axpy(/*a=*/-omega, /*y=*/t);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (unsigned i = 0; i < n; ++i)
+                r[i].axpy(/*a=*/-omega, /*y=*/t[i]);
         }
 
         report_.setConverged(false);
@@ -0,0 +1,321 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Kernels for the operations on small dense blocks of fixed size which dominate
+ *        the costs of block-sparse linear algebra.
+ *
+ * All sizes are compile time constants, so the compiler completely unrolls the loops and
+ * vectorizes them for the instruction set which is selected by the build flags (e.g.,
+ * -march). The blocks are expected to be stored contiguously in row-major order.
+ *
+ * The sparse matrix-vector products are additionally compiled for AVX2 and AVX-512 if
+ * the compiler supports function multi-versioning. The variant which is used is then
+ * selected at run time according to the capabilities of the CPU, so a single binary
+ * uses the widest vector units which are available on each node.
+ */
+#ifndef EWOMS_BLOCK_KERNELS_HH
+#define EWOMS_BLOCK_KERNELS_HH
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/exceptions.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define EWOMS_BLOCK_PRAGMA_(x) _Pragma(#x)
+#if defined(_OPENMP)
+#define EWOMS_BLOCK_SIMD EWOMS_BLOCK_PRAGMA_(omp simd)
+#define EWOMS_BLOCK_SIMD_SUM(var) EWOMS_BLOCK_PRAGMA_(omp simd reduction(+:var))
+#else
+#define EWOMS_BLOCK_SIMD
+#define EWOMS_BLOCK_SIMD_SUM(var)
+#endif
+
+// compile the functions which are marked by this for several instruction sets and select
+// the one to be used when the program is loaded. this requires a GNU compiler and an ELF
+// platform. it can be disabled by defining EWOMS_NO_BLOCK_KERNEL_DISPATCH.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 8 \
+    && defined(__x86_64__) && defined(__ELF__) && !defined(EWOMS_NO_BLOCK_KERNEL_DISPATCH)
+#define EWOMS_BLOCK_DISPATCH __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define EWOMS_BLOCK_DISPATCH
+#endif
+
+namespace Opm {
+namespace MatrixBlockHelp {
+
+/*!
+ * \brief Specifies whether the specialized kernels are used for blocks of a given size.
+ *
+ * For blocks of size one, the generic code is as good as it gets and for large blocks,
+ * unrolling all loops does not pay off anymore.
+ */
+template <int n, int m>
+constexpr bool useBlockKernels()
+{ return 2 <= n && n <= 6 && 2 <= m && m <= 6; }
+
+//! y = A*x for a n x m block A
+template <class K, int n, int m>
+inline void blockMv(const K* A, const K* x, K* y)
+{
+    for (int i = 0; i < n; ++i) {
+        K sum = 0.0;
+        EWOMS_BLOCK_SIMD_SUM(sum)
+        for (int j = 0; j < m; ++j)
+            sum += A[i*m + j]*x[j];
+        y[i] = sum;
+    }
+}
+
+//! y += alpha*A*x for a n x m block A
+template <class K, int n, int m>
+inline void blockUsmv(K alpha, const K* A, const K* x, K* y)
+{
+    for (int i = 0; i < n; ++i) {
+        K sum = 0.0;
+        EWOMS_BLOCK_SIMD_SUM(sum)
+        for (int j = 0; j < m; ++j)
+            sum += A[i*m + j]*x[j];
+        y[i] += alpha*sum;
+    }
+}
+
+//! C = A*B for a n x k block A and a k x m block B
+template <class K, int n, int k, int m>
+inline void blockMatMul(const K* A, const K* B, K* C)
+{
+    for (int i = 0; i < n; ++i) {
+        EWOMS_BLOCK_SIMD
+        for (int j = 0; j < m; ++j)
+            C[i*m + j] = 0.0;
+
+        for (int l = 0; l < k; ++l) {
+            const K a = A[i*k + l];
+            EWOMS_BLOCK_SIMD
+            for (int j = 0; j < m; ++j)
+                C[i*m + j] += a*B[l*m + j];
+        }
+    }
+}
+
+//! y += alpha*x for two arrays of size n
+template <class K, int n>
+inline void blockAxpy(K alpha, const K* x, K* y)
+{
+    EWOMS_BLOCK_SIMD
+    for (int i = 0; i < n; ++i)
+        y[i] += alpha*x[i];
+}
+
+/*!
+ * \brief Invert a n x n block in place using Gauss-Jordan elimination with partial
+ *        pivoting.
+ *
+ * Like Dune::FieldMatrix::invert(), this throws a Dune::FMatrixError if the block is
+ * singular.
+ */
+template <class K, int n>
+inline void blockInvert(K* A)
+{
+    int perm[n];
+    for (int i = 0; i < n; ++i)
+        perm[i] = i;
+
+    for (int col = 0; col < n; ++col) {
+        // find the pivot row
+        int pivotRow = col;
+        K pivotAbs = std::abs(A[col*n + col]);
+        for (int i = col + 1; i < n; ++i) {
+            K tmp = std::abs(A[i*n + col]);
+            if (tmp > pivotAbs) {
+                pivotAbs = tmp;
+                pivotRow = i;
+            }
+        }
+
+        if (pivotAbs == 0.0)
+            DUNE_THROW(Dune::FMatrixError, "Block is singular");
+
+        if (pivotRow != col) {
+            for (int j = 0; j < n; ++j) {
+                K tmp = A[col*n + j];
+                A[col*n + j] = A[pivotRow*n + j];
+                A[pivotRow*n + j] = tmp;
+            }
+            int tmp = perm[col];
+            perm[col] = perm[pivotRow];
+            perm[pivotRow] = tmp;
+        }
+
+        // scale the pivot row. the identity matrix is built up in place of the
+        // eliminated column.
+        const K invPivot = 1.0/A[col*n + col];
+        A[col*n + col] = 1.0;
+        EWOMS_BLOCK_SIMD
+        for (int j = 0; j < n; ++j)
+            A[col*n + j] *= invPivot;
+
+        // eliminate the column from all other rows
+        for (int i = 0; i < n; ++i) {
+            if (i == col)
+                continue;
+
+            const K factor = A[i*n + col];
+            A[i*n + col] = 0.0;
+            EWOMS_BLOCK_SIMD
+            for (int j = 0; j < n; ++j)
+                A[i*n + j] -= factor*A[col*n + j];
+        }
+    }
+
+    // undo the row permutation by permuting the columns of the inverse
+    K row[n];
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j)
+            row[perm[j]] = A[i*n + j];
+        for (int j = 0; j < n; ++j)
+            A[i*n + j] = row[j];
+    }
+}
+
+/*!
+ * \brief Specifies whether the block-CSR kernels can be used to multiply a sparse
+ *        matrix with a vector.
+ *
+ * This requires the blocks to be of a size for which the block kernels are used, their
+ * entries to be stored contiguously and the vectors to use the field type of the
+ * matrix.
+ */
+template <class Matrix, class X, class Y>
+constexpr bool useBlockCsrKernels()
+{
+    using Block = typename Matrix::block_type;
+    using K = typename Matrix::field_type;
+    return useBlockKernels<Block::rows, Block::cols>()
+        && sizeof(Block) == Block::rows*Block::cols*sizeof(K)
+        && std::is_same<K, typename X::field_type>::value
+        && std::is_same<K, typename Y::field_type>::value;
+}
+
+/*!
+ * \brief y = A*x (or y += alpha*A*x if add is true) for the rows [beginIdx, endIdx) of
+ *        the list of rows of a block-CSR matrix.
+ *
+ * If rowIndices is a null pointer, the rows of the matrix are considered in order.
+ * This function is compiled for all supported instruction sets.
+ */
+template <class Matrix, class X, class Y>
+EWOMS_BLOCK_DISPATCH
+void blockCsrMvRange(const Matrix& A,
+                     const unsigned* rowIndices,
+                     std::size_t beginIdx,
+                     std::size_t endIdx,
+                     typename Matrix::field_type alpha,
+                     bool add,
+                     const X& x,
+                     Y& y)
+{
+    using K = typename Matrix::field_type;
+    static constexpr int n = Matrix::block_type::rows;
+    static constexpr int m = Matrix::block_type::cols;
+
+    for (std::size_t i = beginIdx; i < endIdx; ++i) {
+        std::size_t rowIdx = rowIndices ? rowIndices[i] : i;
+
+        K sum[n];
+        for (int k = 0; k < n; ++k)
+            sum[k] = 0.0;
+
+        const auto& row = A[rowIdx];
+        auto colIt = row.begin();
+        const auto& colEndIt = row.end();
+        for (; colIt != colEndIt; ++colIt)
+            blockUsmv<K, n, m>(1.0, &(*colIt)[0][0], &x[colIt.index()][0], sum);
+
+        auto& yRow = y[rowIdx];
+        if (add) {
+            for (int k = 0; k < n; ++k)
+                yRow[k] += alpha*sum[k];
+        }
+        else {
+            for (int k = 0; k < n; ++k)
+                yRow[k] = sum[k];
+        }
+    }
+}
+
+/*!
+ * \brief y = A*x (or y += alpha*A*x if add is true) for a list of rows of a block-CSR
+ *        matrix using all threads.
+ *
+ * The rows of y which are not in the list are left untouched. If rowIndices is a null
+ * pointer, the first numRows rows of the matrix are considered.
+ */
+template <class Matrix, class X, class Y>
+void blockCsrMv(const Matrix& A,
+                const unsigned* rowIndices,
+                std::size_t numRows,
+                typename Matrix::field_type alpha,
+                bool add,
+                const X& x,
+                Y& y)
+{
+    static_assert(useBlockCsrKernels<Matrix, X, Y>(),
+                  "The block-CSR kernels cannot be used for this kind of matrix");
+
+    // the kernel is only dispatched once per thread, so each thread gets a contiguous
+    // range of rows
+#ifdef _OPENMP
+#pragma omp parallel if (numRows > 1000)
+#endif
+    {
+        std::size_t numThreads = 1;
+        std::size_t threadIdx = 0;
+#ifdef _OPENMP
+        numThreads = static_cast<std::size_t>(omp_get_num_threads());
+        threadIdx = static_cast<std::size_t>(omp_get_thread_num());
+#endif
+        std::size_t rowsPerThread = (numRows + numThreads - 1)/numThreads;
+        std::size_t beginIdx = std::min(numRows, threadIdx*rowsPerThread);
+        std::size_t endIdx = std::min(numRows, beginIdx + rowsPerThread);
+        blockCsrMvRange(A, rowIndices, beginIdx, endIdx, alpha, add, x, y);
+    }
+}
+
+} // namespace MatrixBlockHelp
+} // namespace Opm
+
+#undef EWOMS_BLOCK_DISPATCH
+#undef EWOMS_BLOCK_SIMD_SUM
+#undef EWOMS_BLOCK_SIMD
+#undef EWOMS_BLOCK_PRAGMA_
+
+#endif
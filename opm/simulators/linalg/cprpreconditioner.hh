@@ -0,0 +1,334 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Linear::CprPreconditioner
+ */
+#ifndef EWOMS_CPR_PRECONDITIONER_HH
+#define EWOMS_CPR_PRECONDITIONER_HH
+
+#include "linalgproperties.hh"
+
+#include <opm/models/utils/propertysystem.hh>
+#include <opm/models/utils/parametersystem.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/istl/paamg/amg.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/version.hh>
+
+#include <memory>
+#include <vector>
+
+namespace Opm {
+namespace Linear {
+/*!
+ * \brief A two-stage constrained pressure residual (CPR) preconditioner.
+ *
+ * The first stage approximately solves a scalar pressure system using an algebraic
+ * multi-grid V-cycle. This system is obtained by combining the equations of each degree
+ * of freedom using quasi-IMPES weights, i.e., the weights are chosen such that the
+ * diagonal block of the Jacobian matrix does not couple the pressure with the remaining
+ * primary variables anymore. The second stage applies a smoother to the residual of the
+ * full system which is left after the pressure correction.
+ *
+ * The pressure stage deals with the elliptic part of the problem, which otherwise lets
+ * the number of iterations of the linear solver grow with the size of the problem.
+ */
+template <class Matrix, class Vector, class FineSmoother>
+class CprPreconditioner : public Dune::Preconditioner<Vector, Vector>
+{
+    using field_type = typename Vector::field_type;
+    static constexpr int numEq = Vector::block_type::dimension;
+
+    using WeightVector = Dune::FieldVector<field_type, numEq>;
+    using PressureMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<field_type, 1, 1> >;
+    using PressureVector = Dune::BlockVector<Dune::FieldVector<field_type, 1> >;
+    using PressureOperator = Dune::MatrixAdapter<PressureMatrix, PressureVector, PressureVector>;
+    using PressureSmoother = Dune::SeqSSOR<PressureMatrix, PressureVector, PressureVector>;
+    using PressureAmg = Dune::Amg::AMG<PressureOperator, PressureVector, PressureSmoother>;
+    using CoarsenCriterion =
+        Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<PressureMatrix,
+                                                                  Dune::Amg::FirstDiagonal> >;
+
+public:
+    using matrix_type = Matrix;
+    using domain_type = Vector;
+    using range_type = Vector;
+
+    /*!
+     * \brief Set up the preconditioner for a given matrix.
+     *
+     * \param A The matrix of the linear system
+     * \param pressureIdx The index of the pressure in the primary variables
+     * \param coarsenTarget The number of unknowns at which the coarsening of the
+     *                      pressure system stops
+     * \param dimension The spatial dimension of the problem
+     * \param relaxationFactor The relaxation factor of the smoother of the second stage
+     */
+    CprPreconditioner(const Matrix& A,
+                      unsigned pressureIdx,
+                      int coarsenTarget,
+                      int dimension,
+                      field_type relaxationFactor)
+        : A_(A)
+        , pressureIdx_(pressureIdx)
+        , fineSmoother_(A, relaxationFactor)
+    {
+        computeWeights_();
+        assemblePressureMatrix_();
+
+        using SmootherArgs = typename Dune::Amg::SmootherTraits<PressureSmoother>::Arguments;
+        SmootherArgs smootherArgs;
+        smootherArgs.iterations = 1;
+        smootherArgs.relaxationFactor = 1.0;
+
+        CoarsenCriterion coarsenCriterion(/*maxLevel=*/15, coarsenTarget);
+        coarsenCriterion.setDefaultValuesAnisotropic(dimension, /*aggregateSizePerDim=*/3);
+        coarsenCriterion.setDebugLevel(0);
+        coarsenCriterion.setMinCoarsenRate(1.05);
+        coarsenCriterion.setAccumulate(Dune::Amg::atOnceAccu);
+        coarsenCriterion.setSkipIsolated(false);
+
+        pressureOperator_ = std::make_unique<PressureOperator>(*pressureMatrix_);
+        pressureAmg_ = std::make_unique<PressureAmg>(*pressureOperator_, coarsenCriterion, smootherArgs);
+
+        pressureRhs_.resize(A.N());
+        pressureUpdate_.resize(A.N());
+    }
+
+    void pre(Vector& x, Vector& b) override
+    {
+        pressureRhs_ = 0.0;
+        pressureUpdate_ = 0.0;
+        pressureAmg_->pre(pressureUpdate_, pressureRhs_);
+        fineSmoother_.pre(x, b);
+
+        residual_ = std::make_unique<Vector>(b);
+        fineUpdate_ = std::make_unique<Vector>(x);
+    }
+
+    void apply(Vector& v, const Vector& d) override
+    {
+        std::size_t numRows = A_.N();
+
+        // restrict the residual to the pressure system
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            pressureRhs_[rowIdx] = weights_[rowIdx]*d[rowIdx];
+
+        // first stage: one V-cycle for the pressure system
+        pressureUpdate_ = 0.0;
+        pressureAmg_->apply(pressureUpdate_, pressureRhs_);
+
+        v = 0.0;
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            v[rowIdx][pressureIdx_] = pressureUpdate_[rowIdx];
+
+        // second stage: smooth the residual of the full system which is left after the
+        // pressure correction
+        Vector& residual = *residual_;
+        residual = d;
+        A_.mmv(v, residual);
+
+        Vector& fineUpdate = *fineUpdate_;
+        fineUpdate = 0.0;
+        fineSmoother_.apply(fineUpdate, residual);
+        v += fineUpdate;
+    }
+
+    void post(Vector& x) override
+    {
+        pressureAmg_->post(pressureUpdate_);
+        fineSmoother_.post(x);
+    }
+
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::sequential; }
+
+private:
+    // the quasi-IMPES weights w_i of a row solve D_ii^T w_i = e_p, where D_ii is the
+    // diagonal block of the row. combining the equations of the row with these weights
+    // eliminates the derivatives of the row's non-pressure unknowns.
+    void computeWeights_()
+    {
+        std::size_t numRows = A_.N();
+        weights_.resize(numRows);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int rowIdx = 0; rowIdx < static_cast<int>(numRows); ++rowIdx) {
+            const auto& diagBlock = A_[static_cast<std::size_t>(rowIdx)][static_cast<std::size_t>(rowIdx)];
+
+            Dune::FieldMatrix<field_type, numEq, numEq> diagBlockT;
+            for (int i = 0; i < numEq; ++i)
+                for (int j = 0; j < numEq; ++j)
+                    diagBlockT[i][j] = diagBlock[j][i];
+
+            WeightVector unitVector(0.0);
+            unitVector[pressureIdx_] = 1.0;
+
+            WeightVector& w = weights_[static_cast<std::size_t>(rowIdx)];
+            try {
+                diagBlockT.solve(w, unitVector);
+            }
+            catch (const Dune::FMatrixError&) {
+                // fall back to simply adding up the equations if the diagonal block is
+                // singular
+                w = 1.0;
+            }
+        }
+    }
+
+    // the pressure matrix exhibits the same sparsity pattern as the full one. its
+    // entries are the weighted sums of the pressure derivatives of the equations.
+    void assemblePressureMatrix_()
+    {
+        std::size_t numRows = A_.N();
+        pressureMatrix_ = std::make_unique<PressureMatrix>(numRows, numRows, A_.nonzeroes(),
+                                                           PressureMatrix::row_wise);
+        for (auto row = pressureMatrix_->createbegin(); row != pressureMatrix_->createend(); ++row) {
+            const auto& fullRow = A_[row.index()];
+            for (auto colIt = fullRow.begin(); colIt != fullRow.end(); ++colIt)
+                row.insert(colIt.index());
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int rowIdx = 0; rowIdx < static_cast<int>(numRows); ++rowIdx) {
+            const auto& w = weights_[static_cast<std::size_t>(rowIdx)];
+            const auto& fullRow = A_[static_cast<std::size_t>(rowIdx)];
+            auto& pressureRow = (*pressureMatrix_)[static_cast<std::size_t>(rowIdx)];
+
+            auto pressureColIt = pressureRow.begin();
+            for (auto colIt = fullRow.begin(); colIt != fullRow.end(); ++colIt, ++pressureColIt) {
+                field_type value = 0.0;
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                    value += w[eqIdx]*(*colIt)[eqIdx][pressureIdx_];
+                (*pressureColIt) = value;
+            }
+        }
+    }
+
+    const Matrix& A_;
+    unsigned pressureIdx_;
+
+    std::vector<WeightVector> weights_;
+
+    std::unique_ptr<PressureMatrix> pressureMatrix_;
+    std::unique_ptr<PressureOperator> pressureOperator_;
+    std::unique_ptr<PressureAmg> pressureAmg_;
+    PressureVector pressureRhs_;
+    PressureVector pressureUpdate_;
+
+    FineSmoother fineSmoother_;
+    std::unique_ptr<Vector> residual_;
+    std::unique_ptr<Vector> fineUpdate_;
+};
+
+/*!
+ * \brief Makes the CPR preconditioner available using the PreconditionerWrapper
+ *        property.
+ *
+ * The second stage uses a block ILU(0) preconditioner. The index of the pressure in the
+ * vector of primary variables is specified by the CprPressureIndex property. If the
+ * UseCprPreconditioner parameter is false, the block ILU(0) preconditioner is used on
+ * its own, i.e., CPR can be compared with the default preconditioner without
+ * recompiling.
+ */
+template <class TypeTag>
+class PreconditionerWrapperCPR
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using OverlappingMatrix = GetPropType<TypeTag, Properties::OverlappingMatrix>;
+    using OverlappingVector = GetPropType<TypeTag, Properties::OverlappingVector>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2,7)
+    using FineSmoother = Dune::SeqILU<OverlappingMatrix, OverlappingVector, OverlappingVector>;
+#else
+    using FineSmoother = Dune::SeqILU0<OverlappingMatrix, OverlappingVector, OverlappingVector>;
+#endif
+
+    static constexpr unsigned pressureIdx = getPropValue<TypeTag, Properties::CprPressureIndex>();
+
+    using CprSequentialPreconditioner = CprPreconditioner<OverlappingMatrix, OverlappingVector, FineSmoother>;
+
+public:
+    // the preconditioner is chosen at run time, so it is accessed via the dynamic
+    // interface of dune-istl
+    using SequentialPreconditioner = Dune::Preconditioner<OverlappingVector, OverlappingVector>;
+
+    PreconditionerWrapperCPR()
+    {}
+
+    static void registerParameters()
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, PreconditionerRelaxation,
+                             "The relaxation factor of the preconditioner");
+        EWOMS_REGISTER_PARAM(TypeTag, int, CprCoarsenTarget,
+                             "The coarsening target for the algebraic multi-grid "
+                             "preconditioner of the pressure system");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, UseCprPreconditioner,
+                             "Use the CPR preconditioner instead of its block ILU(0) "
+                             "stage on its own");
+    }
+
+    void prepare(OverlappingMatrix& matrix)
+    {
+        Scalar relaxationFactor = EWOMS_GET_PARAM(TypeTag, Scalar, PreconditionerRelaxation);
+
+        if (!EWOMS_GET_PARAM(TypeTag, bool, UseCprPreconditioner)) {
+            seqPreCond_ = new FineSmoother(matrix, relaxationFactor);
+            return;
+        }
+
+        int coarsenTarget = EWOMS_GET_PARAM(TypeTag, int, CprCoarsenTarget);
+        seqPreCond_ = new CprSequentialPreconditioner(matrix,
+                                                      pressureIdx,
+                                                      coarsenTarget,
+                                                      GridView::dimension,
+                                                      relaxationFactor);
+    }
+
+    SequentialPreconditioner& get()
+    { return *seqPreCond_; }
+
+    void cleanup()
+    { delete seqPreCond_; }
+
+private:
+    SequentialPreconditioner *seqPreCond_;
+};
+
+}} // namespace Linear, Opm
+
+#endif
@@ -0,0 +1,171 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Linear::FlatIndexMap
+ */
+#ifndef EWOMS_FLAT_INDEX_MAP_HH
+#define EWOMS_FLAT_INDEX_MAP_HH
+
+#include "overlaptypes.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+namespace Linear {
+
+/*!
+ * \brief A hash map from non-negative indices to indices.
+ *
+ * In contrast to std::map or std::unordered_map, all entries are stored in a single
+ * array using open addressing with linear probing. This avoids allocating memory for
+ * each entry and makes lookups cache friendly, which matters because the index maps
+ * of the overlap are rebuilt whenever the grid changes. Entries cannot be erased.
+ */
+class FlatIndexMap
+{
+    static constexpr Index emptyKey_ = -1;
+
+public:
+    FlatIndexMap()
+        : size_(0)
+        , shift_(64)
+    {}
+
+    /*!
+     * \brief Make room for a given number of entries without rehashing.
+     */
+    void reserve(std::size_t numEntries)
+    {
+        std::size_t capacity = 16;
+        while (capacity/2 < numEntries)
+            capacity *= 2;
+
+        if (capacity > slots_.size())
+            rehash_(capacity);
+    }
+
+    /*!
+     * \brief Set the value which corresponds to a key.
+     *
+     * If the key already exists, its value is overwritten.
+     */
+    void insert(Index key, Index value)
+    {
+        assert(key >= 0);
+
+        // keep the load factor below one half
+        if (2*(size_ + 1) > slots_.size())
+            rehash_(std::max<std::size_t>(16, 2*slots_.size()));
+
+        std::size_t slotIdx = findSlot_(key);
+        if (slots_[slotIdx].first == emptyKey_) {
+            slots_[slotIdx].first = key;
+            ++size_;
+        }
+        slots_[slotIdx].second = value;
+    }
+
+    /*!
+     * \brief Returns the value which corresponds to a key or -1 if the key does not
+     *        exist.
+     */
+    Index find(Index key) const
+    {
+        if (slots_.empty())
+            return -1;
+
+        const auto& slot = slots_[findSlot_(key)];
+        return (slot.first == emptyKey_) ? -1 : slot.second;
+    }
+
+    /*!
+     * \brief Returns true iff a key exists.
+     */
+    bool contains(Index key) const
+    { return !slots_.empty() && slots_[findSlot_(key)].first == key; }
+
+    /*!
+     * \brief Returns the number of entries.
+     */
+    std::size_t size() const
+    { return size_; }
+
+    /*!
+     * \brief Remove all entries.
+     */
+    void clear()
+    {
+        slots_.clear();
+        size_ = 0;
+        shift_ = 64;
+    }
+
+private:
+    // Fibonacci hashing: consecutive keys, which are the rule for the indices of the
+    // overlap, are spread over the whole table.
+    std::size_t hash_(Index key) const
+    {
+        std::uint64_t h = static_cast<std::uint64_t>(key)*UINT64_C(11400714819323198485);
+        return static_cast<std::size_t>(h >> shift_);
+    }
+
+    std::size_t findSlot_(Index key) const
+    {
+        std::size_t mask = slots_.size() - 1;
+        std::size_t slotIdx = hash_(key);
+        while (slots_[slotIdx].first != emptyKey_ && slots_[slotIdx].first != key)
+            slotIdx = (slotIdx + 1) & mask;
+
+        return slotIdx;
+    }
+
+    void rehash_(std::size_t capacity)
+    {
+        std::vector<std::pair<Index, Index> > oldSlots(capacity, std::make_pair(emptyKey_, emptyKey_));
+        oldSlots.swap(slots_);
+
+        shift_ = 64;
+        for (std::size_t n = capacity; n > 1; n /= 2)
+            --shift_;
+
+        for (const auto& slot : oldSlots) {
+            if (slot.first != emptyKey_)
+                slots_[findSlot_(slot.first)] = slot;
+        }
+    }
+
+    std::vector<std::pair<Index, Index> > slots_;
+    std::size_t size_;
+    unsigned shift_;
+};
+
+} // namespace Linear
+} // namespace Opm
+
+#endif
@@ -33,9 +33,8 @@
 #include <dune/istl/operators.hh>
 
 #include <algorithm>
-#include <set>
-#include <map>
 #include <iostream>
+#include <vector>
 #include <tuple>
 
 #if HAVE_MPI
@@ -43,6 +42,7 @@
 #endif
 
 #include "overlaptypes.hh"
+#include "flatindexmap.hh"
 
 namespace Opm {
 namespace Linear {
@@ -56,8 +56,10 @@ class GlobalIndices
 {
     GlobalIndices(const GlobalIndices& ) = delete;
 
-    using GlobalToDomesticMap = std::map<Index, Index>;
-    using DomesticToGlobalMap = std::map<Index, Index>;
+    // the global indices are scattered over the whole index range, whereas the domestic
+    // ones are contiguous
+    using GlobalToDomesticMap = FlatIndexMap;
+    using DomesticToGlobalMap = std::vector<Index>;
 
 public:
     GlobalIndices(const ForeignOverlap& foreignOverlap)
@@ -87,9 +89,10 @@ public:
      */
     Index domesticToGlobal(Index domesticIdx) const
     {
-        assert(domesticToGlobal_.find(domesticIdx) != domesticToGlobal_.end());
+        assert(0 <= domesticIdx && static_cast<size_t>(domesticIdx) < domesticToGlobal_.size());
+        assert(domesticToGlobal_[static_cast<size_t>(domesticIdx)] >= 0);
 
-        return domesticToGlobal_.find(domesticIdx)->second;
+        return domesticToGlobal_[static_cast<size_t>(domesticIdx)];
     }
 
     /*!
@@ -97,12 +100,7 @@ public:
      */
     Index globalToDomestic(Index globalIdx) const
     {
-        const auto& tmp = globalToDomestic_.find(globalIdx);
-
-        if (tmp == globalToDomestic_.end())
-            return -1;
-
-        return tmp->second;
+        return globalToDomestic_.find(globalIdx);
     }
 
     /*!
@@ -126,11 +124,18 @@ public:
      */
     void addIndex(Index domesticIdx, Index globalIdx)
     {
-        domesticToGlobal_[domesticIdx] = globalIdx;
-        globalToDomestic_[globalIdx] = domesticIdx;
-        numDomestic_ = domesticToGlobal_.size();
+        assert(domesticIdx >= 0 && globalIdx >= 0);
+
+        size_t domIdx = static_cast<size_t>(domesticIdx);
+        if (domIdx >= domesticToGlobal_.size())
+            domesticToGlobal_.resize(domIdx + 1, -1);
 
-        assert(domesticToGlobal_.size() == globalToDomestic_.size());
+        if (domesticToGlobal_[domIdx] < 0)
+            ++numDomestic_;
+        domesticToGlobal_[domIdx] = globalIdx;
+        globalToDomestic_.insert(globalIdx, domesticIdx);
+
+        assert(numDomestic_ == globalToDomestic_.size());
     }
 
     /*!
@@ -181,7 +186,7 @@ public:
      * \brief Return true iff a given global index already exists
      */
     bool hasGlobalIndex(Index globalIdx) const
-    { return globalToDomestic_.find(globalIdx) != globalToDomestic_.end(); }
+    { return globalToDomestic_.contains(globalIdx); }
 
     /*!
      * \brief Prints the global indices of all domestic indices
@@ -192,9 +197,11 @@ public:
         std::cout << "(domestic index, global index, domestic->global->domestic)"
                   << " list for rank " << myRank_ << "\n";
 
-        for (size_t domIdx = 0; domIdx < domesticToGlobal_.size(); ++domIdx)
-            std::cout << "(" << domIdx << ", " << domesticToGlobal(domIdx)
-                      << ", " << globalToDomestic(domesticToGlobal(domIdx)) << ") ";
+        for (size_t domIdx = 0; domIdx < domesticToGlobal_.size(); ++domIdx) {
+            Index globalIdx = domesticToGlobal_[domIdx];
+            std::cout << "(" << domIdx << ", " << globalIdx
+                      << ", " << globalToDomestic(globalIdx) << ") ";
+        }
         std::cout << "\n" << std::flush;
     }
 
@@ -205,6 +212,10 @@ protected:
     {
 #if HAVE_MPI
         numDomestic_ = 0;
+
+        // the local indices are the first domestic ones. most of them are added below.
+        domesticToGlobal_.reserve(foreignOverlap_.numLocal());
+        globalToDomestic_.reserve(foreignOverlap_.numLocal());
 #else
         numDomestic_ = foreignOverlap_.numLocal();
 #endif
@@ -47,6 +47,8 @@
 #include <opm/models/utils/propertysystem.hh>
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/simulators/linalg/linalgproperties.hh>
+#include <opm/simulators/linalg/cprpreconditioner.hh>
+#include <opm/simulators/linalg/threadedpreconditioners.hh>
 
 #include <dune/istl/preconditioners.hh>
 
@@ -193,7 +195,14 @@ EWOMS_WRAP_ISTL_SIMPLE_PRECONDITIONER(ILU0, Dune::SeqILU0)
 EWOMS_WRAP_ISTL_PRECONDITIONER(ILUn, Dune::SeqILUn)
 #endif
 
+// preconditioners which use all threads of the process
+EWOMS_WRAP_ISTL_PRECONDITIONER(ThreadedSOR, Opm::Linear::MultiColorSOR)
+EWOMS_WRAP_ISTL_PRECONDITIONER(ThreadedSSOR, Opm::Linear::MultiColorSSOR)
+EWOMS_WRAP_ISTL_SIMPLE_PRECONDITIONER(ThreadedBlockILU0, Opm::Linear::ThreadedBlockILU0)
+EWOMS_WRAP_ISTL_SIMPLE_PRECONDITIONER(LevelScheduledILU0, Opm::Linear::LevelScheduledILU0)
+
 #undef EWOMS_WRAP_ISTL_PRECONDITIONER
+#undef EWOMS_WRAP_ISTL_SIMPLE_PRECONDITIONER
 }} // namespace Linear, Opm
 
 #endif
@@ -27,10 +27,16 @@
 #ifndef EWOMS_ISTL_SPARSE_MATRIX_ADAPTER_HH
 #define EWOMS_ISTL_SPARSE_MATRIX_ADAPTER_HH
 
+#include "sparsitypattern.hh"
+
 #include <dune/istl/bcrsmatrix.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/common/version.hh>
 
+#include <cassert>
+#include <memory>
+#include <utility>
+
 namespace Opm {
 namespace Linear {
 
@@ -100,6 +106,35 @@ public:
         istlMatrix_->endindices();
     }
 
+    /*!
+     * \brief Allocate matrix structure given a sparsity pattern in compressed row
+     *        storage format.
+     *
+     * In contrast to the set-based variant, the sorted column indices of each row are
+     * copied into the matrix in one go.
+     */
+    void reserve(const SparsityPattern& sparsityPattern)
+    {
+        // allocate raw matrix
+        istlMatrix_.reset(new IstlMatrix(rows_, columns_, IstlMatrix::random));
+
+        // make sure sparsityPattern is consistent with number of rows
+        assert(rows_ == sparsityPattern.numRows());
+
+        // allocate space for the rows of the matrix
+        for (size_t dofIdx = 0; dofIdx < rows_; ++ dofIdx)
+            istlMatrix_->setrowsize(dofIdx, sparsityPattern.rowSize(dofIdx));
+
+        istlMatrix_->endrowsizes();
+
+        // fill the rows with indices
+        for (size_t dofIdx = 0; dofIdx < rows_; ++ dofIdx)
+            istlMatrix_->setIndices(dofIdx,
+                                    sparsityPattern.rowBegin(dofIdx),
+                                    sparsityPattern.rowEnd(dofIdx));
+        istlMatrix_->endindices();
+    }
+
     /*!
      * \brief Return constant reference to matrix implementation.
      */
@@ -108,6 +143,22 @@ public:
     const IstlMatrix& istlMatrix() const
     { return *istlMatrix_; }
 
+    /*!
+     * \brief Store the entries of the matrix in an object which is shared with someone
+     *        else.
+     *
+     * This allows the linear solver to work directly on the matrix which is assembled
+     * by the linearizer. The leading rows of the new matrix must exhibit at least the
+     * entries of the current one, i.e., it may feature additional rows and entries.
+     * These are set to zero by clear() but are not touched otherwise. The current
+     * entries of the matrix are discarded.
+     */
+    void shareIstlMatrix(std::shared_ptr<IstlMatrix> matrix)
+    {
+        assert(matrix->N() >= istlMatrix_->N() && matrix->nonzeroes() >= istlMatrix_->nonzeroes());
+        istlMatrix_ = std::move(matrix);
+    }
+
     /*!
      * \brief Return number of rows of the matrix.
      */
@@ -189,7 +240,7 @@ protected:
     size_t rows_;
     size_t columns_;
 
-    std::unique_ptr<IstlMatrix> istlMatrix_;
+    std::shared_ptr<IstlMatrix> istlMatrix_;
 };
 
 }} // namespace Linear, Opm
@@ -46,6 +46,58 @@ struct PreconditionerWrapper { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct LinearSolverScalar { using type = UndefinedProperty; };
 
+/*!
+ * \brief Specifies whether the linear system ought to be solved in mixed precision
+ *
+ * If enabled, the Krylov iteration and the residual use the model's Scalar type, while
+ * the overlapping matrix of the preconditioner and the preconditioner itself use
+ * LinearSolverScalar. This is only useful if LinearSolverScalar is less accurate than
+ * Scalar.
+ */
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverMixedPrecision { using type = UndefinedProperty; };
+
+/*!
+ * \brief The maximum number of linear solves which may reuse the preconditioner before
+ *        it is refreshed
+ *
+ * If this is 0, the preconditioner is set up for each linear solve.
+ */
+template<class TypeTag, class MyTypeTag>
+struct PreconditionerMaxReuse { using type = UndefinedProperty; };
+
+/*!
+ * \brief Refresh a reused preconditioner if the number of linear iterations grows by
+ *        more than this factor compared to the first solve after the last refresh
+ */
+template<class TypeTag, class MyTypeTag>
+struct PreconditionerRefreshIterationFactor { using type = UndefinedProperty; };
+
+//! Specifies whether a reused preconditioner is refreshed at the start of each time step
+template<class TypeTag, class MyTypeTag>
+struct PreconditionerRefreshOnNewTimeStep { using type = UndefinedProperty; };
+
+//! Specifies whether the pipelined variant of the BiCGStab solver ought to be used
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverPipelined { using type = UndefinedProperty; };
+
+/*!
+ * \brief Specifies whether the CPR preconditioner wrapper uses the CPR preconditioner
+ *
+ * If this is false, the block ILU(0) preconditioner which is the second stage of CPR is
+ * used on its own.
+ */
+template<class TypeTag, class MyTypeTag>
+struct UseCprPreconditioner { using type = UndefinedProperty; };
+
+//! The index of the pressure in the primary variables for the CPR preconditioner
+template<class TypeTag, class MyTypeTag>
+struct CprPressureIndex { using type = UndefinedProperty; };
+
+//! The coarsening target of the AMG for the pressure system of the CPR preconditioner
+template<class TypeTag, class MyTypeTag>
+struct CprCoarsenTarget { using type = UndefinedProperty; };
+
 /*!
  * \brief The size of the algebraic overlap of the linear solver.
  *
@@ -49,6 +49,14 @@ public:
         timer_.halt();
         iterations_ = 0;
         converged_ = 0;
+
+        preconditionerTimer_.halt();
+        numPreconditionerSetups_ = 0;
+        numPreconditionerUpdates_ = 0;
+        numPreconditionerReuses_ = 0;
+
+        numMixedPrecisionSolves_ = 0;
+        numPrecisionFallbacks_ = 0;
     }
 
     const Opm::Timer& timer() const
@@ -72,10 +80,90 @@ public:
     void setConverged(bool value)
     { converged_ = value; }
 
+    /*!
+     * \brief The timer which measures the time spend for setting up and updating the
+     *        preconditioner.
+     */
+    const Opm::Timer& preconditionerTimer() const
+    { return preconditionerTimer_; }
+
+    Opm::Timer& preconditionerTimer()
+    { return preconditionerTimer_; }
+
+    /*!
+     * \brief The number of times the preconditioner was set up from scratch.
+     */
+    unsigned numPreconditionerSetups() const
+    { return numPreconditionerSetups_; }
+
+    void incrementPreconditionerSetups()
+    { ++numPreconditionerSetups_; }
+
+    /*!
+     * \brief The number of times the numerical values of the preconditioner were updated
+     *        while its structure was kept.
+     */
+    unsigned numPreconditionerUpdates() const
+    { return numPreconditionerUpdates_; }
+
+    void incrementPreconditionerUpdates()
+    { ++numPreconditionerUpdates_; }
+
+    /*!
+     * \brief The number of times the preconditioner of a previous linear solve was used
+     *        without any modification.
+     */
+    unsigned numPreconditionerReuses() const
+    { return numPreconditionerReuses_; }
+
+    void incrementPreconditionerReuses()
+    { ++numPreconditionerReuses_; }
+
+    /*!
+     * \brief The fraction of the requests for a preconditioner which could be served by
+     *        an unmodified preconditioner of a previous linear solve.
+     */
+    double preconditionerReuseRate() const
+    {
+        unsigned numRequests =
+            numPreconditionerSetups_ + numPreconditionerUpdates_ + numPreconditionerReuses_;
+        if (numRequests == 0)
+            return 0.0;
+        return static_cast<double>(numPreconditionerReuses_)/numRequests;
+    }
+
+    /*!
+     * \brief The number of linear solves which used a preconditioner in the precision of
+     *        the linear solver for a Krylov iteration in the precision of the model.
+     */
+    unsigned numMixedPrecisionSolves() const
+    { return numMixedPrecisionSolves_; }
+
+    void incrementMixedPrecisionSolves()
+    { ++numMixedPrecisionSolves_; }
+
+    /*!
+     * \brief The number of mixed precision solves which did not converge and thus had to
+     *        be repeated in the precision of the model.
+     */
+    unsigned numPrecisionFallbacks() const
+    { return numPrecisionFallbacks_; }
+
+    void incrementPrecisionFallbacks()
+    { ++numPrecisionFallbacks_; }
+
 private:
     Opm::Timer timer_;
     unsigned iterations_;
     bool converged_;
+
+    Opm::Timer preconditionerTimer_;
+    unsigned numPreconditionerSetups_;
+    unsigned numPreconditionerUpdates_;
+    unsigned numPreconditionerReuses_;
+
+    unsigned numMixedPrecisionSolves_;
+    unsigned numPrecisionFallbacks_;
 };
 
 }} // end namespace Linear, Opm
@@ -32,6 +32,10 @@
 
 #include <dune/common/fmatrix.hh>
 
+#include "blockkernels.hh"
+
+#include <algorithm>
+
 namespace Opm {
 namespace MatrixBlockHelp {
 
@@ -204,6 +208,14 @@ static inline void invertMatrix(Dune::FieldMatrix<K, 4, 4>& matrix)
     else
         matrix *= 1.0/det;
 }
+
+template <typename K>
+static inline void invertMatrix(Dune::FieldMatrix<K, 5, 5>& matrix)
+{ blockInvert<K, 5>(&matrix[0][0]); }
+
+template <typename K>
+static inline void invertMatrix(Dune::FieldMatrix<K, 6, 6>& matrix)
+{ blockInvert<K, 6>(&matrix[0][0]); }
 } // namespace MatrixBlockHelp
 
 template <class Scalar, int n, int m>
@@ -213,8 +225,22 @@ public:
     using BaseType = Dune::FieldMatrix<Scalar, n, m> ;
 
     using BaseType::operator= ;
+    using BaseType::operator+= ;
+    using BaseType::operator-= ;
     using BaseType::rows;
     using BaseType::cols;
+    using BaseType::mv;
+    using BaseType::umv;
+    using BaseType::mmv;
+    using BaseType::usmv;
+    using BaseType::rightmultiply;
+
+    using DomainVector = Dune::FieldVector<Scalar, m>;
+    using RangeVector = Dune::FieldVector<Scalar, n>;
+
+    // the block kernels operate on the raw storage of the block
+    static_assert(sizeof(BaseType) == n*m*sizeof(Scalar),
+                  "The entries of a matrix block must be stored contiguously");
 
     MatrixBlock()
         : BaseType(Scalar(0.0))
@@ -227,11 +253,88 @@ public:
     void invert()
     { Opm::MatrixBlockHelp::invertMatrix(asBase()); }
 
+    //! y = A*x
+    void mv(const DomainVector& x, RangeVector& y) const
+    {
+        if constexpr (MatrixBlockHelp::useBlockKernels<n, m>())
+            MatrixBlockHelp::blockMv<Scalar, n, m>(data_(), &x[0], &y[0]);
+        else
+            BaseType::mv(x, y);
+    }
+
+    //! y += A*x
+    void umv(const DomainVector& x, RangeVector& y) const
+    {
+        if constexpr (MatrixBlockHelp::useBlockKernels<n, m>())
+            MatrixBlockHelp::blockUsmv<Scalar, n, m>(1.0, data_(), &x[0], &y[0]);
+        else
+            BaseType::umv(x, y);
+    }
+
+    //! y -= A*x
+    void mmv(const DomainVector& x, RangeVector& y) const
+    {
+        if constexpr (MatrixBlockHelp::useBlockKernels<n, m>())
+            MatrixBlockHelp::blockUsmv<Scalar, n, m>(-1.0, data_(), &x[0], &y[0]);
+        else
+            BaseType::mmv(x, y);
+    }
+
+    //! y += alpha*A*x
+    void usmv(const Scalar alpha, const DomainVector& x, RangeVector& y) const
+    {
+        if constexpr (MatrixBlockHelp::useBlockKernels<n, m>())
+            MatrixBlockHelp::blockUsmv<Scalar, n, m>(alpha, data_(), &x[0], &y[0]);
+        else
+            BaseType::usmv(alpha, x, y);
+    }
+
+    //! A = A*B
+    MatrixBlock& rightmultiply(const Dune::FieldMatrix<Scalar, m, m>& B)
+    {
+        if constexpr (MatrixBlockHelp::useBlockKernels<n, m>()) {
+            Scalar tmp[n*m];
+            MatrixBlockHelp::blockMatMul<Scalar, n, m, m>(data_(), &B[0][0], tmp);
+            std::copy(tmp, tmp + n*m, data_());
+        }
+        else
+            BaseType::rightmultiply(B);
+
+        return *this;
+    }
+
+    MatrixBlock& operator+=(const MatrixBlock& other)
+    {
+        if constexpr (MatrixBlockHelp::useBlockKernels<n, m>())
+            MatrixBlockHelp::blockAxpy<Scalar, n*m>(1.0, other.data_(), data_());
+        else
+            BaseType::operator+=(other.asBase());
+
+        return *this;
+    }
+
+    MatrixBlock& operator-=(const MatrixBlock& other)
+    {
+        if constexpr (MatrixBlockHelp::useBlockKernels<n, m>())
+            MatrixBlockHelp::blockAxpy<Scalar, n*m>(-1.0, other.data_(), data_());
+        else
+            BaseType::operator-=(other.asBase());
+
+        return *this;
+    }
+
     const BaseType& asBase() const
     { return static_cast<const BaseType&>(*this); }
 
     BaseType& asBase()
     { return static_cast<BaseType&>(*this); }
+
+private:
+    const Scalar* data_() const
+    { return &(*this)[0][0]; }
+
+    Scalar* data_()
+    { return &(*this)[0][0]; }
 };
 
 } // namespace Opm
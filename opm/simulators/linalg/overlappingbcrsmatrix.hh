@@ -30,6 +30,7 @@
 #include <opm/simulators/linalg/domesticoverlapfrombcrsmatrix.hh>
 #include <opm/simulators/linalg/globalindices.hh>
 #include <opm/simulators/linalg/blacklist.hh>
+#include <opm/simulators/linalg/blockkernels.hh>
 #include <opm/models/parallel/mpibuffer.hh>
 
 #include <opm/material/common/Valgrind.hpp>
@@ -38,7 +39,7 @@
 #include <dune/istl/io.hh>
 
 #include <algorithm>
-#include <set>
+#include <cassert>
 #include <map>
 #include <iostream>
 #include <vector>
@@ -59,7 +60,9 @@ public:
     using Overlap = Opm::Linear::DomesticOverlapFromBCRSMatrix;
 
 private:
-    using Entries = std::vector<std::set<Index> >;
+    // the column indices of each row. these are collected unsorted and are sorted once
+    // all of them are known.
+    using Entries = std::vector<std::vector<Index> >;
 
 public:
     using ColIterator = typename ParentType::ColIterator;
@@ -67,9 +70,21 @@ public:
     using block_type = typename ParentType::block_type;
     using field_type = typename ParentType::field_type;
 
-    // no real copying done at the moment
+    // no real copying done at the moment. the copy cannot be synchronized with the peer
+    // processes, but the entries of a native matrix can be assigned to it.
     OverlappingBCRSMatrix(const OverlappingBCRSMatrix& other)
         : ParentType(other)
+        , myRank_(other.myRank_)
+        , borderRows_(other.borderRows_)
+        , interiorRows_(other.interiorRows_)
+        , identicalLayout_(other.identicalLayout_)
+        , embeddedLayout_(other.embeddedLayout_)
+        , domesticRows_(other.domesticRows_)
+        , lockstepRows_(other.lockstepRows_)
+        , translatedRows_(other.translatedRows_)
+        , translatedColOffsets_(other.translatedColOffsets_)
+        , translatedCols_(other.translatedCols_)
+        , refreshRows_(other.refreshRows_)
     {}
 
     template <class NativeBCRSMatrix>
@@ -89,6 +104,48 @@ public:
         build_(nativeMatrix);
     }
 
+    /*!
+     * \brief Create an overlapping matrix which exhibits the overlap and the sparsity
+     *        pattern of another one but uses a different kind of blocks.
+     *
+     * The overlap is shared with the other matrix, i.e., it is not set up again. The
+     * entries are supposed to be copied from the other matrix after it has been
+     * synchronized, so the new matrix cannot be synchronized with the peer processes
+     * itself.
+     */
+    template <class OtherBCRSMatrix>
+    explicit OverlappingBCRSMatrix(const OverlappingBCRSMatrix<OtherBCRSMatrix>& other)
+        : myRank_(other.myRank_)
+        , overlap_(other.overlap_)
+        , borderRows_(other.borderRows_)
+        , interiorRows_(other.interiorRows_)
+        , identicalLayout_(other.identicalLayout_)
+        , embeddedLayout_(other.embeddedLayout_)
+        , domesticRows_(other.domesticRows_)
+        , lockstepRows_(other.lockstepRows_)
+        , translatedRows_(other.translatedRows_)
+        , translatedColOffsets_(other.translatedColOffsets_)
+        , translatedCols_(other.translatedCols_)
+        , refreshRows_(other.refreshRows_)
+    {
+        size_t numDomestic = other.N();
+        this->setSize(numDomestic, numDomestic);
+        this->setBuildMode(ParentType::random);
+
+        for (unsigned rowIdx = 0; rowIdx < numDomestic; ++rowIdx)
+            this->setrowsize(rowIdx, other[rowIdx].size());
+        this->endrowsizes();
+
+        for (unsigned rowIdx = 0; rowIdx < numDomestic; ++rowIdx) {
+            const auto& row = other[rowIdx];
+            auto colIt = row.begin();
+            const auto& colEndIt = row.end();
+            for (; colIt != colEndIt; ++colIt)
+                this->addindex(rowIdx, colIt.index());
+        }
+        this->endindices();
+    }
+
     // this constructor is required to make the class compatible with the SeqILU class of
     // Dune >= 2.7.
     OverlappingBCRSMatrix(size_t numRows OPM_UNUSED,
@@ -133,6 +190,133 @@ public:
     const Overlap& overlap() const
     { return *overlap_; }
 
+    /*!
+     * \brief Returns true if the overlapping matrix exhibits exactly the same rows and
+     *        the same sparsity pattern as the native matrix it was built from.
+     *
+     * This is the case if the process does not have any peers and no indices are black
+     * listed, i.e., usually for sequential runs.
+     */
+    bool identicalLayout() const
+    { return identicalLayout_; }
+
+    /*!
+     * \brief Returns true if the rows of the native matrix are the leading rows of the
+     *        overlapping matrix and each of them exhibits at least the columns of the
+     *        native row.
+     *
+     * In this case, the native matrix can be assembled directly into the overlapping
+     * one by looking up the entries by their row and column indices. This is the case
+     * if no indices are black listed; the layouts do not need to be identical, i.e.,
+     * the process may have peers. After such an assembly, only the rows of the
+     * domestic overlap and the entries received from the peers are modified by
+     * syncAdd().
+     */
+    bool embeddedLayout() const
+    { return embeddedLayout_; }
+
+    /*!
+     * \brief Returns the domestic indices of the rows which are sent to at least one
+     *        peer process if a vector is synchronized.
+     *
+     * The indices are sorted in ascending order.
+     */
+    const std::vector<unsigned>& borderRows() const
+    { return borderRows_; }
+
+    /*!
+     * \brief Returns the domestic indices of all rows which are not border rows.
+     *
+     * The indices are sorted in ascending order.
+     */
+    const std::vector<unsigned>& interiorRows() const
+    { return interiorRows_; }
+
+    /*!
+     * \brief Compute y = A*x.
+     *
+     * For small blocks, this uses the block-CSR kernel which is selected according to
+     * the capabilities of the CPU.
+     */
+    template <class X, class Y>
+    void mv(const X& x, Y& y) const
+    {
+        if constexpr (MatrixBlockHelp::useBlockCsrKernels<ParentType, X, Y>())
+            MatrixBlockHelp::blockCsrMv(asParent(), /*rowIndices=*/nullptr, this->N(),
+                                        /*alpha=*/1.0, /*add=*/false, x, y);
+        else
+            ParentType::mv(x, y);
+    }
+
+    /*!
+     * \brief Compute y = y + alpha*A*x.
+     */
+    template <class X, class Y>
+    void usmv(const field_type& alpha, const X& x, Y& y) const
+    {
+        if constexpr (MatrixBlockHelp::useBlockCsrKernels<ParentType, X, Y>())
+            MatrixBlockHelp::blockCsrMv(asParent(), /*rowIndices=*/nullptr, this->N(),
+                                        alpha, /*add=*/true, x, y);
+        else
+            ParentType::usmv(alpha, x, y);
+    }
+
+    /*!
+     * \brief Compute y = A*x for a subset of the rows of the matrix.
+     *
+     * The entries of y for rows which are not contained in the subset are left
+     * untouched.
+     */
+    template <class X, class Y>
+    void mvRows(const std::vector<unsigned>& rowIndices, const X& x, Y& y) const
+    {
+        if constexpr (MatrixBlockHelp::useBlockCsrKernels<ParentType, X, Y>()) {
+            MatrixBlockHelp::blockCsrMv(asParent(), rowIndices.data(), rowIndices.size(),
+                                        /*alpha=*/1.0, /*add=*/false, x, y);
+            return;
+        }
+
+        for (unsigned rowIdx : rowIndices) {
+            auto& yRow = y[rowIdx];
+            yRow = 0.0;
+
+            const auto& row = (*this)[rowIdx];
+            auto colIt = row.begin();
+            const auto& colEndIt = row.end();
+            for (; colIt != colEndIt; ++colIt)
+                colIt->umv(x[colIt.index()], yRow);
+        }
+    }
+
+    /*!
+     * \brief Compute y = y + alpha*A*x for a subset of the rows of the matrix.
+     *
+     * The entries of y for rows which are not contained in the subset are left
+     * untouched.
+     */
+    template <class X, class Y>
+    void usmvRows(const field_type& alpha,
+                  const std::vector<unsigned>& rowIndices,
+                  const X& x,
+                  Y& y) const
+    {
+        if constexpr (MatrixBlockHelp::useBlockCsrKernels<ParentType, X, Y>()) {
+            MatrixBlockHelp::blockCsrMv(asParent(), rowIndices.data(), rowIndices.size(),
+                                        alpha, /*add=*/true, x, y);
+            return;
+        }
+
+        for (unsigned rowIdx : rowIndices) {
+            auto& yRow = y[rowIdx];
+
+            const auto& row = (*this)[rowIdx];
+            auto colIt = row.begin();
+            const auto& colEndIt = row.end();
+            for (; colIt != colEndIt; ++colIt)
+                colIt->usmv(alpha, x[colIt.index()], yRow);
+        }
+    }
+
     /*!
      * \brief Assign and syncronize the overlapping matrix from a non-overlapping one.
      */
@@ -217,46 +401,71 @@ public:
                                 "row");
     }
 
+    /*!
+     * \brief Copy the entries of the non-overlapping matrix to the overlapping one.
+     *
+     * The native matrix must exhibit the same sparsity pattern as the one which was
+     * used to construct the overlapping matrix. The rows which exhibit the same pattern
+     * in both matrices are copied without translating any indices. Only the remaining
+     * ones, i.e., the rows of the domestic overlap and some of the border rows, are
+     * reset and assigned by looking up the domestic column indices.
+     *
+     * If the native matrix is the overlapping matrix itself, nothing needs to be done.
+     */
     template <class NativeBCRSMatrix>
     void assignFromNative(const NativeBCRSMatrix& nativeMatrix)
     {
-        // first, set everything to 0,
-        BCRSMatrix::operator=(0.0);
+        if (static_cast<const void*>(&nativeMatrix) == static_cast<const void*>(&asParent()))
+            // the entries have been assembled in place
+            return;
 
-        // then copy the domestic entries of the native matrix to the overlapping matrix
-        for (unsigned nativeRowIdx = 0; nativeRowIdx < nativeMatrix.N(); ++nativeRowIdx) {
-            Index domesticRowIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeRowIdx));
-            if (domesticRowIdx < 0) {
-                continue; // row corresponds to a black-listed entry
-            }
+        if (identicalLayout_) {
+            // the overlapping matrix is a copy of the native one, so there is no need
+            // to translate any indices
+            assert(nativeMatrix.N() == this->N() && nativeMatrix.nonzeroes() == this->nonzeroes());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int rowIdx = 0; rowIdx < static_cast<int>(nativeMatrix.N()); ++rowIdx)
+                copyRow_(nativeMatrix[static_cast<unsigned>(rowIdx)],
+                         (*this)[static_cast<unsigned>(rowIdx)]);
+            return;
+        }
 
-            auto nativeColIt = nativeMatrix[nativeRowIdx].begin();
-            const auto& nativeColEndIt = nativeMatrix[nativeRowIdx].end();
-            for (; nativeColIt != nativeColEndIt; ++nativeColIt) {
-                Index domesticColIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeColIt.index()));
+        assert(nativeMatrix.N() == domesticRows_.size());
 
-                // make sure to include all off-diagonal entries, even those which belong
-                // to DOFs which are managed by a peer process. For this, we have to
-                // re-map the column index of the black-listed index to a native one.
-                if (domesticColIdx < 0)
-                    domesticColIdx = overlap_->blackList().nativeToDomestic(static_cast<Index>(nativeColIt.index()));
+        // reset the rows which are not completely determined by the native matrix
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < static_cast<int>(refreshRows_.size()); ++i)
+            (*this)[refreshRows_[static_cast<unsigned>(i)]] = 0.0;
 
-                if (domesticColIdx < 0)
-                    // there is no domestic index which corresponds to a black-listed
-                    // one. this can happen if the grid overlap is larger than the
-                    // algebraic one...
-                    continue;
+        // copy the rows which exhibit the same pattern in both matrices
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < static_cast<int>(lockstepRows_.size()); ++i) {
+            unsigned nativeRowIdx = lockstepRows_[static_cast<unsigned>(i)];
+            unsigned domesticRowIdx = static_cast<unsigned>(domesticRows_[nativeRowIdx]);
+            copyRow_(nativeMatrix[nativeRowIdx], (*this)[domesticRowIdx]);
+        }
 
-                // we need to copy the block matrices manually since it seems that (at
-                // least some versions of) Dune have an endless recursion bug when
-                // assigning dense matrices of different field type
-                const auto& src = *nativeColIt;
-                auto& dest = (*this)[static_cast<unsigned>(domesticRowIdx)][static_cast<unsigned>(domesticColIdx)];
-                for (unsigned i = 0; i < src.rows; ++i) {
-                    for (unsigned j = 0; j < src.cols; ++j) {
-                        dest[i][j] = static_cast<field_type>(src[i][j]);
-                    }
-                }
+        // copy the remaining rows using the precomputed domestic column indices
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < static_cast<int>(translatedRows_.size()); ++i) {
+            unsigned nativeRowIdx = translatedRows_[static_cast<unsigned>(i)];
+            auto& row = (*this)[static_cast<unsigned>(domesticRows_[nativeRowIdx])];
+            size_t entryIdx = translatedColOffsets_[static_cast<unsigned>(i)];
+            const auto& nativeRow = nativeMatrix[nativeRowIdx];
+            auto nativeColIt = nativeRow.begin();
+            const auto& nativeColEndIt = nativeRow.end();
+            for (; nativeColIt != nativeColEndIt; ++nativeColIt, ++entryIdx) {
+                Index domesticColIdx = translatedCols_[entryIdx];
+                if (domesticColIdx >= 0)
+                    copyBlock_(*nativeColIt, row[static_cast<unsigned>(domesticColIdx)]);
             }
         }
     }
@@ -323,6 +532,9 @@ public:
     }
 
 private:
+    template <class OtherBCRSMatrix>
+    friend class OverlappingBCRSMatrix;
+
     template <class NativeBCRSMatrix>
     void build_(const NativeBCRSMatrix& nativeMatrix)
     {
@@ -334,6 +546,187 @@ private:
 
         // communicate the entries
         buildIndices_(nativeMatrix);
+
+        // split the rows into the ones which are required by peer processes and the
+        // remaining ones
+        buildRowSets_();
+
+        // determine how the entries of the native matrix are assigned
+        buildAssignmentMap_(nativeMatrix);
+    }
+
+    void buildRowSets_()
+    {
+        size_t numDomestic = overlap_->numDomestic();
+        std::vector<bool> isBorderRow(numDomestic, false);
+        for (const auto peerRank : overlap_->peerSet()) {
+            size_t numEntries = overlap_->foreignOverlapSize(peerRank);
+            for (unsigned i = 0; i < numEntries; ++i) {
+                Index domRowIdx = overlap_->foreignOverlapOffsetToDomesticIdx(peerRank, i);
+                isBorderRow[static_cast<unsigned>(domRowIdx)] = true;
+            }
+        }
+
+        borderRows_.clear();
+        interiorRows_.clear();
+        for (unsigned domRowIdx = 0; domRowIdx < numDomestic; ++domRowIdx) {
+            if (isBorderRow[domRowIdx])
+                borderRows_.push_back(domRowIdx);
+            else
+                interiorRows_.push_back(domRowIdx);
+        }
+    }
+
+    // returns the domestic column index of a native one or -1 if the column is not
+    // known to the overlapping matrix
+    Index nativeToDomesticCol_(unsigned nativeColIdx) const
+    {
+        Index domesticColIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeColIdx));
+
+        // make sure to include all off-diagonal entries, even those which belong to DOFs
+        // which are managed by a peer process. For this, we have to re-map the column
+        // index of the black-listed index to a native one.
+        if (domesticColIdx < 0)
+            domesticColIdx = overlap_->blackList().nativeToDomestic(static_cast<Index>(nativeColIdx));
+
+        // if this is still negative, there is no domestic index which corresponds to a
+        // black-listed one. this can happen if the grid overlap is larger than the
+        // algebraic one...
+        return domesticColIdx;
+    }
+
+    template <class NativeBCRSMatrix>
+    void buildAssignmentMap_(const NativeBCRSMatrix& nativeMatrix)
+    {
+        size_t numNative = nativeMatrix.N();
+        size_t numLocal = overlap_->numLocal();
+        size_t numDomestic = overlap_->numDomestic();
+
+        // find out which native rows can be copied without translating their column
+        // indices. this requires the domestic row to be local and to exhibit exactly the
+        // columns of the native row in the same order.
+        domesticRows_.resize(numNative);
+        std::vector<unsigned char> isLockstepRow(numNative, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int nativeRowIdx = 0; nativeRowIdx < static_cast<int>(numNative); ++nativeRowIdx) {
+            Index domesticRowIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeRowIdx));
+            domesticRows_[static_cast<unsigned>(nativeRowIdx)] = domesticRowIdx;
+            if (domesticRowIdx < 0 || static_cast<size_t>(domesticRowIdx) >= numLocal)
+                continue;
+
+            const auto& nativeRow = nativeMatrix[static_cast<unsigned>(nativeRowIdx)];
+            const auto& row = (*this)[static_cast<unsigned>(domesticRowIdx)];
+            if (nativeRow.size() != row.size())
+                continue;
+
+            bool lockstep = true;
+            auto colIt = row.begin();
+            auto nativeColIt = nativeRow.begin();
+            const auto& nativeColEndIt = nativeRow.end();
+            for (; lockstep && nativeColIt != nativeColEndIt; ++nativeColIt, ++colIt)
+                lockstep = nativeToDomesticCol_(static_cast<unsigned>(nativeColIt.index()))
+                    == static_cast<Index>(colIt.index());
+            isLockstepRow[static_cast<unsigned>(nativeRowIdx)] = lockstep;
+        }
+
+        // the domestic overlap and the rows which cannot be copied in lockstep are not
+        // completely determined by the native matrix, so they need to be reset before the
+        // native entries are assigned
+        std::vector<unsigned char> isRefreshRow(numDomestic, 0);
+        for (size_t domRowIdx = numLocal; domRowIdx < numDomestic; ++domRowIdx)
+            isRefreshRow[domRowIdx] = 1;
+
+        lockstepRows_.clear();
+        translatedRows_.clear();
+        translatedColOffsets_.assign(1, 0);
+        translatedCols_.clear();
+        for (unsigned nativeRowIdx = 0; nativeRowIdx < numNative; ++nativeRowIdx) {
+            Index domesticRowIdx = domesticRows_[nativeRowIdx];
+            if (domesticRowIdx < 0)
+                continue; // row corresponds to a black-listed entry
+
+            if (isLockstepRow[nativeRowIdx]) {
+                lockstepRows_.push_back(nativeRowIdx);
+                continue;
+            }
+
+            isRefreshRow[static_cast<unsigned>(domesticRowIdx)] = 1;
+            translatedRows_.push_back(nativeRowIdx);
+            const auto& nativeRow = nativeMatrix[nativeRowIdx];
+            auto nativeColIt = nativeRow.begin();
+            const auto& nativeColEndIt = nativeRow.end();
+            for (; nativeColIt != nativeColEndIt; ++nativeColIt)
+                translatedCols_.push_back(nativeToDomesticCol_(static_cast<unsigned>(nativeColIt.index())));
+            translatedColOffsets_.push_back(translatedCols_.size());
+        }
+
+        refreshRows_.clear();
+        for (unsigned domRowIdx = 0; domRowIdx < numDomestic; ++domRowIdx) {
+            if (isRefreshRow[domRowIdx])
+                refreshRows_.push_back(domRowIdx);
+        }
+
+        // if there are no peers and all rows can be copied in lockstep, the overlapping
+        // matrix exhibits exactly the same layout as the native one and the tables are
+        // not needed
+        identicalLayout_ =
+            overlap_->peerSet().empty()
+            && numNative == numDomestic
+            && refreshRows_.empty()
+            && lockstepRows_.size() == numNative;
+        for (unsigned rowIdx = 0; identicalLayout_ && rowIdx < numNative; ++rowIdx)
+            identicalLayout_ = domesticRows_[rowIdx] == static_cast<Index>(rowIdx);
+
+        // the native matrix is embedded into the overlapping one if each native row is
+        // the domestic row with the same index and none of its columns got lost. since
+        // the columns of the lockstep rows are identical, only the translated ones need
+        // to be checked.
+        embeddedLayout_ = numNative <= numDomestic;
+        for (unsigned rowIdx = 0; embeddedLayout_ && rowIdx < numNative; ++rowIdx)
+            embeddedLayout_ = domesticRows_[rowIdx] == static_cast<Index>(rowIdx);
+        for (size_t i = 0; embeddedLayout_ && i < translatedRows_.size(); ++i) {
+            unsigned nativeRowIdx = translatedRows_[i];
+            const auto& nativeRow = nativeMatrix[nativeRowIdx];
+            auto nativeColIt = nativeRow.begin();
+            const auto& nativeColEndIt = nativeRow.end();
+            size_t entryIdx = translatedColOffsets_[i];
+            for (; embeddedLayout_ && nativeColIt != nativeColEndIt; ++nativeColIt, ++entryIdx)
+                embeddedLayout_ =
+                    translatedCols_[entryIdx] == static_cast<Index>(nativeColIt.index());
+        }
+
+        if (identicalLayout_) {
+            domesticRows_.clear();
+            lockstepRows_.clear();
+            translatedColOffsets_.clear();
+        }
+    }
+
+    // copy the entries of a native row to a row of the overlapping matrix which exhibits
+    // the same columns
+    template <class NativeRow, class Row>
+    static void copyRow_(const NativeRow& nativeRow, Row& row)
+    {
+        auto colIt = row.begin();
+        auto nativeColIt = nativeRow.begin();
+        const auto& nativeColEndIt = nativeRow.end();
+        for (; nativeColIt != nativeColEndIt; ++nativeColIt, ++colIt)
+            copyBlock_(*nativeColIt, *colIt);
+    }
+
+    // we need to copy the block matrices manually since it seems that (at least some
+    // versions of) Dune have an endless recursion bug when assigning dense matrices of
+    // different field type
+    template <class NativeBlock>
+    static void copyBlock_(const NativeBlock& src, block_type& dest)
+    {
+        for (unsigned i = 0; i < src.rows; ++i) {
+            for (unsigned j = 0; j < src.cols; ++j) {
+                dest[i][j] = static_cast<field_type>(src[i][j]);
+            }
+        }
     }
 
     template <class NativeBCRSMatrix>
@@ -343,13 +736,22 @@ private:
         // first, add all local matrix entries
         /////////
         entries_.resize(overlap_->numDomestic());
-        for (unsigned nativeRowIdx = 0; nativeRowIdx < nativeMatrix.N(); ++nativeRowIdx) {
+
+        // each native row corresponds to a different domestic one, so the rows can be
+        // processed concurrently
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int nativeRowIdx = 0; nativeRowIdx < static_cast<int>(nativeMatrix.N()); ++nativeRowIdx) {
             int domesticRowIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeRowIdx));
             if (domesticRowIdx < 0)
                 continue;
 
-            auto nativeColIt = nativeMatrix[nativeRowIdx].begin();
-            const auto& nativeColEndIt = nativeMatrix[nativeRowIdx].end();
+            auto& colIndices = entries_[static_cast<unsigned>(domesticRowIdx)];
+            const auto& nativeRow = nativeMatrix[static_cast<unsigned>(nativeRowIdx)];
+            colIndices.reserve(nativeRow.size());
+            auto nativeColIt = nativeRow.begin();
+            const auto& nativeColEndIt = nativeRow.end();
             for (; nativeColIt != nativeColEndIt; ++nativeColIt) {
                 int domesticColIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeColIt.index()));
 
@@ -363,7 +765,7 @@ private:
                 if (domesticColIdx < 0)
                     continue;
 
-                entries_[static_cast<unsigned>(domesticRowIdx)].insert(domesticColIdx);
+                colIndices.push_back(domesticColIdx);
             }
         }
 
@@ -407,38 +809,26 @@ private:
         // actually initialize the BCRS matrix structure
         /////////
 
-        // set the row sizes
+        // remove the duplicate column indices which stem from the peers
         size_t numDomestic = overlap_->numDomestic();
-        for (unsigned rowIdx = 0; rowIdx < numDomestic; ++rowIdx) {
-            unsigned numCols = 0;
-            const auto& colIndices = entries_[rowIdx];
-            auto colIdxIt = colIndices.begin();
-            const auto& colIdxEndIt = colIndices.end();
-            for (; colIdxIt != colIdxEndIt; ++colIdxIt) {
-                if (*colIdxIt < 0)
-                    // the matrix for the local process does not know about this DOF
-                    continue;
-
-                ++numCols;
-            }
-
-            this->setrowsize(rowIdx, numCols);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int rowIdx = 0; rowIdx < static_cast<int>(numDomestic); ++rowIdx) {
+            auto& colIndices = entries_[static_cast<unsigned>(rowIdx)];
+            std::sort(colIndices.begin(), colIndices.end());
+            colIndices.erase(std::unique(colIndices.begin(), colIndices.end()), colIndices.end());
         }
+
+        // set the row sizes
+        for (unsigned rowIdx = 0; rowIdx < numDomestic; ++rowIdx)
+            this->setrowsize(rowIdx, entries_[rowIdx].size());
         this->endrowsizes();
 
         // set the indices
         for (unsigned rowIdx = 0; rowIdx < numDomestic; ++rowIdx) {
-            const auto& colIndices = entries_[rowIdx];
-
-            auto colIdxIt = colIndices.begin();
-            const auto& colIdxEndIt = colIndices.end();
-            for (; colIdxIt != colIdxEndIt; ++colIdxIt) {
-                if (*colIdxIt < 0)
-                    // the matrix for the local process does not know about this DOF
-                    continue;
-
-                this->addindex(rowIdx, static_cast<unsigned>(*colIdxIt));
-            }
+            for (Index colIdx : entries_[rowIdx])
+                this->addindex(rowIdx, static_cast<unsigned>(colIdx));
         }
         this->endindices();
 
@@ -463,18 +853,30 @@ private:
         rowIndicesSendBuff_[peerRank] = new MpiBuffer<Index>(numOverlapRows);
         rowSizesSendBuff_[peerRank] = new MpiBuffer<unsigned>(numOverlapRows);
 
-        // compute the sets of the indices of the entries which need to be send to the peer
-        using ColumnIndexSet = std::set<int>;
-        using EntryTuples = std::map<int, ColumnIndexSet>;
-
-        EntryTuples entryIndices;
-        unsigned numEntries = 0; // <- total number of matrix entries to be send to the peer
+        // compute the global indices of the entries which need to be send to the peer. the
+        // column indices of each overlap row are stored contiguously in the order of the
+        // rows.
+        std::vector<unsigned> rowOffsets(numOverlapRows + 1, 0);
         for (unsigned overlapOffset = 0; overlapOffset < numOverlapRows; ++overlapOffset) {
             Index domesticRowIdx = overlap_->foreignOverlapOffsetToDomesticIdx(peerRank, overlapOffset);
             Index nativeRowIdx = overlap_->domesticToNative(domesticRowIdx);
-            Index globalRowIdx = overlap_->domesticToGlobal(domesticRowIdx);
+            rowOffsets[overlapOffset + 1] =
+                rowOffsets[overlapOffset]
+                + static_cast<unsigned>(nativeMatrix[static_cast<unsigned>(nativeRowIdx)].size());
+        }
+
+        std::vector<Index> colIndices(rowOffsets[numOverlapRows]);
+        std::vector<unsigned> numRowEntries(numOverlapRows);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int overlapOffset = 0; overlapOffset < static_cast<int>(numOverlapRows); ++overlapOffset) {
+            Index domesticRowIdx =
+                overlap_->foreignOverlapOffsetToDomesticIdx(peerRank, static_cast<unsigned>(overlapOffset));
+            Index nativeRowIdx = overlap_->domesticToNative(domesticRowIdx);
 
-            ColumnIndexSet& colIndices = entryIndices[globalRowIdx];
+            auto rowColIt = colIndices.begin() + rowOffsets[static_cast<unsigned>(overlapOffset)];
+            auto rowColBeginIt = rowColIt;
 
             auto nativeColIt = nativeMatrix[static_cast<unsigned>(nativeRowIdx)].begin();
             const auto& nativeColEndIt = nativeMatrix[static_cast<unsigned>(nativeRowIdx)].end();
@@ -493,30 +895,33 @@ private:
                     // entry.
                     continue;
 
-                Index globalColIdx = overlap_->domesticToGlobal(domesticColIdx);
-                colIndices.insert(globalColIdx);
-                ++numEntries;
+                *rowColIt = overlap_->domesticToGlobal(domesticColIdx);
+                ++rowColIt;
             }
-        };
+
+            std::sort(rowColBeginIt, rowColIt);
+            numRowEntries[static_cast<unsigned>(overlapOffset)] =
+                static_cast<unsigned>(rowColIt - rowColBeginIt);
+        }
 
         // fill the send buffers
+        unsigned numEntries = 0; // <- total number of matrix entries to be send to the peer
+        for (unsigned overlapOffset = 0; overlapOffset < numOverlapRows; ++overlapOffset)
+            numEntries += numRowEntries[overlapOffset];
+
         entryColIndicesSendBuff_[peerRank] = new MpiBuffer<Index>(numEntries);
-        Index overlapEntryIdx = 0;
+        auto& rowIndicesSendBuff = *rowIndicesSendBuff_[peerRank];
+        auto& rowSizesSendBuff = *rowSizesSendBuff_[peerRank];
+        auto& entryColIndicesSendBuff = *entryColIndicesSendBuff_[peerRank];
+        unsigned overlapEntryIdx = 0;
         for (unsigned overlapOffset = 0; overlapOffset < numOverlapRows; ++overlapOffset) {
             Index domesticRowIdx = overlap_->foreignOverlapOffsetToDomesticIdx(peerRank, overlapOffset);
-            Index globalRowIdx = overlap_->domesticToGlobal(domesticRowIdx);
-
-            (*rowIndicesSendBuff_[peerRank])[overlapOffset] = globalRowIdx;
-
-            const ColumnIndexSet& colIndexSet = entryIndices[globalRowIdx];
-            auto* rssb = rowSizesSendBuff_[peerRank];
-            (*rssb)[overlapOffset] = static_cast<unsigned>(colIndexSet.size());
-            for (auto it = colIndexSet.begin(); it != colIndexSet.end(); ++it) {
-                int globalColIdx = *it;
+            rowIndicesSendBuff[overlapOffset] = overlap_->domesticToGlobal(domesticRowIdx);
+            rowSizesSendBuff[overlapOffset] = numRowEntries[overlapOffset];
 
-                (*entryColIndicesSendBuff_[peerRank])[static_cast<unsigned>(overlapEntryIdx)] = globalColIdx;
-                ++ overlapEntryIdx;
-            }
+            unsigned rowOffset = rowOffsets[overlapOffset];
+            for (unsigned i = 0; i < numRowEntries[overlapOffset]; ++i)
+                entryColIndicesSendBuff[overlapEntryIdx++] = colIndices[rowOffset + i];
         }
 
         // actually communicate with the peer
@@ -572,7 +977,9 @@ private:
             Index domRowIdx = (*rowIndicesRecvBuff_[peerRank])[i];
             for (unsigned j = 0; j < (*rowSizesRecvBuff_[peerRank])[i]; ++j) {
                 Index domColIdx = (*entryColIndicesRecvBuff_[peerRank])[k];
-                entries_[static_cast<unsigned>(domRowIdx)].insert(domColIdx);
+                // the matrix for the local process may not know about this DOF
+                if (domColIdx >= 0)
+                    entries_[static_cast<unsigned>(domRowIdx)].push_back(domColIdx);
                 ++k;
             }
         }
@@ -674,6 +1081,22 @@ private:
     Entries entries_;
     std::shared_ptr<Overlap> overlap_;
 
+    std::vector<unsigned> borderRows_;
+    std::vector<unsigned> interiorRows_;
+
+    // the data required to assign the entries of the native matrix: the domestic row
+    // of each native one, the native rows which can be copied without translating any
+    // indices, the domestic column indices of the entries of all other native rows and
+    // the domestic rows which must be reset before the assignment
+    bool identicalLayout_;
+    bool embeddedLayout_;
+    std::vector<Index> domesticRows_;
+    std::vector<unsigned> lockstepRows_;
+    std::vector<unsigned> translatedRows_;
+    std::vector<size_t> translatedColOffsets_;
+    std::vector<Index> translatedCols_;
+    std::vector<unsigned> refreshRows_;
+
     std::map<ProcessRank, MpiBuffer<unsigned> *> numRowsSendBuff_;
     std::map<ProcessRank, MpiBuffer<unsigned> *> rowSizesSendBuff_;
     std::map<ProcessRank, MpiBuffer<Index> *> rowIndicesSendBuff_;
@@ -38,6 +38,7 @@
 #include <memory>
 #include <map>
 #include <iostream>
+#include <vector>
 
 namespace Opm {
 namespace Linear {
@@ -174,16 +175,8 @@ public:
      */
     void sync()
     {
-        // send all entries to all peers
-        for (const auto peerRank: overlap_->peerSet())
-            sendEntries_(peerRank);
-
-        // recieve all entries to the peers
-        for (const auto peerRank: overlap_->peerSet())
-            receiveFromMaster_(peerRank);
-
-        // wait until we have send everything
-        waitSendFinished_();
+        startSync();
+        finishSync();
     }
 
     /*!
@@ -192,17 +185,43 @@ public:
      */
     void syncAdd()
     {
+        startSync();
+        finishSyncAdd();
+    }
+
+    /*!
+     * \brief Start the synchronization of the block vector with the peer ranks.
+     *
+     * This posts the receive operations for all peers and sends them the current
+     * values of the rows which they overlap. Until the synchronization is completed
+     * using finishSync() or finishSyncAdd(), the rows sent to the peers may be
+     * modified, but the values received from the peers are not yet available. This
+     * allows to overlap the communication with computations.
+     */
+    void startSync()
+    {
+        // post all receives first so that the peers' messages can be delivered directly
+        for (const auto peerRank: overlap_->peerSet())
+            valuesRecvBuff_[peerRank]->startReceive(static_cast<unsigned>(peerRank));
+
         // send all entries to all peers
         for (const auto peerRank: overlap_->peerSet())
             sendEntries_(peerRank);
+    }
 
-        // recieve all entries to the peers
-        for (const auto peerRank: overlap_->peerSet())
-            receiveAdd_(peerRank);
+    /*!
+     * \brief Complete a synchronization started by startSync() by copying the values
+     *        of the rows from their respective master ranks.
+     */
+    void finishSync()
+    { finishReceive_([this](ProcessRank peerRank) { this->receiveFromMaster_(peerRank); }); }
 
-        // wait until we have send everything
-        waitSendFinished_();
-    }
+    /*!
+     * \brief Complete a synchronization started by startSync() by adding up the values
+     *        of the shared rows of all peer ranks.
+     */
+    void finishSyncAdd()
+    { finishReceive_([this](ProcessRank peerRank) { this->receiveAdd_(peerRank); }); }
 
     void print() const
     {
@@ -302,6 +321,34 @@ private:
         values.send(peerRank);
     }
 
+    template <class ProcessValues>
+    void finishReceive_(ProcessValues processValues)
+    {
+#if HAVE_MPI
+        // process the values of the peers in the order in which they arrive
+        recvRequests_.clear();
+        recvPeers_.clear();
+        for (const auto peerRank: overlap_->peerSet()) {
+            recvRequests_.push_back(valuesRecvBuff_[peerRank]->request());
+            recvPeers_.push_back(peerRank);
+        }
+
+        for (size_t i = 0; i < recvRequests_.size(); ++i) {
+            int requestIdx;
+            MPI_Waitany(static_cast<int>(recvRequests_.size()),
+                        recvRequests_.data(),
+                        &requestIdx,
+                        MPI_STATUS_IGNORE);
+            processValues(recvPeers_[static_cast<size_t>(requestIdx)]);
+        }
+#else
+        static_cast<void>(processValues);
+#endif // HAVE_MPI
+
+        // wait until we have send everything
+        waitSendFinished_();
+    }
+
     void waitSendFinished_()
     {
         typename PeerSet::const_iterator peerIt;
@@ -318,12 +365,9 @@ private:
     void receiveFromMaster_(ProcessRank peerRank)
     {
         const MpiBuffer<Index>& indices = *indicesRecvBuff_[peerRank];
-        MpiBuffer<FieldVector>& values = *valuesRecvBuff_[peerRank];
+        const MpiBuffer<FieldVector>& values = *valuesRecvBuff_[peerRank];
 
-        // receive the values from the peer
-        values.receive(peerRank);
-
-        // copy them into the block vector
+        // copy the values received from the peer into the block vector
         for (unsigned j = 0; j < indices.size(); ++j) {
             Index domRowIdx = indices[j];
             if (overlap_->masterRank(domRowIdx) == peerRank) {
@@ -335,10 +379,7 @@ private:
     void receiveAdd_(ProcessRank peerRank)
     {
         const MpiBuffer<Index>& indices = *indicesRecvBuff_[peerRank];
-        MpiBuffer<FieldVector>& values = *valuesRecvBuff_[peerRank];
-
-        // receive the values from the peer
-        values.receive(peerRank);
+        const MpiBuffer<FieldVector>& values = *valuesRecvBuff_[peerRank];
 
         // add up the values of rows on the shared boundary
         for (unsigned j = 0; j < indices.size(); ++j) {
@@ -353,6 +394,12 @@ private:
     std::map<ProcessRank, std::shared_ptr<MpiBuffer<FieldVector> > > valuesSendBuff_;
     std::map<ProcessRank, std::shared_ptr<MpiBuffer<FieldVector> > > valuesRecvBuff_;
 
+#if HAVE_MPI
+    // scratch space for finishReceive_()
+    std::vector<MPI_Request> recvRequests_;
+    std::vector<ProcessRank> recvPeers_;
+#endif // HAVE_MPI
+
     const Overlap *overlap_;
 };
 
@@ -54,19 +54,39 @@ public:
     Dune::SolverCategory::Category category() const override
     { return Dune::SolverCategory::overlapping; }
 
-    //! apply operator to x:  \f$ y = A(x) \f$
+    /*!
+     * \brief apply operator to x:  \f$ y = A(x) \f$
+     *
+     * If the process has peers, the rows of y which are required by them are computed
+     * first, so that the communication can be overlapped with the computation of the
+     * remaining rows.
+     */
     virtual void apply(const DomainVector& x, RangeVector& y) const override
     {
-        A_.mv(x, y);
-        y.sync();
+        if (A_.overlap().peerSet().empty()) {
+            A_.mv(x, y);
+            return;
+        }
+
+        A_.mvRows(A_.borderRows(), x, y);
+        y.startSync();
+        A_.mvRows(A_.interiorRows(), x, y);
+        y.finishSync();
     }
 
     //! apply operator to x, scale and add:  \f$ y = y + \alpha A(x) \f$
     virtual void applyscaleadd(field_type alpha, const DomainVector& x,
                                RangeVector& y) const override
     {
-        A_.usmv(alpha, x, y);
-        y.sync();
+        if (A_.overlap().peerSet().empty()) {
+            A_.usmv(alpha, x, y);
+            return;
+        }
+
+        A_.usmvRows(alpha, A_.borderRows(), x, y);
+        y.startSync();
+        A_.usmvRows(alpha, A_.interiorRows(), x, y);
+        y.finishSync();
     }
 
     //! returns the matrix
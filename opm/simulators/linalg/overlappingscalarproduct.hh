@@ -31,6 +31,14 @@
 #include <dune/common/parallel/mpihelper.hh>
 #include <dune/istl/scalarproducts.hh>
 
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <array>
+#include <cstddef>
+#include <functional>
+
 namespace Opm {
 namespace Linear {
 
@@ -47,6 +55,52 @@ public:
 
     using real_type = typename Dune::ScalarProduct<OverlappingBlockVector>::real_type;
 
+    /*!
+     * \brief The result of a set of scalar products which are globally summed up
+     *        using a single non-blocking reduction.
+     *
+     * The global values are available after wait() has been called. If an object of
+     * this class is destroyed while a reduction is still pending, the destructor waits
+     * for the reduction to complete.
+     */
+    template <std::size_t numDots>
+    class PendingDots
+    {
+        friend class OverlappingScalarProduct;
+
+    public:
+        PendingDots()
+        {
+#if HAVE_MPI
+            request_ = MPI_REQUEST_NULL;
+#endif
+        }
+
+        PendingDots(const PendingDots&) = delete;
+        PendingDots& operator=(const PendingDots&) = delete;
+
+        ~PendingDots()
+        { wait(); }
+
+        /*!
+         * \brief Wait until the global reduction has finished and return its result.
+         */
+        const std::array<field_type, numDots>& wait()
+        {
+#if HAVE_MPI
+            MPI_Wait(&request_, MPI_STATUS_IGNORE);
+#endif
+            return globalValues_;
+        }
+
+    private:
+        std::array<field_type, numDots> localValues_;
+        std::array<field_type, numDots> globalValues_;
+#if HAVE_MPI
+        MPI_Request request_;
+#endif
+    };
+
     //! the kind of computations supported by the operator. Either overlapping or non-overlapping
     Dune::SolverCategory::Category category() const override
     { return Dune::SolverCategory::overlapping; }
@@ -65,6 +119,9 @@ public:
     {
         field_type sum = 0;
         size_t numLocal = overlap_.numLocal();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+:sum)
+#endif
         for (unsigned localIdx = 0; localIdx < numLocal; ++localIdx) {
             if (overlap_.iAmMasterOf(static_cast<int>(localIdx)))
                 sum += x[localIdx] * y[localIdx];
@@ -74,6 +131,57 @@ public:
         return comm_.sum( sum );
     }
 
+    /*!
+     * \brief Start computing several scalar products at once.
+     *
+     * The local contributions of all scalar products (x[i], y[i]) are computed in a
+     * single pass over the vectors and their global sums are then determined using
+     * one non-blocking collective operation. This allows to overlap the communication
+     * with other work, e.g., the application of the linear operator.
+     */
+    template <std::size_t numDots>
+    void startDots(PendingDots<numDots>& result,
+                   const std::array<const OverlappingBlockVector*, numDots>& x,
+                   const std::array<const OverlappingBlockVector*, numDots>& y) const
+    {
+        // make sure that the previous reduction which used the result object has been
+        // finished
+        result.wait();
+
+        // OpenMP can only reduce arrays which are given as an array section
+        field_type localValues[numDots];
+        for (unsigned dotIdx = 0; dotIdx < numDots; ++dotIdx)
+            localValues[dotIdx] = 0.0;
+
+        int numLocal = static_cast<int>(overlap_.numLocal());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+:localValues[:numDots])
+#endif
+        for (int localIdx = 0; localIdx < numLocal; ++localIdx) {
+            if (!overlap_.iAmMasterOf(localIdx))
+                continue;
+
+            unsigned i = static_cast<unsigned>(localIdx);
+            for (unsigned dotIdx = 0; dotIdx < numDots; ++dotIdx)
+                localValues[dotIdx] += (*x[dotIdx])[i] * (*y[dotIdx])[i];
+        }
+
+        for (unsigned dotIdx = 0; dotIdx < numDots; ++dotIdx)
+            result.localValues_[dotIdx] = localValues[dotIdx];
+
+#if HAVE_MPI
+        MPI_Iallreduce(result.localValues_.data(),
+                       result.globalValues_.data(),
+                       static_cast<int>(numDots),
+                       Dune::MPITraits<field_type>::getType(),
+                       Dune::Generic_MPI_Op<field_type, std::plus<field_type> >::get(),
+                       static_cast<MPI_Comm>(comm_),
+                       &result.request_);
+#else
+        result.globalValues_ = result.localValues_;
+#endif
+    }
+
 #if DUNE_VERSION_NEWER(DUNE_ISTL, 2,7)
     real_type norm(const OverlappingBlockVector& x) const override
 #else
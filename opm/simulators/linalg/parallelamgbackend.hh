@@ -188,6 +188,18 @@ protected:
         return amg_;
     }
 
+    std::shared_ptr<AMG> reusePreconditioner_()
+    { return amg_; }
+
+    // recompute the Galerkin products of the coarse levels for the current values of
+    // the matrix. this keeps the aggregates, i.e., the expensive coarsening is skipped.
+    std::shared_ptr<AMG> updatePreconditioner_()
+    {
+        amg_->recalculateHierarchy();
+
+        return amg_;
+    }
+
     void cleanupPreconditioner_()
     { /* nothing to do */ }
 
@@ -198,7 +210,7 @@ protected:
         const auto& gridView = this->simulator_.gridView();
         using CCC = CombinedCriterion<OverlappingVector, decltype(gridView.comm())>;
 
-        Scalar linearSolverTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverTolerance);
+        Scalar linearSolverTolerance = this->relativeTolerance_();
         Scalar linearSolverAbsTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverAbsTolerance);
         if(linearSolverAbsTolerance < 0.0)
             linearSolverAbsTolerance = this->simulator_.model().newtonMethod().tolerance()/100.0;
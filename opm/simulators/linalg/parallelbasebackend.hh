@@ -35,8 +35,13 @@
 #include <opm/simulators/linalg/overlappingoperator.hh>
 #include <opm/simulators/linalg/parallelbasebackend.hh>
 #include <opm/simulators/linalg/istlpreconditionerwrappers.hh>
+#include <opm/simulators/linalg/bicgstabsolver.hh>
+#include <opm/simulators/linalg/pipelinedbicgstabsolver.hh>
+#include <opm/simulators/linalg/combinedcriterion.hh>
+#include <opm/simulators/linalg/linearsolverreport.hh>
 
 #include <opm/models/utils/genericguard.hh>
+#include <opm/models/utils/timerguard.hh>
 #include <opm/models/utils/propertysystem.hh>
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/simulators/linalg/matrixblock.hh>
@@ -47,9 +52,15 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/version.hh>
 
+#include <dune/istl/preconditioners.hh>
+
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <memory>
 #include <iostream>
+#include <limits>
+#include <type_traits>
 
 namespace Opm::Properties {
 
@@ -75,6 +86,102 @@ public:
 
 namespace Opm {
 namespace Linear {
+namespace Detail {
+// detect whether a sequential preconditioner can adapt itself to new entries of the
+// matrix without being set up from scratch
+template <class Preconditioner, class = void>
+struct IsUpdatablePreconditioner : std::false_type {};
+
+template <class Preconditioner>
+struct IsUpdatablePreconditioner<Preconditioner,
+                                 std::void_t<decltype(std::declval<Preconditioner&>().update())> >
+    : std::true_type {};
+
+// applies a preconditioner which works in the precision of the linear solver to vectors
+// which use the precision of the model
+template <class Preconditioner, class SolverVector, class Vector>
+class MixedPrecisionPreconditioner
+{
+public:
+    template <class Overlap>
+    MixedPrecisionPreconditioner(Preconditioner& preconditioner, const Overlap& overlap)
+        : preconditioner_(preconditioner)
+        , x_(overlap)
+        , d_(overlap)
+    {}
+
+    void pre(Vector& x, Vector& b)
+    {
+        convert_(x, x_);
+        convert_(b, d_);
+        preconditioner_.pre(x_, d_);
+        applyChanges_(x_, x);
+        applyChanges_(d_, b);
+    }
+
+    void apply(Vector& x, const Vector& d)
+    {
+        convert_(d, d_);
+        x_ = 0.0;
+        preconditioner_.apply(x_, d_);
+        convert_(x_, x);
+    }
+
+    void post(Vector& x)
+    {
+        convert_(x, x_);
+        preconditioner_.post(x_);
+        applyChanges_(x_, x);
+    }
+
+private:
+    template <class SrcVector, class DestVector>
+    static void convert_(const SrcVector& src, DestVector& dest)
+    {
+        using DestField = typename DestVector::field_type;
+
+        assert(src.size() == dest.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < static_cast<int>(src.size()); ++i) {
+            const auto& srcBlock = src[static_cast<unsigned>(i)];
+            auto& destBlock = dest[static_cast<unsigned>(i)];
+            for (unsigned k = 0; k < srcBlock.size(); ++k)
+                destBlock[k] = static_cast<DestField>(srcBlock[k]);
+        }
+    }
+
+    // write back the modifications which the preconditioner made to a converted vector.
+    // only the difference to the converted original entries is added, so entries which
+    // were not modified keep the precision of the model.
+    template <class SrcVector, class DestVector>
+    static void applyChanges_(const SrcVector& src, DestVector& dest)
+    {
+        using SrcField = typename SrcVector::field_type;
+        using DestField = typename DestVector::field_type;
+
+        assert(src.size() == dest.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < static_cast<int>(src.size()); ++i) {
+            const auto& srcBlock = src[static_cast<unsigned>(i)];
+            auto& destBlock = dest[static_cast<unsigned>(i)];
+            for (unsigned k = 0; k < srcBlock.size(); ++k) {
+                SrcField original = static_cast<SrcField>(destBlock[k]);
+                if (srcBlock[k] != original)
+                    destBlock[k] += static_cast<DestField>(srcBlock[k]) - static_cast<DestField>(original);
+            }
+        }
+    }
+
+    Preconditioner& preconditioner_;
+    SolverVector x_;
+    SolverVector d_;
+};
+} // namespace Detail
+
 /*!
  * \ingroup Linear
  *
@@ -101,6 +208,33 @@ namespace Linear {
  *            that it is computationally cheaper because it does not
  *            need to consider things which are only required for
  *            higher orders
+ * - \c ThreadedSOR, \c ThreadedSSOR: Multi-color variants of the (symmetric) SOR
+ *            preconditioner which use all threads of the process
+ * - \c ThreadedBlockILU0: A block-Jacobi preconditioner using ILU(0) for the blocks
+ *            of the individual threads
+ * - \c LevelScheduledILU0: An ILU(0) preconditioner which parallelizes the
+ *            factorization and the triangular solves using level scheduling
+ * - \c CPR: A two-stage constrained pressure residual preconditioner which combines an
+ *            AMG for the pressure system with a block ILU(0) for the full system
+ *
+ * If the LinearSolverMixedPrecision parameter is set, only the preconditioner is run in
+ * reduced precision: The linear system is solved by a BiCGStab solver (or its pipelined
+ * variant, if the backend uses it) whose Krylov iteration, linear operator and residual
+ * use the model's Scalar type, whereas the matrix of the preconditioner and the
+ * preconditioner itself use LinearSolverScalar. Both matrices share the same algebraic
+ * overlap, so it is only set up once. The entries of the preconditioner's matrix are
+ * converted from the synchronized entries of the operator's one. If this solve does not
+ * converge, the system is solved again using an ILU(0) preconditioner in the precision
+ * of Scalar. The number of mixed precision solves and of these fallbacks is recorded by
+ * the solver summary.
+ *
+ * By default, the preconditioner is set up from scratch for each linear solve. If the
+ * PreconditionerMaxReuse parameter is positive, the preconditioner is kept across linear
+ * solves and it is only refreshed if it was used for the maximum number of solves, if a
+ * new time step begins or if the number of linear iterations grows too much. If the
+ * structure of the linear system did not change, refreshing the preconditioner only
+ * updates its numerical values if the backend supports this. If a linear solve does not
+ * converge using a reused preconditioner, it is repeated using a refreshed one.
  */
 template <class TypeTag>
 class ParallelBaseBackend
@@ -130,20 +264,61 @@ protected:
                                                               OverlappingVector>;
 
     enum { dimWorld = GridView::dimensionworld };
+    enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
+
+    // the data structures used by the Krylov iteration of mixed precision solves and by
+    // the full precision solves they fall back to
+    using NativeMatrix = typename SparseMatrixAdapter::IstlMatrix;
+    using OuterMatrix = Opm::Linear::OverlappingBCRSMatrix<Dune::BCRSMatrix<Opm::MatrixBlock<Scalar, numEq, numEq> > >;
+    using OuterVector = Opm::Linear::OverlappingBlockVector<Dune::FieldVector<Scalar, numEq>, Overlap>;
+    using OuterScalarProduct = Opm::Linear::OverlappingScalarProduct<OuterVector, Overlap>;
+    using OuterOperator = Opm::Linear::OverlappingOperator<OuterMatrix, OuterVector, OuterVector>;
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2,7)
+    using FallbackSequentialPreconditioner = Dune::SeqILU<OuterMatrix, OuterVector, OuterVector>;
+#else
+    using FallbackSequentialPreconditioner = Dune::SeqILU0<OuterMatrix, OuterVector, OuterVector>;
+#endif
+    using FallbackPreconditioner = Opm::Linear::OverlappingPreconditioner<FallbackSequentialPreconditioner, Overlap>;
 
 public:
     ParallelBaseBackend(const Simulator& simulator)
         : simulator_(simulator)
         , gridSequenceNumber_( -1 )
         , lastIterations_( -1 )
+        , preconditionerValid_(false)
+        , solvesSinceRefresh_(0)
+        , refreshTimeStepIdx_(-1)
+        , referenceRate_(0.0)
+        , lastRate_(0.0)
     {
-        overlappingMatrix_ = nullptr;
         overlappingb_ = nullptr;
         overlappingx_ = nullptr;
+
+        isIoRank_ = simulator.gridView().comm().rank() == 0;
+        mixedPrecision_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverMixedPrecision);
+
+        maxPreconditionerReuse_ = EWOMS_GET_PARAM(TypeTag, int, PreconditionerMaxReuse);
+        refreshIterationFactor_ = EWOMS_GET_PARAM(TypeTag, Scalar, PreconditionerRefreshIterationFactor);
+        refreshOnNewTimeStep_ = EWOMS_GET_PARAM(TypeTag, bool, PreconditionerRefreshOnNewTimeStep);
+
+        configuredRelTolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverTolerance);
+        relTolerance_ = configuredRelTolerance_;
     }
 
     ~ParallelBaseBackend()
-    { cleanup_(); }
+    {
+        if (maxPreconditionerReuse_ > 0 && isIoRank_
+            && EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity) > 0)
+            std::cout << "Linear solver: Preconditioner was set up "
+                      << solverSummary_.numPreconditionerSetups() << " times, updated "
+                      << solverSummary_.numPreconditionerUpdates() << " times and reused "
+                      << solverSummary_.numPreconditionerReuses() << " times (reuse rate: "
+                      << 100.0*solverSummary_.preconditionerReuseRate() << "%, setup time: "
+                      << solverSummary_.preconditionerTimer().realTimeElapsed() << " s)\n"
+                      << std::flush;
+
+        cleanup_();
+    }
 
     /*!
      * \brief Register all run-time parameters for the linear solver.
@@ -160,6 +335,21 @@ public:
                              "The maximum number of iterations of the linear solver");
         EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverVerbosity,
                              "The verbosity level of the linear solver");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverMixedPrecision,
+                             "Run the Krylov iteration of the linear solver using the "
+                             "floating point type of the model and the preconditioner "
+                             "using the one of the linear solver");
+        EWOMS_REGISTER_PARAM(TypeTag, int, PreconditionerMaxReuse,
+                             "The maximum number of linear solves for which the "
+                             "preconditioner is reused before it is refreshed (0: set up the "
+                             "preconditioner for each linear solve)");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, PreconditionerRefreshIterationFactor,
+                             "Refresh a reused preconditioner if the number of linear "
+                             "iterations per order of magnitude of residual reduction grows "
+                             "by more than this factor");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, PreconditionerRefreshOnNewTimeStep,
+                             "Refresh a reused preconditioner at the beginning of each "
+                             "time step");
 
         PreconditionerWrapper::registerParameters();
     }
@@ -192,12 +382,28 @@ public:
         BorderListCreator borderListCreator(simulator_.gridView(),
                                             simulator_.model().dofMapper());
 
-        // create the overlapping Jacobian matrix
+        // create the overlapping Jacobian matrix. for mixed precision solves, this is
+        // the matrix of the linear operator which uses the precision of the model, and
+        // the matrix of the preconditioner shares its overlap.
         unsigned overlapSize = EWOMS_GET_PARAM(TypeTag, unsigned, LinearSolverOverlapSize);
-        overlappingMatrix_ = new OverlappingMatrix(M.istlMatrix(),
-                                                   borderListCreator.borderList(),
-                                                   borderListCreator.blackList(),
-                                                   overlapSize);
+        if (mixedPrecision_) {
+            outerMatrix_ = std::make_shared<OuterMatrix>(M.istlMatrix(),
+                                                         borderListCreator.borderList(),
+                                                         borderListCreator.blackList(),
+                                                         overlapSize);
+            outerb_.reset(new OuterVector(outerMatrix_->overlap()));
+            outerx_.reset(new OuterVector(*outerb_));
+
+            if constexpr (std::is_same<OverlappingMatrix, OuterMatrix>::value)
+                overlappingMatrix_ = outerMatrix_;
+            else
+                overlappingMatrix_ = std::make_shared<OverlappingMatrix>(*outerMatrix_);
+        }
+        else
+            overlappingMatrix_ = std::make_shared<OverlappingMatrix>(M.istlMatrix(),
+                                                                     borderListCreator.borderList(),
+                                                                     borderListCreator.blackList(),
+                                                                     overlapSize);
 
         // create the overlapping vectors for the residual and the
         // solution
@@ -207,6 +413,26 @@ public:
         // writeOverlapToVTK_();
     }
 
+    /*!
+     * \copydoc prepare(const SparseMatrixAdapter&, const Vector&)
+     *
+     * If the Jacobian matrix is embedded into the overlapping matrix and both use the
+     * same kind of blocks, the Jacobian is henceforth assembled directly into the
+     * overlapping matrix, i.e., its entries do not need to be copied anymore. This is
+     * also the case for parallel runs as long as no indices are black listed; then only
+     * the entries of the peer processes are added by setMatrix(). For mixed precision
+     * solves, this applies to the matrix of the linear operator.
+     */
+    void prepare(SparseMatrixAdapter& M, const Vector& b)
+    {
+        prepare(static_cast<const SparseMatrixAdapter&>(M), b);
+
+        if (mixedPrecision_)
+            shareJacobian_(M, outerMatrix_);
+        else
+            shareJacobian_(M, overlappingMatrix_);
+    }
+
     /*!
      * \brief Assign values to the internal data structure for the residual vector.
      *
@@ -216,7 +442,10 @@ public:
     {
         // copy the interior values of the non-overlapping residual vector to the
         // overlapping one
-        overlappingb_->assignAddBorder(b);
+        if (mixedPrecision_)
+            outerb_->assignAddBorder(b);
+        else
+            overlappingb_->assignAddBorder(b);
     }
 
     /*!
@@ -227,7 +456,10 @@ public:
     void getResidual(Vector& b) const
     {
         // update the non-overlapping vector with the overlapping one
-        overlappingb_->assignTo(b);
+        if (mixedPrecision_)
+            outerb_->assignTo(b);
+        else
+            overlappingb_->assignTo(b);
     }
 
     /*!
@@ -238,6 +470,17 @@ public:
      */
     void setMatrix(const SparseMatrixAdapter& M)
     {
+        if (mixedPrecision_) {
+            outerMatrix_->assignFromNative(M.istlMatrix());
+            outerMatrix_->syncAdd();
+
+            // both overlapping matrices share the same overlap and sparsity pattern, so
+            // the synchronized entries can be copied without communicating again
+            if (static_cast<const void*>(outerMatrix_.get()) != static_cast<const void*>(overlappingMatrix_.get()))
+                copyEntries_(*outerMatrix_, *overlappingMatrix_);
+            return;
+        }
+
         overlappingMatrix_->assignFromNative(M.istlMatrix());
         overlappingMatrix_->syncAdd();
     }
@@ -248,18 +491,87 @@ public:
      * \return true if the residual reduction could be achieved, else false.
      */
     bool solve(Vector& x)
+    {
+        // release the preconditioner unless the reuse policy allows to keep it. this
+        // also happens if an exception is thrown.
+        auto releasePrecondFn = [this]() -> void
+                                { this->releasePreconditioner_(); };
+        auto releasePrecondGuard = Opm::make_guard(releasePrecondFn);
+
+        bool reusePreconditioner = preconditionerReusable_();
+        bool converged = solve_(x, reusePreconditioner);
+        if (!converged && reusePreconditioner) {
+            // give the linear solver a second chance with a preconditioner which
+            // corresponds to the current matrix
+            if (EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity) > 0 && isIoRank_)
+                std::cout << "Linear solver: No convergence using a reused preconditioner, "
+                          << "retrying with a refreshed one\n" << std::flush;
+            converged = solve_(x, /*reusePreconditioner=*/false);
+        }
+
+        // the convergence rate of the first solve after a refresh is the reference for
+        // deciding whether the reused preconditioner has become too inaccurate. the
+        // rate is the number of iterations per order of magnitude by which the residual
+        // was reduced, so solves with different tolerances can be compared.
+        lastRate_ = static_cast<Scalar>(lastIterations_)/numDecades_(relTolerance_);
+        if (solvesSinceRefresh_ == 0)
+            referenceRate_ = lastRate_;
+
+        releasePrecondGuard.setEnabled(maxPreconditionerReuse_ <= 0);
+        return converged;
+    }
+
+    /*!
+     * \brief Return number of iterations used during last solve.
+     */
+    size_t iterations () const
+    { return lastIterations_; }
+
+    /*!
+     * \brief Set the reduction of the residual which is required by the next linear
+     *        solves.
+     *
+     * This is used by the Newton method to solve the linear systems of its early
+     * iterations less accurately. The tolerance is never made smaller than the one
+     * specified by the LinearSolverTolerance parameter.
+     */
+    void setRelativeTolerance(Scalar tolerance)
+    { relTolerance_ = std::max(tolerance, configuredRelTolerance_); }
+
+    /*!
+     * \brief Return the reduction of the residual which is required by the next linear
+     *        solves.
+     */
+    Scalar relativeTolerance() const
+    { return relTolerance_; }
+
+    /*!
+     * \brief Return statistics about setting up and reusing the preconditioner and about
+     *        mixed precision solves for all linear solves so far.
+     */
+    const SolverReport& solverSummary() const
+    { return solverSummary_; }
+
+protected:
+    Implementation& asImp_()
+    { return *static_cast<Implementation *>(this); }
+
+    const Implementation& asImp_() const
+    { return *static_cast<const Implementation *>(this); }
+
+    bool solve_(Vector& x, bool reusePreconditioner)
     {
 #if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2,7)
         Dune::FMatrixPrecision<LinearSolverScalar>::set_singular_limit(1.e-30);
         Dune::FMatrixPrecision<LinearSolverScalar>::set_absolute_limit(1.e-30);
 #endif
 
+        if (mixedPrecision_)
+            return solveMixedPrecision_(x, reusePreconditioner);
+
         (*overlappingx_) = 0.0;
 
-        auto parPreCond = asImp_().preparePreconditioner_();
-        auto precondCleanupFn = [this]() -> void
-                                { this->asImp_().cleanupPreconditioner_(); };
-        auto precondCleanupGuard = Opm::make_guard(precondCleanupFn);
+        auto parPreCond = obtainPreconditioner_(reusePreconditioner);
         // create the parallel scalar product and the parallel operator
         ParallelScalarProduct parScalarProduct(overlappingMatrix_->overlap());
         ParallelOperator parOperator(*overlappingMatrix_);
@@ -286,29 +598,233 @@ public:
         return result.first;
     }
 
-    /*!
-     * \brief Return number of iterations used during last solve.
-     */
-    size_t iterations () const
-    { return lastIterations_; }
+    // returns true if the preconditioner of the previous linear solve may be used for
+    // the current one
+    bool preconditionerReusable_() const
+    {
+        if (!preconditionerValid_ || maxPreconditionerReuse_ <= 0)
+            return false;
 
-protected:
-    Implementation& asImp_()
-    { return *static_cast<Implementation *>(this); }
+        if (solvesSinceRefresh_ >= maxPreconditionerReuse_)
+            return false;
 
-    const Implementation& asImp_() const
-    { return *static_cast<const Implementation *>(this); }
+        if (refreshOnNewTimeStep_ && simulator_.timeStepIndex() != refreshTimeStepIdx_)
+            return false;
+
+        Scalar maxRate = refreshIterationFactor_*std::max(referenceRate_, Scalar(1.0));
+        return lastRate_ <= maxRate;
+    }
+
+    // returns the number of orders of magnitude by which a linear solve reduces the
+    // residual for a given relative tolerance
+    static Scalar numDecades_(Scalar relTolerance)
+    { return std::max(-std::log10(relTolerance), Scalar(0.1)); }
+
+    // returns the preconditioner for the current linear solve. depending on the reuse
+    // policy, this is the preconditioner of the previous solve, the previous
+    // preconditioner with updated numerical values or a completely new one.
+    auto obtainPreconditioner_(bool reusePreconditioner)
+    {
+        if (reusePreconditioner) {
+            ++solvesSinceRefresh_;
+            solverSummary_.incrementPreconditionerReuses();
+            return asImp_().reusePreconditioner_();
+        }
+
+        Opm::TimerGuard timerGuard(solverSummary_.preconditionerTimer());
+        solverSummary_.preconditionerTimer().start();
+
+        solvesSinceRefresh_ = 0;
+        refreshTimeStepIdx_ = simulator_.timeStepIndex();
+
+        // if the structure of the linear system did not change since the preconditioner
+        // was created, only its numerical values need to be updated. also, the
+        // preconditioner is considered to be invalid until it has been successfully set
+        // up.
+        bool updateOnly = preconditionerValid_;
+        preconditionerValid_ = false;
+        if (updateOnly) {
+            solverSummary_.incrementPreconditionerUpdates();
+            auto parPreCond = asImp_().updatePreconditioner_();
+            preconditionerValid_ = true;
+            return parPreCond;
+        }
+
+        solverSummary_.incrementPreconditionerSetups();
+        auto parPreCond = asImp_().preparePreconditioner_();
+        preconditionerValid_ = true;
+        return parPreCond;
+    }
+
+    void releasePreconditioner_()
+    {
+        if (!preconditionerValid_)
+            return;
+
+        preconditionerValid_ = false;
+        asImp_().cleanupPreconditioner_();
+    }
 
     void cleanup_()
     {
-        // create the overlapping Jacobian matrix and vectors
-        delete overlappingMatrix_;
+        // the preconditioner refers to the overlapping matrix, so it cannot be used
+        // anymore. (derived backends release their own preconditioners lazily.)
+        preconditionerValid_ = false;
+        ParallelBaseBackend::cleanupPreconditioner_();
+
+        // delete the overlapping Jacobian matrix and vectors. (if the Jacobian is
+        // assembled into the overlapping matrix, the linearizer keeps it alive.)
         delete overlappingb_;
         delete overlappingx_;
 
-        overlappingMatrix_ = 0;
+        overlappingMatrix_.reset();
         overlappingb_ = 0;
         overlappingx_ = 0;
+
+        outerMatrix_.reset();
+        outerb_.reset();
+        outerx_.reset();
+    }
+
+    // the tolerances which must be reached by mixed precision solves
+    Scalar relativeTolerance_() const
+    { return relTolerance_; }
+
+    Scalar absoluteTolerance_() const
+    {
+        Scalar absTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverAbsTolerance);
+        if (absTolerance < 0.0)
+            absTolerance = simulator_.model().newtonMethod().tolerance() / 100.0;
+        return absTolerance;
+    }
+
+    // solve the linear system using a Krylov iteration in the precision of the model
+    // which is preconditioned in the precision of the linear solver. if this does not
+    // converge, the system is solved again with a preconditioner in the precision of the
+    // model.
+    bool solveMixedPrecision_(Vector& x, bool reusePreconditioner)
+    {
+        solverSummary_.incrementMixedPrecisionSolves();
+
+        auto parPreCond = obtainPreconditioner_(reusePreconditioner);
+        using SolverPreconditioner = typename decltype(parPreCond)::element_type;
+        using MixedPreconditioner = Detail::MixedPrecisionPreconditioner<SolverPreconditioner,
+                                                                         OverlappingVector,
+                                                                         OuterVector>;
+        MixedPreconditioner mixedPreCond(*parPreCond, overlappingMatrix_->overlap());
+
+        auto result = solveOuter_(mixedPreCond);
+        lastIterations_ = result.second;
+        if (!result.first) {
+            solverSummary_.incrementPrecisionFallbacks();
+            if (EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity) > 0 && isIoRank_)
+                std::cout << "Linear solver: No convergence using the preconditioner in "
+                          << "mixed precision, falling back to full precision ("
+                          << solverSummary_.numPrecisionFallbacks() << " of "
+                          << solverSummary_.numMixedPrecisionSolves()
+                          << " mixed precision solves so far)\n" << std::flush;
+
+            // the factorization is only kept for the duration of the fallback solve. the
+            // matrix of the linear operator is already in the precision of the model.
+            FallbackSequentialPreconditioner seqPreCond(*outerMatrix_, /*relaxationFactor=*/1.0);
+            FallbackPreconditioner fallbackPreCond(seqPreCond, outerMatrix_->overlap());
+
+            result = solveOuter_(fallbackPreCond);
+            lastIterations_ += result.second;
+        }
+
+        outerx_->assignTo(x);
+        return result.first;
+    }
+
+    // run a BiCGStab solver in the precision of the model. the pipelined variant is used
+    // if the backend uses it for the full precision solves as well.
+    template <class Preconditioner>
+    std::pair<bool, int> solveOuter_(Preconditioner& preCond)
+    {
+        OuterScalarProduct scalarProduct(outerMatrix_->overlap());
+        OuterOperator linearOperator(*outerMatrix_);
+
+        const auto& gridView = simulator_.gridView();
+        using CCC = CombinedCriterion<OuterVector, decltype(gridView.comm())>;
+        CCC convCrit(gridView.comm(),
+                     relativeTolerance_(),
+                     absoluteTolerance_(),
+                     /*maxResidual=*/std::numeric_limits<Scalar>::max());
+
+        if (asImp_().usePipelinedSolver_()) {
+            PipelinedBiCGStabSolver<OuterOperator, OuterVector, Preconditioner, OuterScalarProduct>
+                solver(preCond, convCrit, scalarProduct);
+            return runOuterSolver_(solver, linearOperator);
+        }
+
+        BiCGStabSolver<OuterOperator, OuterVector, Preconditioner> solver(preCond, convCrit, scalarProduct);
+        return runOuterSolver_(solver, linearOperator);
+    }
+
+    template <class LinearSolver>
+    std::pair<bool, int> runOuterSolver_(LinearSolver& solver, OuterOperator& linearOperator)
+    {
+        int verbosity = 0;
+        if (isIoRank_)
+            verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
+        solver.setVerbosity(static_cast<unsigned>(verbosity));
+        solver.setMaxIterations(static_cast<unsigned>(EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations)));
+        solver.setLinearOperator(&linearOperator);
+        solver.setRhs(outerb_.get());
+
+        (*outerx_) = 0.0;
+        bool converged = solver.apply(*outerx_);
+
+        return std::make_pair(converged, static_cast<int>(solver.report().iterations()));
+    }
+
+    // backends which use the pipelined BiCGStab solver override this
+    bool usePipelinedSolver_() const
+    { return false; }
+
+    // let the linearizer assemble the Jacobian directly into an overlapping matrix if
+    // the layout of the Jacobian is embedded into it and both use the same kind of
+    // blocks
+    template <class Matrix>
+    void shareJacobian_(SparseMatrixAdapter& M, const std::shared_ptr<Matrix>& matrix)
+    {
+        using IstlAdapter = IstlSparseMatrixAdapter<typename NativeMatrix::block_type,
+                                                    typename NativeMatrix::allocator_type>;
+        if constexpr (std::is_same<SparseMatrixAdapter, IstlAdapter>::value
+                      && std::is_base_of<NativeMatrix, Matrix>::value)
+        {
+            if (!matrix->embeddedLayout() || &M.istlMatrix() == matrix.get())
+                return;
+
+            // the Jacobian has already been assembled, so its current entries must be
+            // preserved
+            matrix->assignFromNative(M.istlMatrix());
+            M.shareIstlMatrix(matrix);
+        }
+    }
+
+    // copy the entries of an overlapping matrix to one which exhibits the same layout but
+    // possibly uses a different floating point type
+    template <class SrcMatrix, class DestMatrix>
+    static void copyEntries_(const SrcMatrix& src, DestMatrix& dest)
+    {
+        using DestField = typename DestMatrix::field_type;
+
+        assert(src.N() == dest.N() && src.nonzeroes() == dest.nonzeroes());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int rowIdx = 0; rowIdx < static_cast<int>(src.N()); ++rowIdx) {
+            const auto& srcRow = src[static_cast<unsigned>(rowIdx)];
+            auto destIt = dest[static_cast<unsigned>(rowIdx)].begin();
+            for (auto srcIt = srcRow.begin(); srcIt != srcRow.end(); ++srcIt, ++destIt) {
+                assert(srcIt.index() == destIt.index());
+                for (unsigned i = 0; i < srcIt->N(); ++i)
+                    for (unsigned j = 0; j < srcIt->M(); ++j)
+                        (*destIt)[i][j] = static_cast<DestField>((*srcIt)[i][j]);
+            }
+        }
     }
 
     std::shared_ptr<ParallelPreconditioner> preparePreconditioner_()
@@ -332,11 +848,63 @@ protected:
             throw Opm::NumericalIssue("Creating the preconditioner failed");
 
         // create the parallel preconditioner
-        return std::make_shared<ParallelPreconditioner>(precWrapper_.get(), overlappingMatrix_->overlap());
+        parPreCond_ = std::make_shared<ParallelPreconditioner>(precWrapper_.get(), overlappingMatrix_->overlap());
+        return parPreCond_;
+    }
+
+    // preconditioners which reference the matrix instead of copying it need to adapt
+    // to its new entries even if they are reused
+    std::shared_ptr<ParallelPreconditioner> reusePreconditioner_()
+    {
+        if constexpr (sequentialPreconditionerUpdatable_())
+            updateSequentialPreconditioner_();
+
+        return parPreCond_;
+    }
+
+    // most ISTL preconditioners cannot be updated without redoing their complete setup
+    std::shared_ptr<ParallelPreconditioner> updatePreconditioner_()
+    {
+        if constexpr (sequentialPreconditionerUpdatable_()) {
+            updateSequentialPreconditioner_();
+            return parPreCond_;
+        }
+
+        cleanupPreconditioner_();
+        return preparePreconditioner_();
+    }
+
+    static constexpr bool sequentialPreconditionerUpdatable_()
+    {
+        using SequentialPreconditioner =
+            std::remove_reference_t<decltype(std::declval<PreconditionerWrapper&>().get())>;
+        return Detail::IsUpdatablePreconditioner<SequentialPreconditioner>::value;
+    }
+
+    void updateSequentialPreconditioner_()
+    {
+        int preconditionerIsReady = 1;
+        try {
+            precWrapper_.get().update();
+        }
+        catch (const Dune::Exception& e) {
+            std::cout << "Preconditioner threw exception \"" << e.what()
+                      << " on rank " << overlappingMatrix_->overlap().myRank()
+                      << "\n"  << std::flush;
+            preconditionerIsReady = 0;
+        }
+
+        preconditionerIsReady = simulator_.gridView().comm().min(preconditionerIsReady);
+        if (!preconditionerIsReady)
+            throw Opm::NumericalIssue("Updating the preconditioner failed");
     }
 
     void cleanupPreconditioner_()
     {
+        if (!parPreCond_)
+            return;
+
+        parPreCond_.reset();
         precWrapper_.cleanup();
     }
 
@@ -381,11 +949,36 @@ protected:
     int gridSequenceNumber_;
     size_t lastIterations_;
 
-    OverlappingMatrix *overlappingMatrix_;
+    std::shared_ptr<OverlappingMatrix> overlappingMatrix_;
     OverlappingVector *overlappingb_;
     OverlappingVector *overlappingx_;
 
     PreconditionerWrapper precWrapper_;
+    std::shared_ptr<ParallelPreconditioner> parPreCond_;
+
+    bool isIoRank_;
+
+    // the linear operator and the vectors of the Krylov iteration of mixed precision
+    // solves. (the preconditioner uses the overlapping matrix.)
+    bool mixedPrecision_;
+    std::shared_ptr<OuterMatrix> outerMatrix_;
+    std::unique_ptr<OuterVector> outerb_;
+    std::unique_ptr<OuterVector> outerx_;
+
+    // the state of the preconditioner reuse policy
+    int maxPreconditionerReuse_;
+    Scalar refreshIterationFactor_;
+    bool refreshOnNewTimeStep_;
+    bool preconditionerValid_;
+    int solvesSinceRefresh_;
+    int refreshTimeStepIdx_;
+    Scalar referenceRate_;
+    Scalar lastRate_;
+    SolverReport solverSummary_;
+
+    // the relative tolerance of the linear solver and its lower bound
+    Scalar relTolerance_;
+    Scalar configuredRelTolerance_;
 };
 }} // namespace Linear, Opm
 
@@ -403,6 +996,34 @@ struct PreconditionerRelaxation<TypeTag, TTag::ParallelBaseLinearSolver>
     static constexpr type value = 1.0;
 };
 
+//! do not solve the linear systems in mixed precision by default
+template<class TypeTag>
+struct LinearSolverMixedPrecision<TypeTag, TTag::ParallelBaseLinearSolver> { static constexpr bool value = false; };
+
+//! set up the preconditioner for each linear solve by default
+template<class TypeTag>
+struct PreconditionerMaxReuse<TypeTag, TTag::ParallelBaseLinearSolver> { static constexpr int value = 0; };
+
+//! refresh a reused preconditioner if the number of linear iterations doubles
+template<class TypeTag>
+struct PreconditionerRefreshIterationFactor<TypeTag, TTag::ParallelBaseLinearSolver>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 2.0;
+};
+
+//! refresh a reused preconditioner at the beginning of each time step by default
+template<class TypeTag>
+struct PreconditionerRefreshOnNewTimeStep<TypeTag, TTag::ParallelBaseLinearSolver> { static constexpr bool value = true; };
+
+//! use the CPR preconditioner if the CPR preconditioner wrapper is selected
+template<class TypeTag>
+struct UseCprPreconditioner<TypeTag, TTag::ParallelBaseLinearSolver> { static constexpr bool value = true; };
+
+//! stop coarsening the pressure system of the CPR preconditioner at 1200 unknowns
+template<class TypeTag>
+struct CprCoarsenTarget<TypeTag, TTag::ParallelBaseLinearSolver> { static constexpr int value = 1200; };
+
 //! set the preconditioner order to 0 by default
 template<class TypeTag>
 struct PreconditionerOrder<TypeTag, TTag::ParallelBaseLinearSolver> { static constexpr int value = 0; };
@@ -30,6 +30,7 @@
 #include "linalgproperties.hh"
 #include "parallelbasebackend.hh"
 #include "bicgstabsolver.hh"
+#include "pipelinedbicgstabsolver.hh"
 #include "combinedcriterion.hh"
 #include "istlsparsematrixadapter.hh"
 
@@ -58,6 +59,10 @@ struct LinearSolverMaxError<TypeTag, TTag::ParallelBiCGStabLinearSolver>
     static constexpr type value = 1e7;
 };
 
+//! use the classic formulation of the BiCGStab solver by default
+template<class TypeTag>
+struct LinearSolverPipelined<TypeTag, TTag::ParallelBiCGStabLinearSolver> { static constexpr bool value = false; };
+
 } // namespace Opm::Properties
 
 namespace Opm {
@@ -88,6 +93,20 @@ namespace Linear {
  *            that it is computationally cheaper because it does not
  *            need to consider things which are only required for
  *            higher orders
+ * - \c ThreadedSOR, \c ThreadedSSOR: Multi-color variants of the (symmetric) SOR
+ *            preconditioner which use all threads of the process
+ * - \c ThreadedBlockILU0: A block-Jacobi preconditioner using ILU(0) for the blocks
+ *            of the individual threads
+ * - \c LevelScheduledILU0: An ILU(0) preconditioner which parallelizes the
+ *            factorization and the triangular solves using level scheduling
+ * - \c CPR: A two-stage constrained pressure residual preconditioner which combines an
+ *            AMG for the pressure system with a block ILU(0) for the full system
+ *
+ * If the LinearSolverPipelined parameter is set, the pipelined variant of the BiCGStab
+ * method is used instead of the classic one. This variant reduces the number of global
+ * synchronization points per iteration and overlaps them with computations, which pays
+ * off if the simulation is run using many processes. This also applies to the Krylov
+ * iteration of mixed precision solves.
  */
 template <class TypeTag>
 class ParallelBiCGStabSolverBackend : public ParallelBaseBackend<TypeTag>
@@ -108,6 +127,10 @@ class ParallelBiCGStabSolverBackend : public ParallelBaseBackend<TypeTag>
     using RawLinearSolver = BiCGStabSolver<ParallelOperator,
                                            OverlappingVector,
                                            ParallelPreconditioner>;
+    using PipelinedLinearSolver = PipelinedBiCGStabSolver<ParallelOperator,
+                                                          OverlappingVector,
+                                                          ParallelPreconditioner,
+                                                          ParallelScalarProduct>;
 
     static_assert(std::is_same<SparseMatrixAdapter, IstlSparseMatrixAdapter<MatrixBlock> >::value,
                   "The ParallelIstlSolverBackend linear solver backend requires the IstlSparseMatrixAdapter");
@@ -115,7 +138,9 @@ class ParallelBiCGStabSolverBackend : public ParallelBaseBackend<TypeTag>
 public:
     ParallelBiCGStabSolverBackend(const Simulator& simulator)
         : ParentType(simulator)
-    { }
+    {
+        pipelined_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverPipelined);
+    }
 
     static void registerParameters()
     {
@@ -124,6 +149,10 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, LinearSolverMaxError,
                              "The maximum residual error which the linear solver tolerates"
                              " without giving up");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverPipelined,
+                             "Use the pipelined variant of the BiCGStab solver which overlaps"
+                             " the global reductions with the linear operator and the"
+                             " preconditioner");
     }
 
 protected:
@@ -136,7 +165,7 @@ protected:
         const auto& gridView = this->simulator_.gridView();
         using CCC = CombinedCriterion<OverlappingVector, decltype(gridView.comm())>;
 
-        Scalar linearSolverTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverTolerance);
+        Scalar linearSolverTolerance = this->relativeTolerance_();
         Scalar linearSolverAbsTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverAbsTolerance);
         if(linearSolverAbsTolerance < 0.0)
             linearSolverAbsTolerance = this->simulator_.model().newtonMethod().tolerance() / 100.0;
@@ -146,30 +175,59 @@ protected:
                                 /*absoluteResidualTolerance=*/linearSolverAbsTolerance,
                                 EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverMaxError)));
 
+        // only the selected variant of the solver is created. the pipelined solver is
+        // a different type, so it is kept by the backend and the returned pointer to
+        // the classic solver is null if it is used.
+        if (pipelined_) {
+            pipelinedSolver_ =
+                std::make_shared<PipelinedLinearSolver>(parPreCond, *convCrit_, parScalarProduct);
+            configureSolver_(*pipelinedSolver_, parOperator);
+            return nullptr;
+        }
+
         auto bicgstabSolver =
             std::make_shared<RawLinearSolver>(parPreCond, *convCrit_, parScalarProduct);
-
-        int verbosity = 0;
-        if (parOperator.overlap().myRank() == 0)
-            verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
-        bicgstabSolver->setVerbosity(verbosity);
-        bicgstabSolver->setMaxIterations(EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations));
-        bicgstabSolver->setLinearOperator(&parOperator);
-        bicgstabSolver->setRhs(this->overlappingb_);
-
+        configureSolver_(*bicgstabSolver, parOperator);
         return bicgstabSolver;
     }
 
     std::pair<bool,int> runSolver_(std::shared_ptr<RawLinearSolver> solver)
     {
-        bool converged = solver->apply(*this->overlappingx_);
-        return std::make_pair(converged, int(solver->report().iterations()));
+        if (pipelinedSolver_)
+            return applySolver_(*pipelinedSolver_);
+
+        return applySolver_(*solver);
+    }
+
+    template <class LinearSolver>
+    std::pair<bool,int> applySolver_(LinearSolver& solver)
+    {
+        bool converged = solver.apply(*this->overlappingx_);
+        return std::make_pair(converged, int(solver.report().iterations()));
     }
 
     void cleanupSolver_()
-    { /* nothing to do */ }
+    { pipelinedSolver_.reset(); }
+
+    // the Krylov iteration of mixed precision solves uses the same variant of the solver
+    bool usePipelinedSolver_() const
+    { return pipelined_; }
+
+    template <class LinearSolver>
+    void configureSolver_(LinearSolver& solver, ParallelOperator& parOperator)
+    {
+        int verbosity = 0;
+        if (parOperator.overlap().myRank() == 0)
+            verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
+        solver.setVerbosity(verbosity);
+        solver.setMaxIterations(EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations));
+        solver.setLinearOperator(&parOperator);
+        solver.setRhs(this->overlappingb_);
+    }
 
     std::unique_ptr<ConvergenceCriterion<OverlappingVector> > convCrit_;
+    std::shared_ptr<PipelinedLinearSolver> pipelinedSolver_;
+    bool pipelined_;
 };
 
 }} // namespace Linear, Opm
@@ -0,0 +1,359 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Linear::PipelinedBiCGStabSolver
+ */
+#ifndef EWOMS_PIPELINED_BICG_STAB_SOLVER_HH
+#define EWOMS_PIPELINED_BICG_STAB_SOLVER_HH
+
+#include "convergencecriterion.hh"
+#include "linearsolverreport.hh"
+
+#include <opm/models/utils/timer.hh>
+#include <opm/models/utils/timerguard.hh>
+
+#include <opm/material/common/Exceptions.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace Opm {
+namespace Linear {
+/*!
+ * \brief Implements a pipelined variant of the preconditioned stabilized BiCG linear
+ *        solver.
+ *
+ * Mathematically, this solver is equivalent to the right-preconditioned BiCGStab
+ * method, but the recurrences are reformulated so that each iteration only exhibits
+ * two global synchronization points. Each of them is a single reduction of several
+ * fused scalar products which is started in a non-blocking fashion and overlapped with
+ * the application of the linear operator and of the preconditioner. This makes the
+ * solver attractive if a large number of processes is used, but it requires about
+ * three times the memory for auxiliary vectors compared to BiCGStabSolver and it may be
+ * slightly less robust w.r.t. round-off errors.
+ *
+ * The scalar product must provide the startDots() method and the PendingDots class
+ * template of the OverlappingScalarProduct.
+ *
+ * See S. Cools, W. Vanroose: "The communication-hiding pipelined BiCGStab method for
+ * the parallel solution of large unsymmetric linear systems", Parallel Computing 65,
+ * 2017
+ */
+template <class LinearOperator, class Vector, class Preconditioner, class ScalarProduct>
+class PipelinedBiCGStabSolver
+{
+    using ConvergenceCriterion = Opm::Linear::ConvergenceCriterion<Vector>;
+    using Scalar = typename LinearOperator::field_type;
+
+    template <std::size_t numDots>
+    using PendingDots = typename ScalarProduct::template PendingDots<numDots>;
+
+public:
+    PipelinedBiCGStabSolver(Preconditioner& preconditioner,
+                            ConvergenceCriterion& convergenceCriterion,
+                            ScalarProduct& scalarProduct)
+        : preconditioner_(preconditioner)
+        , convergenceCriterion_(convergenceCriterion)
+        , scalarProduct_(scalarProduct)
+    {
+        A_ = nullptr;
+        b_ = nullptr;
+
+        maxIterations_ = 1000;
+        verbosity_ = 0;
+    }
+
+    /*!
+     * \brief Set the maximum number of iterations before we give up without achieving
+     *        convergence.
+     */
+    void setMaxIterations(unsigned value)
+    { maxIterations_ = value; }
+
+    /*!
+     * \brief Return the maximum number of iterations before we give up without achieving
+     *        convergence.
+     */
+    unsigned maxIterations() const
+    { return maxIterations_; }
+
+    /*!
+     * \brief Set the verbosity level of the linear solver
+     *
+     * The levels correspond to those used by BiCGStabSolver.
+     */
+    void setVerbosity(unsigned value)
+    { verbosity_ = value; }
+
+    /*!
+     * \brief Return the verbosity level of the linear solver.
+     */
+    unsigned verbosity() const
+    { return verbosity_; }
+
+    /*!
+     * \brief Set the matrix "A" of the linear system.
+     */
+    void setLinearOperator(const LinearOperator* A)
+    { A_ = A; }
+
+    /*!
+     * \brief Set the right hand side "b" of the linear system.
+     */
+    void setRhs(const Vector* b)
+    { b_ = b; }
+
+    /*!
+     * \brief Run the pipelined BiCGStab solver and store the result into the "x" vector.
+     */
+    bool apply(Vector& x)
+    {
+        // epsilon used for detecting breakdowns
+        const Scalar breakdownEps = std::numeric_limits<Scalar>::min() * Scalar(1e10);
+
+        report_.reset();
+        Opm::TimerGuard reportTimerGuard(report_.timer());
+        report_.timer().start();
+
+        // set the initial solution to the zero vector
+        x = 0.0;
+
+        // prepare the preconditioner. like BiCGStabSolver, we assume that the
+        // preconditioner does not change the initial solution if it is zero.
+        Vector r = *b_;
+        preconditioner_.pre(x, r);
+
+        convergenceCriterion_.setInitial(x, r);
+        if (convergenceCriterion_.converged()) {
+            report_.setConverged(true);
+            return report_.converged();
+        }
+
+        if (verbosity_ > 0) {
+            std::cout << "-------- PipelinedBiCGStabSolver --------" << std::endl;
+            convergenceCriterion_.printInitial();
+        }
+
+        // the shadow residual
+        const Vector& r0hat = *b_;
+
+        // the vectors with a "h" suffix are the preconditioned counterparts of the
+        // respective vector without it, i.e., rh = K^-1*r. Similar to BiCGStabSolver, some
+        // objects are reused for vectors which are not needed at the same time: The
+        // vectors "q" and "y" of the original algorithm are stored in "r" and "w".
+        Vector rh(x);
+        Vector w(x);
+        Vector wh(x);
+        Vector t(x);
+        Vector th(x);
+
+        // the search directions are zero for the first iteration
+        Vector ph(x);
+        Vector s(x);
+        Vector sh(x);
+        Vector z(x);
+        Vector zh(x);
+        Vector v(x);
+        Vector vh(x);
+        Vector delta(x);
+        unsigned n = x.size();
+
+        // rh = K^-1*r, w = A*rh, wh = K^-1*w
+        preconditioner_.apply(rh, r);
+        A_->apply(rh, w);
+        preconditioner_.apply(wh, w);
+
+        // rho = (r0hat,r), (r0hat,w). overlap the reduction with t = A*wh, th = K^-1*t
+        PendingDots<2> initialDots;
+        scalarProduct_.startDots(initialDots, {&r0hat, &r0hat}, {&r, &w});
+        A_->apply(wh, t);
+        preconditioner_.apply(th, t);
+        const auto& initialValues = initialDots.wait();
+
+        Scalar rho = initialValues[0];
+        if (std::abs(initialValues[1]) <= breakdownEps)
+            throw Opm::NumericalIssue("Breakdown of the pipelined BiCGStab solver (division by zero)");
+        Scalar alpha = rho/initialValues[1];
+        Scalar beta = 0.0;
+        Scalar omega = 1.0;
+
+        PendingDots<2> omegaDots;
+        PendingDots<4> alphaDots;
+        for (; report_.iterations() < maxIterations_; report_.increment()) {
+            // this loop conflates the following operations:
+            //
+            // ph = rh + beta*(ph - omega*sh)
+            // sh = wh + beta*(sh - omega*zh)
+            // s = w + beta*(s - omega*z)
+            // zh = th + beta*(zh - omega*vh)
+            // z = t + beta*(z - omega*v)
+            // q = r - alpha*s (stored in r)
+            // qh = rh - alpha*sh (stored in rh)
+            // y = w - alpha*z (stored in w)
+            // yh = wh - alpha*zh (stored in wh)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (unsigned i = 0; i < n; ++i) {
+                ph[i].axpy(-omega, sh[i]);
+                ph[i] *= beta;
+                ph[i] += rh[i];
+
+                sh[i].axpy(-omega, zh[i]);
+                sh[i] *= beta;
+                sh[i] += wh[i];
+
+                s[i].axpy(-omega, z[i]);
+                s[i] *= beta;
+                s[i] += w[i];
+
+                zh[i].axpy(-omega, vh[i]);
+                zh[i] *= beta;
+                zh[i] += th[i];
+
+                z[i].axpy(-omega, v[i]);
+                z[i] *= beta;
+                z[i] += t[i];
+
+                r[i].axpy(-alpha, s[i]);
+                rh[i].axpy(-alpha, sh[i]);
+                w[i].axpy(-alpha, z[i]);
+                wh[i].axpy(-alpha, zh[i]);
+            }
+
+            // start computing (q,y) and (y,y) and overlap the reduction with
+            // v = A*zh, vh = K^-1*v
+            scalarProduct_.startDots(omegaDots, {&r, &w}, {&w, &w});
+            A_->apply(zh, v);
+            preconditioner_.apply(vh, v);
+            const auto& omegaValues = omegaDots.wait();
+
+            // omega = (q,y)/(y,y)
+            if (std::abs(omegaValues[1]) <= breakdownEps)
+                throw Opm::NumericalIssue("Breakdown of the pipelined BiCGStab solver (division by zero)");
+            omega = omegaValues[0]/omegaValues[1];
+            if (std::abs(omega) <= breakdownEps)
+                throw Opm::NumericalIssue("Breakdown of the pipelined BiCGStab solver (stagnation detected)");
+
+            // delta = alpha*ph + omega*qh
+            // x = x + delta
+            // r = q - omega*y
+            // rh = qh - omega*yh
+            // w = y - omega*(t - alpha*v)
+            // wh = yh - omega*(th - alpha*vh)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (unsigned i = 0; i < n; ++i) {
+                delta[i] = ph[i];
+                delta[i] *= alpha;
+                delta[i].axpy(omega, rh[i]);
+                x[i] += delta[i];
+
+                r[i].axpy(-omega, w[i]);
+                rh[i].axpy(-omega, wh[i]);
+
+                w[i].axpy(-omega, t[i]);
+                w[i].axpy(omega*alpha, v[i]);
+                wh[i].axpy(-omega, th[i]);
+                wh[i].axpy(omega*alpha, vh[i]);
+            }
+
+            // start computing the scalar products required for the next values of alpha
+            // and beta. the reduction is overlapped with the convergence check as well as
+            // with t = A*wh and th = K^-1*t. if we return early, the destructor of
+            // alphaDots waits for the pending reduction.
+            scalarProduct_.startDots(alphaDots,
+                                     {&r0hat, &r0hat, &r0hat, &r0hat},
+                                     {&r, &w, &s, &z});
+
+            // do convergence check and print terminal output
+            convergenceCriterion_.update(/*curSol=*/x, /*delta=*/delta, r);
+            if (convergenceCriterion_.converged()) {
+                if (verbosity_ > 0) {
+                    convergenceCriterion_.print(1.0 + report_.iterations());
+                    std::cout << "-------- /PipelinedBiCGStabSolver --------" << std::endl;
+                }
+
+                preconditioner_.post(x);
+                report_.setConverged(true);
+                return report_.converged();
+            }
+            else if (convergenceCriterion_.failed()) {
+                if (verbosity_ > 0) {
+                    convergenceCriterion_.print(1.0 + report_.iterations());
+                    std::cout << "-------- /PipelinedBiCGStabSolver --------" << std::endl;
+                }
+
+                report_.setConverged(false);
+                return report_.converged();
+            }
+
+            if (verbosity_ > 1)
+                convergenceCriterion_.print(1.0 + report_.iterations());
+
+            A_->apply(wh, t);
+            preconditioner_.apply(th, t);
+            const auto& alphaValues = alphaDots.wait();
+
+            // beta = (alpha/omega)*(r0hat,r_i)/(r0hat,r_(i-1))
+            if (std::abs(rho) <= breakdownEps)
+                throw Opm::NumericalIssue("Breakdown of the pipelined BiCGStab solver (division by zero)");
+            beta = (alpha/omega)*(alphaValues[0]/rho);
+            rho = alphaValues[0];
+
+            // alpha = (r0hat,r)/((r0hat,w) + beta*(r0hat,s) - beta*omega*(r0hat,z))
+            Scalar denom = alphaValues[1] + beta*alphaValues[2] - beta*omega*alphaValues[3];
+            if (std::abs(denom) <= breakdownEps)
+                throw Opm::NumericalIssue("Breakdown of the pipelined BiCGStab solver (division by zero)");
+            alpha = rho/denom;
+            if (std::abs(alpha) <= breakdownEps)
+                throw Opm::NumericalIssue("Breakdown of the pipelined BiCGStab solver (stagnation detected)");
+        }
+
+        report_.setConverged(false);
+        return report_.converged();
+    }
+
+    const Opm::Linear::SolverReport& report() const
+    { return report_; }
+
+private:
+    const LinearOperator* A_;
+    const Vector* b_;
+
+    Preconditioner& preconditioner_;
+    ConvergenceCriterion& convergenceCriterion_;
+    ScalarProduct& scalarProduct_;
+    Opm::Linear::SolverReport report_;
+
+    unsigned maxIterations_;
+    unsigned verbosity_;
+};
+
+} // namespace Linear
+} // namespace Opm
+
+#endif
@@ -0,0 +1,238 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Linear::SparsityPattern
+ */
+#ifndef EWOMS_SPARSITY_PATTERN_HH
+#define EWOMS_SPARSITY_PATTERN_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+namespace Linear {
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief The positions of the non-zero entries of a sparse matrix in compressed row
+ *        storage format.
+ *
+ * The pattern is built in two passes: First, an upper bound for the number of entries
+ * of each row is determined using countEntries(), then the column indices are specified
+ * using addEntry(). Both methods may be called concurrently by multiple threads.
+ * Finally, finalize() sorts the column indices of each row and removes duplicates.
+ *
+ * \code
+ * Opm::Linear::SparsityPattern pattern;
+ * pattern.beginCounting(numRows);
+ * // ... pattern.countEntries(rowIdx, n) for all rows
+ * pattern.beginFilling();
+ * // ... pattern.addEntry(rowIdx, colIdx) for at most n entries per row
+ * pattern.finalize();
+ * \endcode
+ */
+class SparsityPattern
+{
+public:
+    SparsityPattern()
+        : numRows_(0)
+    {}
+
+    /*!
+     * \brief Start the first pass, i.e., the one which counts the entries of the rows.
+     *
+     * This method must be called in a sequential context.
+     */
+    void beginCounting(size_t numRows)
+    {
+        numRows_ = numRows;
+        rowOffsets_.clear();
+        columnIndices_.clear();
+        rowCursor_ = std::vector<std::atomic<size_t> >(numRows);
+    }
+
+    /*!
+     * \brief Specify that a row exhibits at most n additional entries.
+     *
+     * This method is thread-safe.
+     */
+    void countEntries(size_t rowIdx, size_t n)
+    {
+        assert(rowIdx < numRows_);
+        rowCursor_[rowIdx].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Start the second pass, i.e., the one which specifies the column indices.
+     *
+     * This method must be called in a sequential context.
+     */
+    void beginFilling()
+    {
+        rowOffsets_.resize(numRows_ + 1);
+        rowOffsets_[0] = 0;
+        for (size_t rowIdx = 0; rowIdx < numRows_; ++rowIdx)
+            rowOffsets_[rowIdx + 1] = rowOffsets_[rowIdx] + rowCursor_[rowIdx].load();
+
+        // from here on, the counters are used as the positions where the next column
+        // index of a row gets stored
+        for (size_t rowIdx = 0; rowIdx < numRows_; ++rowIdx)
+            rowCursor_[rowIdx].store(rowOffsets_[rowIdx]);
+
+        columnIndices_.resize(rowOffsets_[numRows_]);
+    }
+
+    /*!
+     * \brief Add a non-zero entry to the pattern.
+     *
+     * Adding the same entry multiple times is allowed, but each call must have been
+     * accounted for by countEntries(). This method is thread-safe.
+     */
+    void addEntry(size_t rowIdx, unsigned colIdx)
+    {
+        assert(rowIdx < numRows_);
+        size_t pos = rowCursor_[rowIdx].fetch_add(1, std::memory_order_relaxed);
+        assert(pos < rowOffsets_[rowIdx + 1]);
+        columnIndices_[pos] = colIdx;
+    }
+
+    /*!
+     * \brief Sort the column indices of all rows and remove the duplicates.
+     *
+     * This method must be called in a sequential context.
+     */
+    void finalize()
+    {
+        // sort the rows and remove the duplicate entries. this also takes care of the
+        // slots which have been counted but not filled because they are located at the
+        // end of the row.
+        std::vector<size_t> rowSize(numRows_);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (long rowIdx = 0; rowIdx < static_cast<long>(numRows_); ++rowIdx) {
+            auto rowBegin = columnIndices_.begin() + static_cast<long>(rowOffsets_[static_cast<size_t>(rowIdx)]);
+            auto rowEnd = columnIndices_.begin() + static_cast<long>(rowCursor_[static_cast<size_t>(rowIdx)].load());
+            std::sort(rowBegin, rowEnd);
+            rowSize[static_cast<size_t>(rowIdx)] =
+                static_cast<size_t>(std::unique(rowBegin, rowEnd) - rowBegin);
+        }
+
+        // compact the storage of the column indices. since rows only get shorter, the
+        // entries only move towards the front.
+        size_t pos = 0;
+        for (size_t rowIdx = 0; rowIdx < numRows_; ++rowIdx) {
+            size_t oldOffset = rowOffsets_[rowIdx];
+            rowOffsets_[rowIdx] = pos;
+            for (size_t i = 0; i < rowSize[rowIdx]; ++i)
+                columnIndices_[pos++] = columnIndices_[oldOffset + i];
+        }
+        rowOffsets_[numRows_] = pos;
+
+        columnIndices_.resize(pos);
+        columnIndices_.shrink_to_fit();
+        rowCursor_ = std::vector<std::atomic<size_t> >();
+    }
+
+    /*!
+     * \brief Add the entries of a finalized pattern which are given by per-row sets of
+     *        column indices.
+     *
+     * This is used for the neighbors of the auxiliary modules. The pattern is
+     * finalized afterwards.
+     */
+    template <class Set>
+    void addNeighbors(const std::vector<Set>& neighbors)
+    {
+        assert(neighbors.size() == numRows_);
+
+        std::vector<size_t> oldRowOffsets(std::move(rowOffsets_));
+        std::vector<unsigned> oldColumnIndices(std::move(columnIndices_));
+
+        beginCounting(numRows_);
+        for (size_t rowIdx = 0; rowIdx < numRows_; ++rowIdx)
+            countEntries(rowIdx,
+                         oldRowOffsets[rowIdx + 1] - oldRowOffsets[rowIdx]
+                         + neighbors[rowIdx].size());
+
+        beginFilling();
+        for (size_t rowIdx = 0; rowIdx < numRows_; ++rowIdx) {
+            for (size_t i = oldRowOffsets[rowIdx]; i < oldRowOffsets[rowIdx + 1]; ++i)
+                addEntry(rowIdx, oldColumnIndices[i]);
+            for (const auto& colIdx : neighbors[rowIdx])
+                addEntry(rowIdx, static_cast<unsigned>(colIdx));
+        }
+
+        finalize();
+    }
+
+    /*!
+     * \brief Returns the number of rows of the pattern.
+     */
+    size_t numRows() const
+    { return numRows_; }
+
+    /*!
+     * \brief Returns the total number of non-zero entries of the finalized pattern.
+     */
+    size_t numNonZeros() const
+    { return columnIndices_.size(); }
+
+    /*!
+     * \brief Returns the number of non-zero entries of a row of the finalized pattern.
+     */
+    size_t rowSize(size_t rowIdx) const
+    { return rowOffsets_[rowIdx + 1] - rowOffsets_[rowIdx]; }
+
+    /*!
+     * \brief Returns a pointer to the first column index of a row of the finalized
+     *        pattern.
+     *
+     * The column indices of each row are sorted in ascending order.
+     */
+    const unsigned* rowBegin(size_t rowIdx) const
+    { return columnIndices_.data() + rowOffsets_[rowIdx]; }
+
+    /*!
+     * \brief Returns a pointer to the position after the last column index of a row of
+     *        the finalized pattern.
+     */
+    const unsigned* rowEnd(size_t rowIdx) const
+    { return columnIndices_.data() + rowOffsets_[rowIdx + 1]; }
+
+private:
+    size_t numRows_;
+    std::vector<size_t> rowOffsets_;
+    std::vector<unsigned> columnIndices_;
+    std::vector<std::atomic<size_t> > rowCursor_;
+};
+
+} // namespace Linear
+} // namespace Opm
+
+#endif
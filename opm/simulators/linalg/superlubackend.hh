@@ -29,16 +29,24 @@
 
 #if HAVE_SUPERLU
 
-#include <opm/models/linear/istlsparsematrixbackend.hh>
+#include <opm/simulators/linalg/istlsparsematrixadapter.hh>
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/simulators/linalg/linalgproperties.hh>
 
 #include <opm/material/common/Unused.hpp>
 
 #include <dune/istl/superlu.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/common/version.hh>
 
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
 namespace Opm::Properties::TTag {
 struct SuperLULinearSolver {};
 } // namespace Opm::Properties::TTag
@@ -51,6 +59,17 @@ class SuperLUSolve_;
 /*!
  * \ingroup Linear
  * \brief A linear solver backend for the SuperLU sparse matrix library.
+ *
+ * The sparsity pattern of the matrix in SuperLU's compressed column format, the column
+ * permutation and the elimination tree are kept across linear solves as long as the grid
+ * does not change. All factorizations except for the first one thus only compute the
+ * numerical values of the LU decomposition (SuperLU's "SamePattern" mode).
+ *
+ * If the PreconditionerMaxReuse parameter is positive, the LU decomposition of a
+ * previous Jacobian matrix is used as the preconditioner of a BiCGStab solver for at most
+ * this many subsequent linear solves. If this solver does not reach the
+ * LinearSolverTolerance within LinearSolverMaxIterations iterations, the matrix is
+ * factorized again and the linear system is solved directly.
  */
 template <class TypeTag>
 class SuperLUBackend
@@ -58,32 +77,54 @@ class SuperLUBackend
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
-    using Matrix = typename SparseMatrixAdapter::block_type;
+    using Vector = GetPropType<TypeTag, Properties::GlobalEqVector>;
+    using Matrix = typename SparseMatrixAdapter::IstlMatrix;
+    using MatrixBlock = typename SparseMatrixAdapter::MatrixBlock;
 
-    static_assert(std::is_same<SparseMatrixAdapter, IstlSparseMatrixAdapter<MatrixBlock>::value,
+    static_assert(std::is_same<SparseMatrixAdapter, IstlSparseMatrixAdapter<MatrixBlock> >::value,
                   "The SuperLU linear solver backend requires the IstlSparseMatrixAdapter");
 
 public:
-    SuperLUBackend(Simulator& simulator OPM_UNUSED)
+    SuperLUBackend(const Simulator& simulator)
+        : simulator_(simulator)
+        , gridSequenceNumber_(-1)
     {}
 
     static void registerParameters()
     {
         EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverVerbosity,
                              "The verbosity level of the linear solver");
+        EWOMS_REGISTER_PARAM(TypeTag, int, PreconditionerMaxReuse,
+                             "The maximum number of linear solves for which the LU "
+                             "decomposition of a previous matrix is used as the "
+                             "preconditioner of an iterative solver (0: factorize the "
+                             "matrix for each linear solve)");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, LinearSolverTolerance,
+                             "The residual reduction which must be reached if the LU "
+                             "decomposition of a previous matrix is reused");
+        EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverMaxIterations,
+                             "The maximum number of iterations of the iterative solver "
+                             "which reuses the LU decomposition of a previous matrix");
     }
 
     /*!
      * \brief Causes the solve() method to discared the structure of the linear system of
      *        equations the next time it is called.
-     *
-     * Since the SuperLU backend does not create any internal matrices, this is a no-op.
      */
     void eraseMatrix()
-    { }
+    { solver_.reset(); }
 
-    void prepare(const SparseMatrixAdapter& M, const Vector& b)
-    { }
+    void prepare(const SparseMatrixAdapter& M OPM_UNUSED, const Vector& b OPM_UNUSED)
+    {
+        // a new SuperLU object is required if the grid has changed
+        int curSeqNum = simulator_.vanguard().gridSequenceNumber();
+        if (gridSequenceNumber_ != curSeqNum)
+            solver_.reset();
+        gridSequenceNumber_ = curSeqNum;
+
+        if (!solver_)
+            solver_.reset(new SuperLUSolve_<Scalar, TypeTag, Matrix, Vector>());
+    }
 
     void setResidual(const Vector& b)
     { b_ = &b; }
@@ -92,78 +133,376 @@ public:
     { b = *b_; }
 
     void setMatrix(const SparseMatrixAdapter& M)
-    { M_ = &M; }
+    { M_ = &M.istlMatrix(); }
 
     bool solve(Vector& x)
-    { return SuperLUSolve_<Scalar, TypeTag, Matrix, Vector>::solve_(*M_, x, *b_); }
+    { return solver_->solve(*M_, x, *b_); }
 
 private:
+    const Simulator& simulator_;
+    int gridSequenceNumber_;
+
+    std::unique_ptr<SuperLUSolve_<Scalar, TypeTag, Matrix, Vector> > solver_;
     const Matrix* M_;
-    Vector* b_;
+    const Vector* b_;
 };
 
 template <class Scalar, class TypeTag, class Matrix, class Vector>
 class SuperLUSolve_
 {
+    static constexpr size_t numEq = Vector::block_type::dimension;
+
+    // applies the LU decomposition of a previous matrix
+    class LuPreconditioner_ : public Dune::Preconditioner<Vector, Vector>
+    {
+    public:
+        LuPreconditioner_(SuperLUSolve_& solver)
+            : solver_(solver)
+        {}
+
+        void pre(Vector&, Vector&) override
+        {}
+
+        void apply(Vector& v, const Vector& d) override
+        { solver_.applyFactors_(v, d); }
+
+        void post(Vector&) override
+        {}
+
+        Dune::SolverCategory::Category category() const override
+        { return Dune::SolverCategory::sequential; }
+
+    private:
+        SuperLUSolve_& solver_;
+    };
+
 public:
-    static bool solve_(const Matrix& A, Vector& x, const Vector& b)
+    SuperLUSolve_()
+        : numReuses_(0)
+        , patternValid_(false)
+        , haveFactors_(false)
+        , equed_('N')
     {
-        Vector bTmp(b);
+        verbosity_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
+        maxReuse_ = EWOMS_GET_PARAM(TypeTag, int, PreconditionerMaxReuse);
+        using ParamScalar = GetPropType<TypeTag, Properties::Scalar>;
+        tolerance_ = EWOMS_GET_PARAM(TypeTag, ParamScalar, LinearSolverTolerance);
+        maxIterations_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations);
+
+        set_default_options(&options_);
+        options_.PrintStat = verbosity_ > 1 ? YES : NO;
+    }
 
-        int verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
-        Dune::InverseOperatorResult result;
-        Dune::SuperLU<Matrix> solver(A, verbosity > 0);
-        solver.apply(x, bTmp, result);
-
-        if (result.converged) {
-            // make sure that the result only contains finite values.
-            Scalar tmp = 0;
-            for (unsigned i = 0; i < x.size(); ++i) {
-                const auto& xi = x[i];
-                for (unsigned j = 0; j < Vector::block_type::dimension; ++j)
-                    tmp += xi[j];
+    SuperLUSolve_(const SuperLUSolve_&) = delete;
+
+    ~SuperLUSolve_()
+    {
+        freeFactors_();
+        if (patternValid_)
+            Destroy_SuperMatrix_Store(&A_);
+    }
+
+    bool solve(const Matrix& A, Vector& x, const Vector& b)
+    {
+        if (haveFactors_ && numReuses_ < maxReuse_) {
+            ++numReuses_;
+            if (solveIteratively_(A, x, b))
+                return true;
+
+            if (verbosity_ > 0)
+                std::cout << "SuperLU: No convergence using the LU decomposition of a "
+                          << "previous matrix, factorizing the current one\n" << std::flush;
+        }
+
+        numReuses_ = 0;
+        if (!factorize_(A))
+            return false;
+
+        applyFactors_(x, b);
+        return isFinite_(x);
+    }
+
+private:
+    // compute the LU decomposition of the matrix. the matrix is converted to the
+    // compressed column format of SuperLU whose layout only needs to be determined for
+    // the first matrix. for subsequent ones, SuperLU reuses the column permutation and
+    // the elimination tree, i.e., it does not need to analyze the sparsity pattern again.
+    bool factorize_(const Matrix& A)
+    {
+        if (!patternValid_)
+            setupPattern_(A);
+
+        // SuperLU requires the factors of the previous matrix to be released if the
+        // structural information is reused
+        bool samePattern = haveFactors_;
+        freeFactors_();
+        options_.Fact = samePattern ? SamePattern : DOFACT;
+        assignValues_(A);
+
+        // factorize without solving for any right hand side
+        int n = static_cast<int>(permC_.size());
+        SuperMatrix B, X;
+        Dune::SuperLUDenseMatChooser<double>::create(&B, n, 0, nullptr, n, SLU_DN, SLU_D, SLU_GE);
+        Dune::SuperLUDenseMatChooser<double>::create(&X, n, 0, nullptr, n, SLU_DN, SLU_D, SLU_GE);
+        int info = callSolver_(B, X);
+        Destroy_SuperMatrix_Store(&B);
+        Destroy_SuperMatrix_Store(&X);
+
+        // the factors are allocated even if the matrix is singular
+        haveFactors_ = info <= n;
+        if (info != 0 && verbosity_ > 0)
+            std::cout << "SuperLU: Factorization failed (info = " << info << ")\n" << std::flush;
+
+        // info == n + 1 only indicates that the matrix is singular to working precision
+        return info == 0 || info == n + 1;
+    }
+
+    // x = (LU)^-1 b using the current LU decomposition
+    void applyFactors_(Vector& x, const Vector& b)
+    {
+        // SuperLU overwrites the right hand side if the matrix was equilibrated, so we
+        // work on a copy. its memory is reused across solves.
+        rhs_.resize(b.size());
+        rhs_ = b;
+
+        int n = static_cast<int>(permC_.size());
+        SuperMatrix B, X;
+        Dune::SuperLUDenseMatChooser<double>::create(&B, n, 1, &rhs_[0][0], n, SLU_DN, SLU_D, SLU_GE);
+        Dune::SuperLUDenseMatChooser<double>::create(&X, n, 1, &x[0][0], n, SLU_DN, SLU_D, SLU_GE);
+        options_.Fact = FACTORED;
+        callSolver_(B, X);
+        Destroy_SuperMatrix_Store(&B);
+        Destroy_SuperMatrix_Store(&X);
+    }
+
+    int callSolver_(SuperMatrix& B, SuperMatrix& X)
+    {
+        double rpg, rcond, ferr, berr;
+        mem_usage_t memUsage;
+        SuperLUStat_t stat;
+        int info = 0;
+
+        StatInit(&stat);
+        Dune::SuperLUSolveChooser<double>::solve(&options_, &A_, permC_.data(), permR_.data(),
+                                                 etree_.data(), &equed_, R_.data(), C_.data(),
+                                                 &L_, &U_, /*work=*/nullptr, /*lwork=*/0,
+                                                 &B, &X, &rpg, &rcond, &ferr, &berr,
+                                                 &memUsage, &stat, &info);
+        if (options_.PrintStat == YES)
+            StatPrint(&stat);
+        StatFree(&stat);
+
+        return info;
+    }
+
+    // determine the compressed column layout of the scalar matrix and the position of
+    // each scalar entry of the block matrix within it
+    void setupPattern_(const Matrix& A)
+    {
+        int n = static_cast<int>(A.N()*numEq);
+
+        colStarts_.assign(static_cast<size_t>(n) + 1, 0);
+        for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt)
+            for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt)
+                for (size_t j = 0; j < numEq; ++j)
+                    colStarts_[colIt.index()*numEq + j + 1] += static_cast<int>(numEq);
+        for (size_t colIdx = 0; colIdx < static_cast<size_t>(n); ++colIdx)
+            colStarts_[colIdx + 1] += colStarts_[colIdx];
+
+        size_t nnz = static_cast<size_t>(colStarts_.back());
+        rowIndices_.resize(nnz);
+        values_.resize(nnz);
+        valuePositions_.resize(nnz);
+
+        std::vector<int> nextPos(colStarts_.begin(), colStarts_.end() - 1);
+        size_t entryIdx = 0;
+        for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt) {
+            size_t rowIdx = rowIt.index();
+            for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt) {
+                for (size_t i = 0; i < numEq; ++i) {
+                    for (size_t j = 0; j < numEq; ++j) {
+                        int& pos = nextPos[colIt.index()*numEq + j];
+                        rowIndices_[static_cast<size_t>(pos)] = static_cast<int>(rowIdx*numEq + i);
+                        valuePositions_[entryIdx++] = pos++;
+                    }
+                }
             }
-            result.converged = std::isfinite(tmp);
         }
 
-        return result.converged;
+        Dune::SuperMatrixCreateSparseChooser<double>::create(&A_, n, n, static_cast<int>(nnz),
+                                                             values_.data(),
+                                                             rowIndices_.data(),
+                                                             colStarts_.data(),
+                                                             SLU_NC, SLU_D, SLU_GE);
+
+        permC_.resize(static_cast<size_t>(n));
+        permR_.resize(static_cast<size_t>(n));
+        etree_.resize(static_cast<size_t>(n));
+        R_.resize(static_cast<size_t>(n));
+        C_.resize(static_cast<size_t>(n));
+        patternValid_ = true;
+    }
+
+    void assignValues_(const Matrix& A)
+    {
+        size_t entryIdx = 0;
+        for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt)
+            for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt)
+                for (size_t i = 0; i < numEq; ++i)
+                    for (size_t j = 0; j < numEq; ++j)
+                        values_[static_cast<size_t>(valuePositions_[entryIdx++])] =
+                            static_cast<double>((*colIt)[i][j]);
+    }
+
+    void freeFactors_()
+    {
+        if (!haveFactors_)
+            return;
+
+        Destroy_SuperNode_Matrix(&L_);
+        Destroy_CompCol_Matrix(&U_);
+        haveFactors_ = false;
+    }
+
+    bool solveIteratively_(const Matrix& A, Vector& x, const Vector& b)
+    {
+        // the iterative solver overwrites the right hand side, so we work on a copy
+        bTmp_.resize(b.size());
+        bTmp_ = b;
+
+        using Operator = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+        Operator op(A);
+        LuPreconditioner_ preconditioner(*this);
+        Dune::BiCGSTABSolver<Vector> solver(op,
+                                            preconditioner,
+                                            tolerance_,
+                                            maxIterations_,
+                                            /*verbose=*/verbosity_ > 1 ? 2 : 0);
+
+        x = 0.0;
+        Dune::InverseOperatorResult result;
+        solver.apply(x, bTmp_, result);
+
+        return result.converged && isFinite_(x);
     }
+
+    // make sure that the result only contains finite values.
+    static bool isFinite_(const Vector& x)
+    {
+        Scalar tmp = 0;
+        for (unsigned i = 0; i < x.size(); ++i) {
+            const auto& xi = x[i];
+            for (unsigned j = 0; j < Vector::block_type::dimension; ++j)
+                tmp += xi[j];
+        }
+        return std::isfinite(tmp);
+    }
+
+    Vector bTmp_;
+    Vector rhs_;
+
+    // the matrix in the compressed column format of SuperLU, the position of each entry
+    // of the block matrix within it and the data which is kept by SuperLU between
+    // factorizations
+    std::vector<int> colStarts_;
+    std::vector<int> rowIndices_;
+    std::vector<double> values_;
+    std::vector<int> valuePositions_;
+    SuperMatrix A_;
+    SuperMatrix L_;
+    SuperMatrix U_;
+    std::vector<int> permC_;
+    std::vector<int> permR_;
+    std::vector<int> etree_;
+    std::vector<double> R_;
+    std::vector<double> C_;
+    superlu_options_t options_;
+
+    int verbosity_;
+    int maxReuse_;
+    int numReuses_;
+    Scalar tolerance_;
+    int maxIterations_;
+    bool patternValid_;
+    bool haveFactors_;
+    char equed_;
 };
 
-// the following is required to make the SuperLU adapter of dune-istl happy with
-// quadruple precision math on Dune 2.4. this is because the most which SuperLU can
-// handle is double precision (i.e., the linear systems of equations are always solved
-// with at most double precision if chosing SuperLU as the linear solver...)
+// the following is required to make the SuperLU backend happy with quadruple precision
+// math. this is because the most which SuperLU can handle is double precision (i.e., the
+// linear systems of equations are always solved with at most double precision if
+// chosing SuperLU as the linear solver...)
 #if HAVE_QUAD
 template <class TypeTag, class Matrix, class Vector>
 class SuperLUSolve_<__float128, TypeTag, Matrix, Vector>
 {
+    static const int numEq = getPropValue<TypeTag, Properties::NumEq>();
+    using DoubleEqVector = Dune::FieldVector<double, numEq>;
+    using DoubleEqMatrix = Dune::FieldMatrix<double, numEq, numEq>;
+    using DoubleVector = Dune::BlockVector<DoubleEqVector>;
+    using DoubleMatrix = Dune::BCRSMatrix<DoubleEqMatrix>;
+
 public:
-    static bool solve_(const Matrix& A,
-                       Vector& x,
-                       const Vector& b)
-    {
-        static const int numEq = getPropValue<TypeTag, Properties::NumEq>();
-        using DoubleEqVector = Dune::FieldVector<double, numEq>;
-        using DoubleEqMatrix = Dune::FieldMatrix<double, numEq, numEq>;
-        using DoubleVector = Dune::BlockVector<DoubleEqVector>;
-        using DoubleMatrix = Dune::BCRSMatrix<DoubleEqMatrix>;
-
-        // copy the inputs into the double precision data structures
-        DoubleVector bDouble(b);
-        DoubleVector xDouble(x);
-        DoubleMatrix ADouble(A);
-
-        bool res =
-            SuperLUSolve_<double, TypeTag, Matrix, Vector>::solve_(ADouble,
-                                                                   xDouble,
-                                                                   bDouble);
+    bool solve(const Matrix& A, Vector& x, const Vector& b)
+    {
+        // copy the inputs into the double precision data structures. the sparsity
+        // pattern of the matrix does not change during the lifetime of this object.
+        if (!ADouble_)
+            createDoubleMatrix_(A);
+        copyMatrix_(A, *ADouble_);
+        copyVector_(b, bDouble_);
+        xDouble_.resize(x.size());
+
+        bool res = doubleSolver_.solve(*ADouble_, xDouble_, bDouble_);
 
         // copy the result back into the quadruple precision vector.
-        x = xDouble;
+        copyVector_(xDouble_, x);
 
         return res;
     }
+
+private:
+    void createDoubleMatrix_(const Matrix& A)
+    {
+        ADouble_.reset(new DoubleMatrix(A.N(), A.M(), DoubleMatrix::random));
+        for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt)
+            ADouble_->setrowsize(rowIt.index(), rowIt->size());
+        ADouble_->endrowsizes();
+
+        for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt)
+            for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt)
+                ADouble_->addindex(rowIt.index(), colIt.index());
+        ADouble_->endindices();
+    }
+
+    template <class SrcMatrix, class DestMatrix>
+    static void copyMatrix_(const SrcMatrix& src, DestMatrix& dest)
+    {
+        auto destRowIt = dest.begin();
+        for (auto rowIt = src.begin(); rowIt != src.end(); ++rowIt, ++destRowIt) {
+            auto destColIt = destRowIt->begin();
+            for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt, ++destColIt)
+                for (int i = 0; i < numEq; ++i)
+                    for (int j = 0; j < numEq; ++j)
+                        (*destColIt)[i][j] = static_cast<double>((*colIt)[i][j]);
+        }
+    }
+
+    template <class SrcVector, class DestVector>
+    static void copyVector_(const SrcVector& src, DestVector& dest)
+    {
+        using DestScalar = typename DestVector::field_type;
+
+        dest.resize(src.size());
+        for (unsigned i = 0; i < src.size(); ++i)
+            for (int k = 0; k < numEq; ++k)
+                dest[i][k] = static_cast<DestScalar>(src[i][k]);
+    }
+
+    std::unique_ptr<DoubleMatrix> ADouble_;
+    DoubleVector bDouble_;
+    DoubleVector xDouble_;
+    SuperLUSolve_<double, TypeTag, DoubleMatrix, DoubleVector> doubleSolver_;
 };
 #endif
 
@@ -177,6 +516,23 @@ struct LinearSolverVerbosity<TypeTag, TTag::SuperLULinearSolver> { static conste
 template<class TypeTag>
 struct LinearSolverBackend<TypeTag, TTag::SuperLULinearSolver> { using type = Opm::Linear::SuperLUBackend<TypeTag>; };
 
+//! factorize the matrix for each linear solve by default
+template<class TypeTag>
+struct PreconditionerMaxReuse<TypeTag, TTag::SuperLULinearSolver> { static constexpr int value = 0; };
+
+//! if the LU decomposition is reused, the linear system ought to be solved almost as
+//! accurately as by the direct solver
+template<class TypeTag>
+struct LinearSolverTolerance<TypeTag, TTag::SuperLULinearSolver>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 1e-10;
+};
+
+//! a few iterations suffice if the LU decomposition is still a good preconditioner
+template<class TypeTag>
+struct LinearSolverMaxIterations<TypeTag, TTag::SuperLULinearSolver> { static constexpr int value = 10; };
+
 } // namespace Opm::Properties
 
 #endif // HAVE_SUPERLU
@@ -0,0 +1,579 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Preconditioners which use the OpenMP threads of the process.
+ */
+#ifndef EWOMS_THREADED_PRECONDITIONERS_HH
+#define EWOMS_THREADED_PRECONDITIONERS_HH
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Opm {
+namespace Linear {
+namespace Detail {
+// the number of threads which ought to be used by the preconditioners. the thread
+// manager of the simulator configures the OpenMP runtime accordingly.
+inline unsigned preconditionerThreads()
+{
+#ifdef _OPENMP
+    return static_cast<unsigned>(omp_get_max_threads());
+#else
+    return 1;
+#endif
+}
+
+// the index of the calling thread within the current parallel region
+inline std::size_t threadId()
+{
+#ifdef _OPENMP
+    return static_cast<std::size_t>(omp_get_thread_num());
+#else
+    return 0;
+#endif
+}
+
+// incomplete LU factorization without fill-in of a single row of a block matrix. only
+// the entries of the columns in [colBegin, colEnd) are considered and all rows in front
+// of the current one must already be factorized. The diagonal block is replaced by its
+// inverse.
+template <class Matrix>
+void ilu0FactorizeRow(Matrix& A, std::size_t rowIdx, std::size_t colBegin, std::size_t colEnd)
+{
+    using Block = typename Matrix::block_type;
+
+    auto& row = A[rowIdx];
+    const auto& rowEndIt = row.end();
+    auto ikIt = row.begin();
+    for (; ikIt != rowEndIt && ikIt.index() < rowIdx; ++ikIt) {
+        std::size_t k = ikIt.index();
+        if (k < colBegin)
+            continue;
+
+        // a_ik = a_ik * a_kk^-1 (the diagonal of row k has already been inverted)
+        auto& aik = *ikIt;
+        aik.rightmultiply(A[k][k]);
+
+        // a_ij -= a_ik * a_kj for all j > k which are present in row i
+        const auto& rowK = A[k];
+        auto kjIt = rowK.find(k);
+        const auto& rowKEndIt = rowK.end();
+        auto ijIt = ikIt;
+        ++ijIt;
+        for (++kjIt; kjIt != rowKEndIt; ++kjIt) {
+            std::size_t j = kjIt.index();
+            if (j >= colEnd)
+                break;
+
+            while (ijIt != rowEndIt && ijIt.index() < j)
+                ++ijIt;
+            if (ijIt == rowEndIt)
+                break;
+
+            if (ijIt.index() == j) {
+                Block tmp(aik);
+                tmp.rightmultiply(*kjIt);
+                *ijIt -= tmp;
+            }
+        }
+    }
+
+    if (ikIt == rowEndIt || ikIt.index() != rowIdx)
+        DUNE_THROW(Dune::ISTLError, "Row " << rowIdx << " does not exhibit a diagonal entry");
+    ikIt->invert();
+}
+
+// solve L*U*v = d for the rows in [rowBegin, rowEnd) of a matrix which was factorized
+// using ilu0FactorizeRow(). only columns in the same range are considered.
+template <class Matrix, class X, class Y>
+void ilu0SolveRange(const Matrix& LU, X& v, const Y& d, std::size_t rowBegin, std::size_t rowEnd)
+{
+    // forward substitution: v = L^-1 d
+    for (std::size_t i = rowBegin; i < rowEnd; ++i) {
+        auto rhs = d[i];
+        const auto& row = LU[i];
+        for (auto ijIt = row.begin(); ijIt.index() < i; ++ijIt)
+            if (ijIt.index() >= rowBegin)
+                ijIt->mmv(v[ijIt.index()], rhs);
+        v[i] = rhs;
+    }
+
+    // backward substitution: v = U^-1 v
+    for (std::size_t i = rowEnd; i > rowBegin; --i) {
+        std::size_t rowIdx = i - 1;
+        const auto& row = LU[rowIdx];
+        auto rhs = v[rowIdx];
+        auto diagIt = row.find(rowIdx);
+        auto ijIt = diagIt;
+        const auto& rowEndIt = row.end();
+        for (++ijIt; ijIt != rowEndIt && ijIt.index() < rowEnd; ++ijIt)
+            ijIt->mmv(v[ijIt.index()], rhs);
+        diagIt->mv(rhs, v[rowIdx]);
+    }
+}
+
+// group the rows of a matrix into sets which can be processed concurrently by a
+// forward (if lower is true) or backward substitution.
+template <class Matrix>
+void computeLevelSets(const Matrix& A,
+                      bool lower,
+                      std::vector<std::size_t>& rows,
+                      std::vector<std::size_t>& levelOffsets)
+{
+    std::size_t numRows = A.N();
+    std::vector<std::size_t> level(numRows, 0);
+    std::size_t numLevels = 0;
+    for (std::size_t k = 0; k < numRows; ++k) {
+        std::size_t rowIdx = lower ? k : numRows - 1 - k;
+        std::size_t rowLevel = 0;
+        const auto& row = A[rowIdx];
+        for (auto colIt = row.begin(); colIt != row.end(); ++colIt) {
+            std::size_t colIdx = colIt.index();
+            if ((lower && colIdx < rowIdx) || (!lower && colIdx > rowIdx))
+                rowLevel = std::max(rowLevel, level[colIdx] + 1);
+        }
+        level[rowIdx] = rowLevel;
+        numLevels = std::max(numLevels, rowLevel + 1);
+    }
+
+    // sort the rows by their level
+    levelOffsets.assign(numLevels + 1, 0);
+    for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+        ++levelOffsets[level[rowIdx] + 1];
+    for (std::size_t levelIdx = 0; levelIdx < numLevels; ++levelIdx)
+        levelOffsets[levelIdx + 1] += levelOffsets[levelIdx];
+
+    std::vector<std::size_t> pos(levelOffsets.begin(), levelOffsets.end() - 1);
+    rows.resize(numRows);
+    for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+        rows[pos[level[rowIdx]]++] = rowIdx;
+}
+
+// rethrow the first exception which was caught by a thread
+inline void rethrowFirst(const std::vector<std::exception_ptr>& errors)
+{
+    for (const auto& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+}
+
+} // namespace Detail
+
+/*!
+ * \brief A block-Jacobi preconditioner which uses ILU(0) for the diagonal blocks.
+ *
+ * The rows of the matrix are split into one contiguous block per thread and the
+ * couplings between these blocks are neglected. The factorization and the solves of
+ * the blocks are then done concurrently. For a single thread, this is equivalent to
+ * Dune::SeqILU0, but its quality deteriorates slightly with increasing number of
+ * threads.
+ */
+template <class M, class X, class Y>
+class ThreadedBlockILU0 : public Dune::Preconditioner<X, Y>
+{
+    using FactorMatrix = Dune::BCRSMatrix<typename M::block_type>;
+
+public:
+    using matrix_type = M;
+    using domain_type = X;
+    using range_type = Y;
+    using field_type = typename X::field_type;
+
+    ThreadedBlockILU0(const M& A, field_type relaxationFactor)
+        : LU_(A)
+        , relaxationFactor_(relaxationFactor)
+    {
+        std::size_t numRows = LU_.N();
+        std::size_t numBlocks = std::max<std::size_t>(1, std::min<std::size_t>(Detail::preconditionerThreads(), numRows));
+        blockOffsets_.resize(numBlocks + 1);
+        for (std::size_t blockIdx = 0; blockIdx <= numBlocks; ++blockIdx)
+            blockOffsets_[blockIdx] = blockIdx*numRows/numBlocks;
+
+        std::vector<std::exception_ptr> errors(numBlocks);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+        for (int blockIdx = 0; blockIdx < static_cast<int>(numBlocks); ++blockIdx) {
+            std::size_t rowBegin = blockOffsets_[static_cast<std::size_t>(blockIdx)];
+            std::size_t rowEnd = blockOffsets_[static_cast<std::size_t>(blockIdx) + 1];
+            try {
+                for (std::size_t rowIdx = rowBegin; rowIdx < rowEnd; ++rowIdx)
+                    Detail::ilu0FactorizeRow(LU_, rowIdx, rowBegin, rowEnd);
+            }
+            catch (...) {
+                errors[static_cast<std::size_t>(blockIdx)] = std::current_exception();
+            }
+        }
+        Detail::rethrowFirst(errors);
+    }
+
+    void pre(X&, Y&) override
+    {}
+
+    void apply(X& v, const Y& d) override
+    {
+        std::size_t numBlocks = blockOffsets_.size() - 1;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+        for (int blockIdx = 0; blockIdx < static_cast<int>(numBlocks); ++blockIdx) {
+            std::size_t rowBegin = blockOffsets_[static_cast<std::size_t>(blockIdx)];
+            std::size_t rowEnd = blockOffsets_[static_cast<std::size_t>(blockIdx) + 1];
+            Detail::ilu0SolveRange(LU_, v, d, rowBegin, rowEnd);
+            for (std::size_t rowIdx = rowBegin; rowIdx < rowEnd; ++rowIdx)
+                v[rowIdx] *= relaxationFactor_;
+        }
+    }
+
+    void post(X&) override
+    {}
+
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::sequential; }
+
+private:
+    FactorMatrix LU_;
+    field_type relaxationFactor_;
+    std::vector<std::size_t> blockOffsets_;
+};
+
+/*!
+ * \brief An ILU(0) preconditioner which uses level scheduling to parallelize the
+ *        factorization and the triangular solves.
+ *
+ * The rows of each level set only depend on rows of previous levels, so they can be
+ * processed concurrently. In contrast to ThreadedBlockILU0, the result is identical
+ * to the one of Dune::SeqILU0, but the available parallelism depends on the structure
+ * of the matrix.
+ */
+template <class M, class X, class Y>
+class LevelScheduledILU0 : public Dune::Preconditioner<X, Y>
+{
+    using FactorMatrix = Dune::BCRSMatrix<typename M::block_type>;
+
+public:
+    using matrix_type = M;
+    using domain_type = X;
+    using range_type = Y;
+    using field_type = typename X::field_type;
+
+    LevelScheduledILU0(const M& A, field_type relaxationFactor)
+        : LU_(A)
+        , relaxationFactor_(relaxationFactor)
+    {
+        Detail::computeLevelSets(LU_, /*lower=*/true, lowerRows_, lowerLevelOffsets_);
+        Detail::computeLevelSets(LU_, /*lower=*/false, upperRows_, upperLevelOffsets_);
+
+        // the factorization of a row depends on the same rows as its forward
+        // substitution
+        std::size_t numRows = LU_.N();
+        std::vector<std::exception_ptr> errors(Detail::preconditionerThreads());
+        for (std::size_t levelIdx = 0; levelIdx + 1 < lowerLevelOffsets_.size(); ++levelIdx) {
+            int levelBegin = static_cast<int>(lowerLevelOffsets_[levelIdx]);
+            int levelEnd = static_cast<int>(lowerLevelOffsets_[levelIdx + 1]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int i = levelBegin; i < levelEnd; ++i) {
+                try {
+                    Detail::ilu0FactorizeRow(LU_, lowerRows_[static_cast<std::size_t>(i)], 0, numRows);
+                }
+                catch (...) {
+                    errors[Detail::threadId()] = std::current_exception();
+                }
+            }
+            Detail::rethrowFirst(errors);
+        }
+    }
+
+    void pre(X&, Y&) override
+    {}
+
+    void apply(X& v, const Y& d) override
+    {
+        // forward substitution: v = L^-1 d
+        for (std::size_t levelIdx = 0; levelIdx + 1 < lowerLevelOffsets_.size(); ++levelIdx) {
+            int levelBegin = static_cast<int>(lowerLevelOffsets_[levelIdx]);
+            int levelEnd = static_cast<int>(lowerLevelOffsets_[levelIdx + 1]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int i = levelBegin; i < levelEnd; ++i) {
+                std::size_t rowIdx = lowerRows_[static_cast<std::size_t>(i)];
+                auto rhs = d[rowIdx];
+                const auto& row = LU_[rowIdx];
+                for (auto ijIt = row.begin(); ijIt.index() < rowIdx; ++ijIt)
+                    ijIt->mmv(v[ijIt.index()], rhs);
+                v[rowIdx] = rhs;
+            }
+        }
+
+        // backward substitution: v = U^-1 v
+        for (std::size_t levelIdx = 0; levelIdx + 1 < upperLevelOffsets_.size(); ++levelIdx) {
+            int levelBegin = static_cast<int>(upperLevelOffsets_[levelIdx]);
+            int levelEnd = static_cast<int>(upperLevelOffsets_[levelIdx + 1]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int i = levelBegin; i < levelEnd; ++i) {
+                std::size_t rowIdx = upperRows_[static_cast<std::size_t>(i)];
+                const auto& row = LU_[rowIdx];
+                auto rhs = v[rowIdx];
+                auto diagIt = row.find(rowIdx);
+                auto ijIt = diagIt;
+                for (++ijIt; ijIt != row.end(); ++ijIt)
+                    ijIt->mmv(v[ijIt.index()], rhs);
+                diagIt->mv(rhs, v[rowIdx]);
+            }
+        }
+
+        // the rows of the next levels depend on the unrelaxed values, so the relaxation
+        // factor can only be applied at the end
+        int numRows = static_cast<int>(v.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < numRows; ++i)
+            v[static_cast<std::size_t>(i)] *= relaxationFactor_;
+    }
+
+    void post(X&) override
+    {}
+
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::sequential; }
+
+private:
+    FactorMatrix LU_;
+    field_type relaxationFactor_;
+    std::vector<std::size_t> lowerRows_;
+    std::vector<std::size_t> lowerLevelOffsets_;
+    std::vector<std::size_t> upperRows_;
+    std::vector<std::size_t> upperLevelOffsets_;
+};
+
+/*!
+ * \brief A multi-color (symmetric) successive overrelaxation preconditioner.
+ *
+ * The rows of the matrix are colored such that rows of the same color are not coupled.
+ * The sweeps then process one color after the other and the rows of each color
+ * concurrently. If the relaxation factor is 1, this corresponds to a Gauss-Seidel
+ * preconditioner. Like Dune::SeqSOR, the matrix is referenced, not copied. If its
+ * entries change, update() must be called before the preconditioner is applied again.
+ */
+template <class M, class X, class Y, bool symmetric = false>
+class MultiColorSOR : public Dune::Preconditioner<X, Y>
+{
+    using Block = typename M::block_type;
+
+public:
+    using matrix_type = M;
+    using domain_type = X;
+    using range_type = Y;
+    using field_type = typename X::field_type;
+
+    MultiColorSOR(const M& A, int numIterations, field_type relaxationFactor)
+        : A_(A)
+        , numIterations_(numIterations)
+        , relaxationFactor_(relaxationFactor)
+    {
+        invertDiagonal_();
+        colorRows_();
+    }
+
+    /*!
+     * \brief Adapt the preconditioner to new entries of the matrix.
+     *
+     * The sparsity pattern of the matrix must not have changed, so only the inverses of
+     * the diagonal blocks are recomputed while the coloring of the rows is kept.
+     */
+    void update()
+    { invertDiagonal_(); }
+
+    void pre(X&, Y&) override
+    {}
+
+    void apply(X& v, const Y& d) override
+    {
+        v = 0.0;
+        std::size_t numColors = colorOffsets_.size() - 1;
+        for (int iterIdx = 0; iterIdx < numIterations_; ++iterIdx) {
+            for (std::size_t colorIdx = 0; colorIdx < numColors; ++colorIdx)
+                sweepColor_(v, d, colorIdx);
+
+            if (symmetric)
+                for (std::size_t colorIdx = numColors; colorIdx > 0; --colorIdx)
+                    sweepColor_(v, d, colorIdx - 1);
+        }
+    }
+
+    void post(X&) override
+    {}
+
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::sequential; }
+
+    /*!
+     * \brief Returns the number of colors which were required to decouple the rows.
+     */
+    std::size_t numColors() const
+    { return colorOffsets_.size() - 1; }
+
+private:
+    void invertDiagonal_()
+    {
+        std::size_t numRows = A_.N();
+        invDiag_.resize(numRows);
+
+        std::vector<std::exception_ptr> errors(Detail::preconditionerThreads());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < static_cast<int>(numRows); ++i) {
+            std::size_t rowIdx = static_cast<std::size_t>(i);
+            try {
+                auto diagIt = A_[rowIdx].find(rowIdx);
+                if (diagIt == A_[rowIdx].end())
+                    DUNE_THROW(Dune::ISTLError, "Row " << rowIdx << " does not exhibit a diagonal entry");
+                invDiag_[rowIdx] = *diagIt;
+                invDiag_[rowIdx].invert();
+            }
+            catch (...) {
+                errors[Detail::threadId()] = std::current_exception();
+            }
+        }
+        Detail::rethrowFirst(errors);
+    }
+
+    void sweepColor_(X& v, const Y& d, std::size_t colorIdx) const
+    {
+        int colorBegin = static_cast<int>(colorOffsets_[colorIdx]);
+        int colorEnd = static_cast<int>(colorOffsets_[colorIdx + 1]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = colorBegin; i < colorEnd; ++i) {
+            std::size_t rowIdx = rows_[static_cast<std::size_t>(i)];
+
+            // rhs = d_i - sum_(j != i) a_ij*v_j
+            auto rhs = d[rowIdx];
+            const auto& row = A_[rowIdx];
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+                if (colIt.index() != rowIdx)
+                    colIt->mmv(v[colIt.index()], rhs);
+
+            // v_i = (1 - omega)*v_i + omega*a_ii^-1*rhs
+            auto update = v[rowIdx];
+            invDiag_[rowIdx].mv(rhs, update);
+            v[rowIdx] *= (1.0 - relaxationFactor_);
+            v[rowIdx].axpy(relaxationFactor_, update);
+        }
+    }
+
+    // greedily color the graph of the matrix. since the matrix may be structurally
+    // unsymmetric, the neighbors of a row are given by its row as well as its column.
+    void colorRows_()
+    {
+        std::size_t numRows = A_.N();
+
+        std::vector<std::size_t> transposedOffsets(numRows + 1, 0);
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            for (auto colIt = A_[rowIdx].begin(); colIt != A_[rowIdx].end(); ++colIt)
+                ++transposedOffsets[colIt.index() + 1];
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            transposedOffsets[rowIdx + 1] += transposedOffsets[rowIdx];
+        std::vector<std::size_t> transposedCols(transposedOffsets.back());
+        std::vector<std::size_t> pos(transposedOffsets.begin(), transposedOffsets.end() - 1);
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            for (auto colIt = A_[rowIdx].begin(); colIt != A_[rowIdx].end(); ++colIt)
+                transposedCols[pos[colIt.index()]++] = rowIdx;
+
+        const std::size_t noColor = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> color(numRows, noColor);
+        std::vector<std::size_t> colorUsedBy;
+        std::size_t numColors = 0;
+        auto markNeighbor = [&](std::size_t rowIdx, std::size_t neighborIdx) {
+            if (color[neighborIdx] != noColor)
+                colorUsedBy[color[neighborIdx]] = rowIdx;
+        };
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            for (auto colIt = A_[rowIdx].begin(); colIt != A_[rowIdx].end(); ++colIt)
+                markNeighbor(rowIdx, colIt.index());
+            for (std::size_t k = transposedOffsets[rowIdx]; k < transposedOffsets[rowIdx + 1]; ++k)
+                markNeighbor(rowIdx, transposedCols[k]);
+
+            std::size_t rowColor = 0;
+            while (rowColor < numColors && colorUsedBy[rowColor] == rowIdx)
+                ++rowColor;
+            if (rowColor == numColors) {
+                ++numColors;
+                colorUsedBy.push_back(noColor);
+            }
+            color[rowIdx] = rowColor;
+        }
+
+        // sort the rows by their color
+        colorOffsets_.assign(numColors + 1, 0);
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            ++colorOffsets_[color[rowIdx] + 1];
+        for (std::size_t colorIdx = 0; colorIdx < numColors; ++colorIdx)
+            colorOffsets_[colorIdx + 1] += colorOffsets_[colorIdx];
+
+        std::vector<std::size_t> colorPos(colorOffsets_.begin(), colorOffsets_.end() - 1);
+        rows_.resize(numRows);
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            rows_[colorPos[color[rowIdx]]++] = rowIdx;
+    }
+
+    const M& A_;
+    int numIterations_;
+    field_type relaxationFactor_;
+    std::vector<Block> invDiag_;
+    std::vector<std::size_t> rows_;
+    std::vector<std::size_t> colorOffsets_;
+};
+
+/*!
+ * \brief The symmetric variant of the multi-color SOR preconditioner.
+ */
+template <class M, class X, class Y>
+using MultiColorSSOR = MultiColorSOR<M, X, Y, /*symmetric=*/true>;
+
+} // namespace Linear
+} // namespace Opm
+
+#endif
@@ -0,0 +1,60 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Two-phase test for the immiscible model which solves the linear systems using a
+ *        Krylov iteration in double precision and a preconditioner in single precision
+ */
+#include "config.h"
+
+#include "lens_immiscible_ecfv_ad.hh"
+
+#include <type_traits>
+
+namespace Opm::Properties {
+
+namespace TTag {
+struct LensProblemEcfvAdMixedPrecision { using InheritsFrom = std::tuple<LensProblemEcfvAd>; };
+} // end namespace TTag
+
+// store the matrix of the preconditioner and the preconditioner in single precision
+template<class TypeTag>
+struct LinearSolverScalar<TypeTag, TTag::LensProblemEcfvAdMixedPrecision> { using type = float; };
+
+// run the Krylov iteration and evaluate the residual in the precision of the model
+template<class TypeTag>
+struct LinearSolverMixedPrecision<TypeTag, TTag::LensProblemEcfvAdMixedPrecision> { static constexpr bool value = true; };
+
+} // namespace Opm::Properties
+
+#include <opm/models/utils/start.hh>
+
+int main(int argc, char **argv)
+{
+    using ProblemTypeTag = Opm::Properties::TTag::LensProblemEcfvAdMixedPrecision;
+    static_assert(std::is_same<Opm::GetPropType<ProblemTypeTag, Opm::Properties::LinearSolverScalar>, float>::value
+                  && !std::is_same<Opm::GetPropType<ProblemTypeTag, Opm::Properties::Scalar>, float>::value,
+                  "The mixed precision test must use a less accurate type for the linear solver");
+    return Opm::start<ProblemTypeTag>(argc, argv);
+}
@@ -0,0 +1,274 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief Test for the kernels for small dense blocks and for the block-CSR
+ *        matrix-vector products.
+ *
+ * The results are compared against the ones of the generic Dune code.
+ */
+#include "config.h"
+
+#include <opm/simulators/linalg/blockkernels.hh>
+#include <opm/simulators/linalg/matrixblock.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::mt19937 randomGenerator(42);
+
+double randomValue()
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    return dist(randomGenerator);
+}
+
+void check(bool condition, const std::string& msg)
+{
+    if (!condition)
+        throw std::logic_error(msg);
+}
+
+template <class V1, class V2>
+void checkClose(const V1& a, const V2& b, unsigned size, const std::string& msg)
+{
+    for (unsigned i = 0; i < size; ++i) {
+        if (std::abs(a[i] - b[i]) > 1e-12*(1.0 + std::abs(b[i]))) {
+            std::ostringstream oss;
+            oss << msg << ": entry " << i << " is " << a[i] << " instead of " << b[i];
+            throw std::logic_error(oss.str());
+        }
+    }
+}
+
+// a random block with a dominant diagonal which is not symmetric and which requires
+// pivoting
+template <int n>
+Dune::FieldMatrix<double, n, n> randomRegularBlock()
+{
+    Dune::FieldMatrix<double, n, n> A;
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            A[i][j] = randomValue();
+    for (int i = 0; i < n; ++i)
+        A[i][(i + 1) % n] += 2.0*n;
+    return A;
+}
+
+template <int n>
+void testBlock()
+{
+    const std::string name = std::to_string(n) + "x" + std::to_string(n);
+
+    const auto A = randomRegularBlock<n>();
+    Dune::FieldVector<double, n> x;
+    for (int i = 0; i < n; ++i)
+        x[i] = randomValue();
+
+    // inversion
+    auto refInv = A;
+    refInv.invert();
+
+    auto inv = A;
+    Opm::MatrixBlockHelp::blockInvert<double, n>(&inv[0][0]);
+    for (int i = 0; i < n; ++i)
+        checkClose(inv[i], refInv[i], n, "blockInvert() for " + name);
+
+    Opm::MatrixBlock<double, n, n> blockInv;
+    blockInv = A;
+    blockInv.invert();
+    for (int i = 0; i < n; ++i)
+        checkClose(blockInv[i], refInv[i], n, "MatrixBlock::invert() for " + name);
+
+    // matrix-vector products
+    Dune::FieldVector<double, n> refY, y;
+    A.mv(x, refY);
+    Opm::MatrixBlockHelp::blockMv<double, n, n>(&A[0][0], &x[0], &y[0]);
+    checkClose(y, refY, n, "blockMv() for " + name);
+
+    Opm::MatrixBlock<double, n, n> block;
+    block = A;
+    block.mv(x, y);
+    checkClose(y, refY, n, "MatrixBlock::mv() for " + name);
+
+    refY = 1.0;
+    A.usmv(-0.5, x, refY);
+    y = 1.0;
+    Opm::MatrixBlockHelp::blockUsmv<double, n, n>(-0.5, &A[0][0], &x[0], &y[0]);
+    checkClose(y, refY, n, "blockUsmv() for " + name);
+
+    y = 1.0;
+    block.usmv(-0.5, x, y);
+    checkClose(y, refY, n, "MatrixBlock::usmv() for " + name);
+
+    refY = 1.0;
+    A.umv(x, refY);
+    y = 1.0;
+    block.umv(x, y);
+    checkClose(y, refY, n, "MatrixBlock::umv() for " + name);
+
+    refY = 1.0;
+    A.mmv(x, refY);
+    y = 1.0;
+    block.mmv(x, y);
+    checkClose(y, refY, n, "MatrixBlock::mmv() for " + name);
+
+    // singular blocks are reported like by Dune
+    Dune::FieldMatrix<double, n, n> singular(0.0);
+    bool caught = false;
+    try {
+        Opm::MatrixBlockHelp::blockInvert<double, n>(&singular[0][0]);
+    }
+    catch (const Dune::FMatrixError&) {
+        caught = true;
+    }
+    check(caught, "singular " + name + " block not detected");
+}
+
+template <int n>
+void testBlockCsr()
+{
+    const std::string name = std::to_string(n) + "x" + std::to_string(n);
+
+    using RefMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, n, n>>;
+    using Matrix = Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, n>>;
+    static_assert(Opm::MatrixBlockHelp::useBlockCsrKernels<Matrix, Vector, Vector>(),
+                  "The block-CSR kernels must be applicable");
+
+    // a banded matrix with a few additional off-diagonal entries. it is large enough
+    // for the product to be computed by several threads.
+    const unsigned numRows = 1234;
+    RefMatrix refA(numRows, numRows, RefMatrix::random);
+    std::vector<std::vector<unsigned>> sparsity(numRows);
+    for (unsigned i = 0; i < numRows; ++i) {
+        for (unsigned j = (i > 0) ? i - 1 : 0; j < std::min(numRows, i + 2); ++j)
+            sparsity[i].push_back(j);
+        if (i + 10 < numRows)
+            sparsity[i].push_back(i + 10);
+        refA.setrowsize(i, sparsity[i].size());
+    }
+    refA.endrowsizes();
+    for (unsigned i = 0; i < numRows; ++i)
+        for (unsigned j : sparsity[i])
+            refA.addindex(i, j);
+    refA.endindices();
+
+    Matrix A(numRows, numRows, Matrix::random);
+    for (unsigned i = 0; i < numRows; ++i)
+        A.setrowsize(i, sparsity[i].size());
+    A.endrowsizes();
+    for (unsigned i = 0; i < numRows; ++i)
+        for (unsigned j : sparsity[i])
+            A.addindex(i, j);
+    A.endindices();
+
+    for (unsigned i = 0; i < numRows; ++i) {
+        for (unsigned j : sparsity[i]) {
+            for (int k = 0; k < n; ++k) {
+                for (int l = 0; l < n; ++l) {
+                    double value = randomValue();
+                    refA[i][j][k][l] = value;
+                    A[i][j][k][l] = value;
+                }
+            }
+        }
+    }
+
+    Vector x(numRows);
+    for (unsigned i = 0; i < numRows; ++i)
+        for (int k = 0; k < n; ++k)
+            x[i][k] = randomValue();
+
+    // all rows
+    Vector refY(numRows), y(numRows);
+    refA.mv(x, refY);
+    y = 123.0;
+    Opm::MatrixBlockHelp::blockCsrMv(A, nullptr, numRows, 1.0, /*add=*/false, x, y);
+    for (unsigned i = 0; i < numRows; ++i)
+        checkClose(y[i], refY[i], n, "blockCsrMv() for " + name);
+
+    refY = 1.0;
+    refA.usmv(-2.0, x, refY);
+    y = 1.0;
+    Opm::MatrixBlockHelp::blockCsrMv(A, nullptr, numRows, -2.0, /*add=*/true, x, y);
+    for (unsigned i = 0; i < numRows; ++i)
+        checkClose(y[i], refY[i], n, "blockCsrMv() with addition for " + name);
+
+    // a subset of the rows. the remaining ones must not be touched.
+    std::vector<unsigned> rows;
+    for (unsigned i = 0; i < numRows; i += 3)
+        rows.push_back(i);
+
+    refY = 1.0;
+    refA.usmv(0.5, x, refY);
+    y = 1.0;
+    Opm::MatrixBlockHelp::blockCsrMv(A, rows.data(), rows.size(), 0.5, /*add=*/true, x, y);
+    for (unsigned i = 0; i < numRows; ++i) {
+        if (i % 3 == 0)
+            checkClose(y[i], refY[i], n, "blockCsrMv() for a subset of the rows for " + name);
+        else
+            checkClose(y[i], Dune::FieldVector<double, n>(1.0), n,
+                       "blockCsrMv() modified a row outside of the subset for " + name);
+    }
+}
+
+} // anonymous namespace
+
+int main()
+{
+    try {
+        testBlock<1>();
+        testBlock<2>();
+        testBlock<3>();
+        testBlock<4>();
+        testBlock<5>();
+        testBlock<6>();
+
+        testBlockCsr<2>();
+        testBlockCsr<3>();
+        testBlockCsr<4>();
+        testBlockCsr<5>();
+        testBlockCsr<6>();
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "block kernel test passed\n";
+    return 0;
+}
@@ -0,0 +1,100 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is a simple test that ensures that the chunk scheduler hands out every
+ *        index exactly once, even if some threads are much slower than others.
+ */
+#include "config.h"
+
+#include <opm/models/parallel/chunkscheduler.hh>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    const size_t numIndices = 10007;
+    unsigned numThreads = 1;
+#ifdef _OPENMP
+    numThreads = static_cast<unsigned>(omp_get_max_threads());
+#endif
+
+    for (size_t chunkSize : {1, 7, 64, 20000}) {
+        std::vector<int> visitCount(numIndices, 0);
+
+        Opm::ChunkScheduler scheduler(numIndices, numThreads, chunkSize);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            unsigned threadId = 0;
+#ifdef _OPENMP
+            threadId = static_cast<unsigned>(omp_get_thread_num());
+#endif
+            size_t beginIdx, endIdx;
+            while (scheduler.nextChunk(threadId, beginIdx, endIdx)) {
+                if (beginIdx >= endIdx || endIdx > numIndices) {
+                    std::cout << "Invalid chunk [" << beginIdx << ", " << endIdx << ")\n";
+                    std::abort();
+                }
+
+                // make the first thread slow so that the others need to steal its work
+                if (threadId == 0)
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+                // the chunks are disjoint, so no synchronization is required here
+                for (size_t idx = beginIdx; idx < endIdx; ++idx)
+                    ++visitCount[idx];
+            }
+        }
+
+        for (size_t idx = 0; idx < numIndices; ++idx) {
+            if (visitCount[idx] != 1) {
+                std::cout << "Index " << idx << " was visited " << visitCount[idx]
+                          << " times for a chunk size of " << chunkSize << "\n";
+                return 1;
+            }
+        }
+    }
+
+    // make sure that no work is handed out after the loop has been aborted
+    Opm::ChunkScheduler scheduler(numIndices, numThreads, /*chunkSize=*/16);
+    size_t beginIdx, endIdx;
+    if (!scheduler.nextChunk(/*threadId=*/0, beginIdx, endIdx))
+        return 1;
+    scheduler.setFinished();
+    for (unsigned threadId = 0; threadId < numThreads; ++threadId)
+        if (scheduler.nextChunk(threadId, beginIdx, endIdx))
+            return 1;
+
+    return 0;
+}
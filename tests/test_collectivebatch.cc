@@ -0,0 +1,108 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief Test for Opm::CollectiveBatch.
+ *
+ * This test works sequentially as well as in parallel.
+ */
+#include "config.h"
+
+#include <opm/models/parallel/collectivebatch.hh>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void check(bool condition, const std::string& msg)
+{
+    if (!condition)
+        throw std::logic_error(msg);
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    // initialize MPI, finalize is done automatically on exit
+    const auto& mpiHelper = Dune::MPIHelper::instance(argc, argv);
+    int rank = mpiHelper.rank();
+    int size = mpiHelper.size();
+
+    try {
+        Opm::CollectiveBatch collectives(Dune::MPIHelper::getCommunicator());
+
+        // maxima and sums
+        double maxRank = -1.0, minRank = -1.0, sumRanks = -1.0;
+        collectives.addStatus(true, "this status must not fail");
+        collectives.addMax(rank, [&](double v) { maxRank = v; });
+        collectives.addSum(rank + 1, [&](double v) { sumRanks = v; });
+        collectives.addMax(-rank, [&](double v) { minRank = -v; });
+        collectives.sync();
+        check(collectives.empty(), "batch not empty after sync");
+        check(maxRank == size - 1, "wrong maximum");
+        check(minRank == 0, "wrong minimum");
+        check(sumRanks == size*(size + 1)/2, "wrong sum");
+
+        // a status which fails on a single process
+        bool sumCalled = false;
+        collectives.addStatus(rank != size - 1, "expected failure");
+        collectives.addSum(1.0, [&](double) { sumCalled = true; });
+        bool caught = false;
+        try {
+            collectives.sync();
+        }
+        catch (const Opm::NumericalIssue& e) {
+            caught = std::string(e.what()) == "expected failure";
+        }
+        check(caught, "failed status not reported");
+        check(!sumCalled, "result functor called despite failure");
+        check(collectives.empty(), "batch not empty after failure");
+
+        // NaNs are propagated by the maximum
+        double maxVal = 0.0;
+        double localVal = (rank == 0) ? std::numeric_limits<double>::quiet_NaN() : 1.0;
+        collectives.addMax(localVal, [&](double v) { maxVal = v; });
+        collectives.sync();
+        check(std::isnan(maxVal), "NaN not propagated");
+
+        // nothing is communicated for an empty batch
+        collectives.sync();
+        check(collectives.numSyncs() == 3, "wrong number of collective operations");
+    }
+    catch (const std::exception& e) {
+        std::cerr << "rank " << rank << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    if (rank == 0)
+        std::cout << "collective batch test passed on " << size << " process(es)\n";
+
+    return 0;
+}
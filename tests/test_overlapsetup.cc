@@ -0,0 +1,715 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief Test and benchmark for setting up the algebraic overlap.
+ *
+ * First, a structured grid of vertices is decomposed into vertical strips, one for each
+ * process, and the overlapping matrix of a five-point stencil is built using
+ * Opm::Linear::OverlappingBCRSMatrix for several overlap sizes. Its domestic overlap,
+ * its global indices and its sparsity pattern are compared with a reference which is
+ * computed from the whole grid using std::set and std::map. Also, it is checked that
+ * assembling the native matrix directly into the overlapping one yields the same
+ * entries as assigning it. This check works sequentially as well as in parallel.
+ *
+ * Then, the setup of the overlap is benchmarked: A three-dimensional grid of vertices is
+ * decomposed into blocks, one for each process, and the time for determining the
+ * foreign overlap, the domestic overlap (i.e., the global indices and the indices which
+ * are exchanged with the peer processes) and for building the overlapping matrix are
+ * measured. The slowest process determines the reported times. To get meaningful
+ * numbers for many processes, run the test on a cluster, e.g., using
+ * "mpirun -np 1000 test_overlapsetup 1 CELLS_PER_DIM".
+ *
+ * Finally, as a secondary check for sequential runs, the MPI layout of many processes
+ * is simulated for the index maps only: The processes are arranged as a cube and each
+ * of them owns a cube of cells which are numbered consecutively in the order of the
+ * ranks, which is how Opm::Linear::GlobalIndices numbers the indices of the master
+ * processes. For the process at the center of the layout, the global indices of its
+ * local cells and of the cells in its overlap are added to the index maps and the
+ * global indices of all neighbors of its cells are translated back to domestic ones. This is done using
+ * Opm::Linear::FlatIndexMap and, as a reference, using std::map.
+ *
+ * Usage: test_overlapsetup [MAX_RANKS [CELLS_PER_DIM]]
+ *
+ * MAX_RANKS is the maximum number of processes which are simulated by the benchmark of
+ * the index maps, CELLS_PER_DIM the number of vertices or cells per process and
+ * direction used by both benchmarks.
+ */
+#include "config.h"
+
+#include <opm/simulators/linalg/overlappingbcrsmatrix.hh>
+#include <opm/simulators/linalg/flatindexmap.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+namespace {
+
+using Index = Opm::Linear::Index;
+
+struct Layout
+{
+    int ranksPerDim;
+    int cellsPerDim;
+    int overlapSize;
+
+    int globalCellsPerDim() const
+    { return ranksPerDim*cellsPerDim; }
+
+    // the global index of a cell given by its global coordinates
+    Index globalIndex(int x, int y, int z) const
+    {
+        int rankX = x/cellsPerDim, rankY = y/cellsPerDim, rankZ = z/cellsPerDim;
+        int rank = (rankZ*ranksPerDim + rankY)*ranksPerDim + rankX;
+        int localX = x%cellsPerDim, localY = y%cellsPerDim, localZ = z%cellsPerDim;
+        int numCells = cellsPerDim*cellsPerDim*cellsPerDim;
+        return rank*numCells + (localZ*cellsPerDim + localY)*cellsPerDim + localX;
+    }
+};
+
+// the global indices of the cells of the central process including its overlap, i.e.,
+// the domestic cells. the local cells come first.
+std::vector<Index> domesticCells(const Layout& layout)
+{
+    int centralRank = layout.ranksPerDim/2;
+    int begin = centralRank*layout.cellsPerDim;
+    int end = begin + layout.cellsPerDim;
+    int overlapBegin = std::max(0, begin - layout.overlapSize);
+    int overlapEnd = std::min(layout.globalCellsPerDim(), end + layout.overlapSize);
+
+    std::vector<Index> result;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int z = overlapBegin; z < overlapEnd; ++z) {
+            for (int y = overlapBegin; y < overlapEnd; ++y) {
+                for (int x = overlapBegin; x < overlapEnd; ++x) {
+                    bool isLocal =
+                        begin <= x && x < end
+                        && begin <= y && y < end
+                        && begin <= z && z < end;
+                    if (isLocal == (pass == 0))
+                        result.push_back(layout.globalIndex(x, y, z));
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// the global indices of the neighbors of all domestic cells which are domestic
+// themselves or not. the latter are the ones at the front of the overlap.
+std::vector<Index> neighborCells(const Layout& layout)
+{
+    int centralRank = layout.ranksPerDim/2;
+    int begin = std::max(0, centralRank*layout.cellsPerDim - layout.overlapSize);
+    int end = std::min(layout.globalCellsPerDim(),
+                       (centralRank + 1)*layout.cellsPerDim + layout.overlapSize);
+    int n = layout.globalCellsPerDim();
+
+    std::vector<Index> result;
+    for (int z = begin; z < end; ++z) {
+        for (int y = begin; y < end; ++y) {
+            for (int x = begin; x < end; ++x) {
+                if (x > 0) result.push_back(layout.globalIndex(x - 1, y, z));
+                if (x < n - 1) result.push_back(layout.globalIndex(x + 1, y, z));
+                if (y > 0) result.push_back(layout.globalIndex(x, y - 1, z));
+                if (y < n - 1) result.push_back(layout.globalIndex(x, y + 1, z));
+                if (z > 0) result.push_back(layout.globalIndex(x, y, z - 1));
+                if (z < n - 1) result.push_back(layout.globalIndex(x, y, z + 1));
+            }
+        }
+    }
+    return result;
+}
+
+template <class Fn>
+double timeIt(Fn fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void runLayout(const Layout& layout)
+{
+    const auto domestic = domesticCells(layout);
+    const auto neighbors = neighborCells(layout);
+
+    Opm::Linear::FlatIndexMap flatMap;
+    std::vector<Index> flatLookup(neighbors.size());
+    double flatTime = timeIt([&]() {
+        flatMap.reserve(domestic.size());
+        for (unsigned domIdx = 0; domIdx < domestic.size(); ++domIdx)
+            flatMap.insert(domestic[domIdx], static_cast<Index>(domIdx));
+        for (unsigned i = 0; i < neighbors.size(); ++i)
+            flatLookup[i] = flatMap.find(neighbors[i]);
+    });
+
+    std::map<Index, Index> treeMap;
+    std::vector<Index> treeLookup(neighbors.size());
+    double treeTime = timeIt([&]() {
+        for (unsigned domIdx = 0; domIdx < domestic.size(); ++domIdx)
+            treeMap[domestic[domIdx]] = static_cast<Index>(domIdx);
+        for (unsigned i = 0; i < neighbors.size(); ++i) {
+            auto it = treeMap.find(neighbors[i]);
+            treeLookup[i] = (it == treeMap.end()) ? -1 : it->second;
+        }
+    });
+
+    if (flatMap.size() != treeMap.size() || flatLookup != treeLookup)
+        throw std::logic_error("The flat index map and std::map disagree");
+
+    int numRanks = layout.ranksPerDim*layout.ranksPerDim*layout.ranksPerDim;
+    std::cout << "ranks: " << numRanks
+              << ", domestic indices: " << domestic.size()
+              << ", lookups: " << neighbors.size()
+              << ", flat map: " << flatTime << " s"
+              << ", std::map: " << treeTime << " s\n";
+}
+
+// a structured grid of vertices which is decomposed into vertical strips. neighboring
+// strips share a column of vertices, i.e., the decomposition is the one used by
+// vertex-centered discretizations.
+struct StripLayout
+{
+    int numX;
+    int numY;
+    int numRanks;
+
+    int firstColumn(int rank) const
+    { return rank*(numX - 1)/numRanks; }
+
+    int lastColumn(int rank) const
+    { return (rank + 1)*(numX - 1)/numRanks; }
+
+    int numColumns(int rank) const
+    { return lastColumn(rank) - firstColumn(rank) + 1; }
+
+    int vertexIdx(int x, int y) const
+    { return y*numX + x; }
+
+    Index nativeIdx(int rank, int x, int y) const
+    { return y*numColumns(rank) + x - firstColumn(rank); }
+
+    // the vertices which are coupled with a given one by the five-point stencil
+    std::vector<int> stencil(int vertexIdx) const
+    {
+        int x = vertexIdx%numX;
+        int y = vertexIdx/numX;
+        std::vector<int> result{vertexIdx};
+        if (x > 0) result.push_back(vertexIdx - 1);
+        if (x < numX - 1) result.push_back(vertexIdx + 1);
+        if (y > 0) result.push_back(vertexIdx - numX);
+        if (y < numY - 1) result.push_back(vertexIdx + numX);
+        return result;
+    }
+};
+
+using NativeMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1> >;
+using OverlappingMatrix = Opm::Linear::OverlappingBCRSMatrix<NativeMatrix>;
+
+void check(bool condition, const std::string& msg)
+{
+    if (!condition)
+        throw std::logic_error(msg);
+}
+
+// the native matrix of the strip of a process. its rows are ordered row-wise.
+NativeMatrix stripMatrix(const StripLayout& layout, int rank)
+{
+    int numColumns = layout.numColumns(rank);
+    int numRows = numColumns*layout.numY;
+    NativeMatrix matrix(static_cast<size_t>(numRows), static_cast<size_t>(numRows), NativeMatrix::random);
+    for (int rowIdx = 0; rowIdx < numRows; ++rowIdx)
+        matrix.setrowsize(static_cast<size_t>(rowIdx), 5);
+    matrix.endrowsizes();
+
+    for (int y = 0; y < layout.numY; ++y) {
+        for (int x = layout.firstColumn(rank); x <= layout.lastColumn(rank); ++x) {
+            for (int vertexIdx : layout.stencil(layout.vertexIdx(x, y))) {
+                int nx = vertexIdx%layout.numX;
+                int ny = vertexIdx/layout.numX;
+                if (nx < layout.firstColumn(rank) || nx > layout.lastColumn(rank))
+                    continue;
+                matrix.addindex(static_cast<size_t>(layout.nativeIdx(rank, x, y)),
+                                static_cast<size_t>(layout.nativeIdx(rank, nx, ny)));
+            }
+        }
+    }
+    matrix.endindices();
+    return matrix;
+}
+
+// the vertices of the columns which are shared with the neighboring strips
+Opm::Linear::BorderList stripBorderList(const StripLayout& layout, int rank)
+{
+    Opm::Linear::BorderList borderList;
+    for (int peerRank : {rank - 1, rank + 1}) {
+        if (peerRank < 0 || peerRank >= layout.numRanks)
+            continue;
+
+        int x = (peerRank < rank) ? layout.firstColumn(rank) : layout.lastColumn(rank);
+        for (int y = 0; y < layout.numY; ++y) {
+            Opm::Linear::BorderIndex borderIdx;
+            borderIdx.localIdx = layout.nativeIdx(rank, x, y);
+            borderIdx.peerIdx = layout.nativeIdx(peerRank, x, y);
+            borderIdx.peerRank = static_cast<Opm::Linear::ProcessRank>(peerRank);
+            borderIdx.borderDistance = 0;
+            borderList.push_back(borderIdx);
+        }
+    }
+    return borderList;
+}
+
+// the vertices which are at most overlapSize hops away from the strip of a process,
+// i.e., the reference for the domestic overlap
+std::set<int> referenceDomestic(const StripLayout& layout, int rank, unsigned overlapSize)
+{
+    std::set<int> result;
+    for (int y = 0; y < layout.numY; ++y)
+        for (int x = layout.firstColumn(rank); x <= layout.lastColumn(rank); ++x)
+            result.insert(layout.vertexIdx(x, y));
+
+    for (unsigned hopIdx = 0; hopIdx < overlapSize; ++hopIdx) {
+        std::set<int> extended(result);
+        for (int vertexIdx : result)
+            for (int neighborIdx : layout.stencil(vertexIdx))
+                extended.insert(neighborIdx);
+        result.swap(extended);
+    }
+    return result;
+}
+
+// gather the vertex which corresponds to each global index from all processes
+std::map<Index, int> globalToVertex(const StripLayout& layout,
+                                    const OverlappingMatrix::Overlap& overlap,
+                                    int rank)
+{
+    std::vector<int> localPairs;
+    for (int y = 0; y < layout.numY; ++y) {
+        for (int x = layout.firstColumn(rank); x <= layout.lastColumn(rank); ++x) {
+            Index domesticIdx = overlap.nativeToDomestic(layout.nativeIdx(rank, x, y));
+            check(overlap.isLocal(domesticIdx), "a vertex of the strip is not local");
+            localPairs.push_back(overlap.domesticToGlobal(domesticIdx));
+            localPairs.push_back(layout.vertexIdx(x, y));
+        }
+    }
+
+    std::vector<int> allPairs(localPairs);
+#if HAVE_MPI
+    int numLocalPairs = static_cast<int>(localPairs.size());
+    std::vector<int> sizes(static_cast<size_t>(layout.numRanks));
+    MPI_Allgather(&numLocalPairs, 1, MPI_INT, sizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    std::vector<int> offsets(sizes.size() + 1, 0);
+    for (size_t i = 0; i < sizes.size(); ++i)
+        offsets[i + 1] = offsets[i] + sizes[i];
+
+    allPairs.resize(static_cast<size_t>(offsets.back()));
+    MPI_Allgatherv(localPairs.data(), numLocalPairs, MPI_INT,
+                   allPairs.data(), sizes.data(), offsets.data(), MPI_INT,
+                   MPI_COMM_WORLD);
+#endif
+
+    // the vertices on the borders are local to two processes which must agree on
+    // their global index
+    std::map<Index, int> result;
+    std::map<int, Index> vertexToGlobal;
+    for (size_t i = 0; i < allPairs.size(); i += 2) {
+        Index globalIdx = allPairs[i];
+        int vertexIdx = allPairs[i + 1];
+        auto globalIt = result.emplace(globalIdx, vertexIdx).first;
+        auto vertexIt = vertexToGlobal.emplace(vertexIdx, globalIdx).first;
+        check(globalIt->second == vertexIdx && vertexIt->second == globalIdx,
+              "the processes disagree about a global index");
+    }
+
+    int numVertices = layout.numX*layout.numY;
+    check(static_cast<int>(result.size()) == numVertices
+          && result.begin()->first == 0
+          && result.rbegin()->first == numVertices - 1,
+          "the global indices are not consecutive");
+
+    return result;
+}
+
+void checkStripLayout(const StripLayout& layout, int rank, unsigned overlapSize)
+{
+    Opm::Linear::BlackList blackList;
+    NativeMatrix nativeMatrix = stripMatrix(layout, rank);
+    OverlappingMatrix matrix(nativeMatrix,
+                             stripBorderList(layout, rank),
+                             blackList,
+                             overlapSize);
+    const auto& overlap = matrix.overlap();
+
+    const auto vertexOf = globalToVertex(layout, overlap, rank);
+    const auto domestic = referenceDomestic(layout, rank, overlapSize);
+
+    // the index maps
+    check(overlap.numLocal() == nativeMatrix.N(), "wrong number of local indices");
+    check(overlap.numDomestic() == domestic.size(), "wrong number of domestic indices");
+
+    std::map<int, Index> vertexToDomestic;
+    for (Index domesticIdx = 0; static_cast<size_t>(domesticIdx) < overlap.numDomestic(); ++domesticIdx) {
+        Index globalIdx = overlap.domesticToGlobal(domesticIdx);
+        check(overlap.globalToDomestic(globalIdx) == domesticIdx,
+              "the global index of a domestic index does not map back to it");
+
+        auto vertexIt = vertexOf.find(globalIdx);
+        check(vertexIt != vertexOf.end(), "unknown global index");
+        check(domestic.count(vertexIt->second) > 0, "a domestic index is not in the overlap");
+        vertexToDomestic[vertexIt->second] = domesticIdx;
+    }
+    check(vertexToDomestic.size() == domestic.size(), "a vertex is domestic more than once");
+
+    // the sparsity pattern
+    check(matrix.N() == overlap.numDomestic(), "wrong number of rows");
+    for (const auto& vertexAndDomestic : vertexToDomestic) {
+        std::set<Index> refCols;
+        for (int neighborIdx : layout.stencil(vertexAndDomestic.first)) {
+            auto it = vertexToDomestic.find(neighborIdx);
+            if (it != vertexToDomestic.end())
+                refCols.insert(it->second);
+        }
+
+        std::set<Index> cols;
+        const auto& row = matrix[static_cast<size_t>(vertexAndDomestic.second)];
+        for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+            cols.insert(static_cast<Index>(colIt.index()));
+
+        if (cols != refCols) {
+            std::ostringstream oss;
+            oss << "wrong sparsity pattern of the row of vertex " << vertexAndDomestic.first;
+            throw std::logic_error(oss.str());
+        }
+    }
+
+    // without black listed indices, the native matrix can be assembled directly into
+    // the overlapping one. after synchronizing, the entries must be the same as the ones
+    // which are obtained by assigning the native matrix.
+    check(matrix.embeddedLayout(), "the native matrix is not embedded into the overlapping one");
+    for (size_t rowIdx = 0; rowIdx < nativeMatrix.N(); ++rowIdx) {
+        auto& row = nativeMatrix[rowIdx];
+        for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+            *colIt = 1.0 + static_cast<double>(rank) + 0.01*static_cast<double>(rowIdx + 3*colIt.index());
+    }
+    matrix.assignFromNative(nativeMatrix);
+    matrix.syncAdd();
+
+    OverlappingMatrix inPlaceMatrix(nativeMatrix,
+                                    stripBorderList(layout, rank),
+                                    blackList,
+                                    overlapSize);
+    static_cast<NativeMatrix&>(inPlaceMatrix) = 123.0;
+    for (int iterIdx = 0; iterIdx < 2; ++iterIdx) {
+        // this is what the linearizer does for each Newton iteration
+        static_cast<NativeMatrix&>(inPlaceMatrix) = 0.0;
+        for (size_t rowIdx = 0; rowIdx < nativeMatrix.N(); ++rowIdx) {
+            const auto& row = nativeMatrix[rowIdx];
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+                inPlaceMatrix[rowIdx][colIt.index()] += *colIt;
+        }
+        inPlaceMatrix.assignFromNative(inPlaceMatrix.asParent());
+        inPlaceMatrix.syncAdd();
+
+        for (size_t rowIdx = 0; rowIdx < matrix.N(); ++rowIdx) {
+            const auto& row = matrix[rowIdx];
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+                check(inPlaceMatrix[rowIdx][colIt.index()][0][0] == (*colIt)[0][0],
+                      "assembling in place yields different entries");
+        }
+    }
+}
+
+// a structured three-dimensional grid of vertices which is decomposed into blocks, one
+// for each process. like for the strips, neighboring blocks share a plane of vertices,
+// so the vertices on the edges and corners of a block are shared by up to eight
+// processes.
+struct BlockLayout
+{
+    std::array<int, 3> ranksPerDim;
+    int verticesPerDim; // per process
+
+    // the coordinates of a process in the layout of the processes
+    std::array<int, 3> rankCoords(int rank) const
+    {
+        return {rank%ranksPerDim[0],
+                (rank/ranksPerDim[0])%ranksPerDim[1],
+                rank/(ranksPerDim[0]*ranksPerDim[1])};
+    }
+
+    int rankIdx(const std::array<int, 3>& coords) const
+    { return (coords[2]*ranksPerDim[1] + coords[1])*ranksPerDim[0] + coords[0]; }
+
+    int firstVertex(int rankCoord) const
+    { return rankCoord*(verticesPerDim - 1); }
+
+    int numVertices(unsigned dimIdx) const
+    { return ranksPerDim[dimIdx]*(verticesPerDim - 1) + 1; }
+
+    Index nativeIdx(const std::array<int, 3>& rankCoords, const std::array<int, 3>& pos) const
+    {
+        int x = pos[0] - firstVertex(rankCoords[0]);
+        int y = pos[1] - firstVertex(rankCoords[1]);
+        int z = pos[2] - firstVertex(rankCoords[2]);
+        return (z*verticesPerDim + y)*verticesPerDim + x;
+    }
+
+    // the coordinates of the processes which own a vertex in a given direction
+    std::vector<int> owners(unsigned dimIdx, int pos) const
+    {
+        std::vector<int> result;
+        int n = verticesPerDim - 1;
+        for (int rankCoord = std::max(0, (pos - 1)/n); rankCoord <= pos/n; ++rankCoord)
+            if (rankCoord < ranksPerDim[dimIdx] && firstVertex(rankCoord) <= pos && pos <= firstVertex(rankCoord) + n)
+                result.push_back(rankCoord);
+        return result;
+    }
+};
+
+// arrange the processes as a box which is as close to a cube as possible
+BlockLayout blockLayout(int numRanks, int verticesPerDim)
+{
+    BlockLayout layout;
+    layout.verticesPerDim = verticesPerDim;
+    layout.ranksPerDim = {1, 1, 1};
+    int remaining = numRanks;
+    for (int factor = 2; remaining > 1; ) {
+        if (remaining%factor != 0) {
+            ++factor;
+            continue;
+        }
+
+        auto& smallest = *std::min_element(layout.ranksPerDim.begin(), layout.ranksPerDim.end());
+        smallest *= factor;
+        remaining /= factor;
+    }
+    return layout;
+}
+
+// the native matrix of the seven-point stencil on the block of a process. since all
+// blocks have the same size, it is the same for all processes.
+NativeMatrix blockMatrix(const BlockLayout& layout)
+{
+    const int n = layout.verticesPerDim;
+    size_t numRows = static_cast<size_t>(n*n*n);
+    NativeMatrix matrix(numRows, numRows, NativeMatrix::random);
+    for (size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+        matrix.setrowsize(rowIdx, 7);
+    matrix.endrowsizes();
+
+    for (int z = 0; z < n; ++z) {
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                size_t rowIdx = static_cast<size_t>((z*n + y)*n + x);
+                matrix.addindex(rowIdx, rowIdx);
+                std::array<int, 3> pos{x, y, z};
+                for (unsigned dimIdx = 0; dimIdx < 3; ++dimIdx) {
+                    for (int offset : {-1, 1}) {
+                        auto neighbor = pos;
+                        neighbor[dimIdx] += offset;
+                        if (neighbor[dimIdx] < 0 || neighbor[dimIdx] >= n)
+                            continue;
+                        matrix.addindex(rowIdx, static_cast<size_t>((neighbor[2]*n + neighbor[1])*n + neighbor[0]));
+                    }
+                }
+            }
+        }
+    }
+    matrix.endindices();
+    return matrix;
+}
+
+// the vertices of the block which are shared with other processes
+Opm::Linear::BorderList blockBorderList(const BlockLayout& layout, int rank)
+{
+    const int n = layout.verticesPerDim;
+    const auto rankCoords = layout.rankCoords(rank);
+
+    Opm::Linear::BorderList borderList;
+    for (int z = 0; z < n; ++z) {
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                std::array<int, 3> pos{layout.firstVertex(rankCoords[0]) + x,
+                                       layout.firstVertex(rankCoords[1]) + y,
+                                       layout.firstVertex(rankCoords[2]) + z};
+                const auto ownersX = layout.owners(0, pos[0]);
+                const auto ownersY = layout.owners(1, pos[1]);
+                const auto ownersZ = layout.owners(2, pos[2]);
+                if (ownersX.size() == 1 && ownersY.size() == 1 && ownersZ.size() == 1)
+                    continue; // interior vertex
+
+                for (int peerZ : ownersZ) {
+                    for (int peerY : ownersY) {
+                        for (int peerX : ownersX) {
+                            std::array<int, 3> peerCoords{peerX, peerY, peerZ};
+                            if (peerCoords == rankCoords)
+                                continue;
+
+                            Opm::Linear::BorderIndex borderIdx;
+                            borderIdx.localIdx = layout.nativeIdx(rankCoords, pos);
+                            borderIdx.peerIdx = layout.nativeIdx(peerCoords, pos);
+                            borderIdx.peerRank = static_cast<Opm::Linear::ProcessRank>(layout.rankIdx(peerCoords));
+                            borderIdx.borderDistance = 0;
+                            borderList.push_back(borderIdx);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return borderList;
+}
+
+// the maximum of a time over all processes
+double maxTime(double localTime)
+{
+    double result = localTime;
+#if HAVE_MPI
+    MPI_Allreduce(&localTime, &result, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+    return result;
+}
+
+void barrier()
+{
+#if HAVE_MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+}
+
+// time the phases of setting up the overlapping matrix on the block decomposition:
+// determining the foreign overlap, determining the domestic overlap (i.e., the global
+// indices and the indices which are sent to and received from the peers) and building
+// the overlapping matrix. since each phase includes the previous ones, the time of a
+// phase is given by the difference to the previous one.
+void benchmarkSetup(const BlockLayout& layout, int rank, unsigned overlapSize)
+{
+    const NativeMatrix nativeMatrix = blockMatrix(layout);
+    const Opm::Linear::BorderList borderList = blockBorderList(layout, rank);
+    const Opm::Linear::BlackList blackList;
+
+    size_t numDomestic = 0;
+    barrier();
+    double foreignTime = maxTime(timeIt([&]() {
+        Opm::Linear::ForeignOverlapFromBCRSMatrix foreignOverlap(nativeMatrix, borderList, blackList, overlapSize);
+    }));
+
+    barrier();
+    double domesticTime = maxTime(timeIt([&]() {
+        Opm::Linear::DomesticOverlapFromBCRSMatrix domesticOverlap(nativeMatrix, borderList, blackList, overlapSize);
+        numDomestic = domesticOverlap.numDomestic();
+    }));
+
+    barrier();
+    double matrixTime = maxTime(timeIt([&]() {
+        OverlappingMatrix matrix(nativeMatrix, borderList, blackList, overlapSize);
+        check(matrix.N() == numDomestic, "the overlapping matrix has the wrong size");
+    }));
+
+    if (rank == 0) {
+        const auto& ranksPerDim = layout.ranksPerDim;
+        std::cout << "setup of the overlap: ranks: "
+                  << ranksPerDim[0] << "x" << ranksPerDim[1] << "x" << ranksPerDim[2]
+                  << ", vertices per rank: " << nativeMatrix.N()
+                  << ", overlap size: " << overlapSize
+                  << ", foreign overlap: " << foreignTime << " s"
+                  << ", domestic overlap: " << std::max(0.0, domesticTime - foreignTime) << " s"
+                  << ", overlapping matrix: " << std::max(0.0, matrixTime - domesticTime) << " s\n";
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    // initialize MPI, finalize is done automatically on exit
+    const auto& mpiHelper = Dune::MPIHelper::instance(argc, argv);
+    int rank = mpiHelper.rank();
+    int size = mpiHelper.size();
+
+    try {
+        StripLayout layout;
+        layout.numX = 4*size + 3;
+        layout.numY = 5;
+        layout.numRanks = size;
+        for (unsigned overlapSize = 1; overlapSize <= 3; ++overlapSize)
+            checkStripLayout(layout, rank, overlapSize);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "rank " << rank << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    if (rank == 0)
+        std::cout << "overlap setup test passed on " << size << " process(es)\n";
+
+    int maxRanks = 1000;
+    int cellsPerDim = 16;
+    if (argc > 1)
+        maxRanks = std::atoi(argv[1]);
+    if (argc > 2)
+        cellsPerDim = std::atoi(argv[2]);
+
+    try {
+        const BlockLayout layout = blockLayout(size, cellsPerDim);
+        for (unsigned overlapSize = 1; overlapSize <= 2; ++overlapSize)
+            benchmarkSetup(layout, rank, overlapSize);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "rank " << rank << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    // the benchmark of the index maps simulates the processes itself
+    if (size > 1)
+        return 0;
+
+    for (int ranksPerDim = 1; ranksPerDim*ranksPerDim*ranksPerDim <= maxRanks; ++ranksPerDim) {
+        Layout layout;
+        layout.ranksPerDim = ranksPerDim;
+        layout.cellsPerDim = cellsPerDim;
+        layout.overlapSize = 2;
+        runLayout(layout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Test that failed restart writes in a background thread are reported.
+ *
+ * Restart files are written by Opm::RestartWriteTasklet objects which are dispatched
+ * to a tasklet runner. A write to a directory which does not exist must raise an
+ * exception in the dispatching thread after the barrier of the runner, and the runner
+ * must still be able to write the next file afterwards.
+ */
+#include "config.h"
+
+#include <opm/models/io/restartwritetasklet.hh>
+#include <opm/models/parallel/tasklets.hh>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void check(bool condition, const std::string& msg)
+{
+    if (!condition)
+        throw std::logic_error(msg);
+}
+
+// write a file in the background and return whether the write failed
+bool writeFailed(Opm::TaskletRunner& runner, const std::string& fileName, const std::string& data)
+{
+    std::string buffer(data);
+    auto tasklet = std::make_shared<Opm::RestartWriteTasklet>(fileName, std::move(buffer));
+    runner.dispatch(tasklet);
+    runner.barrier();
+
+    try {
+        tasklet->rethrowError();
+    }
+    catch (const std::runtime_error& e) {
+        std::cout << "caught expected error: " << e.what() << "\n";
+        return true;
+    }
+
+    return false;
+}
+
+} // anonymous namespace
+
+int main()
+{
+    try {
+        Opm::TaskletRunner runner(/*numWorkers=*/1);
+
+        const std::string data("restart data\0with a null byte", 29);
+        const std::string fileName = "test_restartwrite.ers";
+
+        check(!writeFailed(runner, fileName, data),
+              "writing a restart file failed");
+
+        std::ifstream is(fileName, std::ios::in | std::ios::binary);
+        std::string readData((std::istreambuf_iterator<char>(is)),
+                             std::istreambuf_iterator<char>());
+        is.close();
+        check(readData == data, "the restart file has the wrong contents");
+
+        // the directory does not exist, so the file cannot be created
+        check(writeFailed(runner, "test_restartwrite_nonexistent_dir/" + fileName, data),
+              "a failed restart write was not reported");
+
+        // the runner must still be usable after a failed write
+        check(!writeFailed(runner, fileName, data),
+              "writing a restart file after a failed write failed");
+
+        std::remove(fileName.c_str());
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
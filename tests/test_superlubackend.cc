@@ -0,0 +1,249 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief Test for the SuperLU linear solver backend.
+ *
+ * Two linear systems of equations which exhibit the same sparsity pattern but
+ * different entries are solved using the same backend object, i.e., the second
+ * factorization reuses the structural information which SuperLU determined for the
+ * first one. Then, the LU decomposition of the first matrix is used as the
+ * preconditioner of an iterative solver for the second system.
+ */
+#include "config.h"
+
+#if HAVE_SUPERLU
+#include <opm/simulators/linalg/superlubackend.hh>
+#include <opm/simulators/linalg/istlsparsematrixadapter.hh>
+#include <opm/simulators/linalg/matrixblock.hh>
+#include <opm/models/utils/basicproperties.hh>
+#include <opm/models/utils/parametersystem.hh>
+#include <opm/models/utils/propertysystem.hh>
+
+#include <dune/common/fvector.hh>
+#include <dune/istl/bvector.hh>
+
+#include <cmath>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#endif // HAVE_SUPERLU
+
+#include <iostream>
+
+#if HAVE_SUPERLU
+namespace {
+
+static constexpr int numEq = 2;
+
+// the backend only needs to know whether the grid has changed
+struct TestVanguard
+{
+    int gridSequenceNumber() const
+    { return 0; }
+};
+
+struct TestSimulator
+{
+    const TestVanguard& vanguard() const
+    { return vanguard_; }
+
+    TestVanguard vanguard_;
+};
+
+} // anonymous namespace
+
+namespace Opm::Properties {
+
+namespace TTag {
+struct SuperLUTest { using InheritsFrom = std::tuple<SuperLULinearSolver, NumericModel>; };
+}
+
+template<class TypeTag>
+struct Simulator<TypeTag, TTag::SuperLUTest> { using type = TestSimulator; };
+
+template<class TypeTag>
+struct NumEq<TypeTag, TTag::SuperLUTest> { static constexpr int value = numEq; };
+
+template<class TypeTag>
+struct SparseMatrixAdapter<TypeTag, TTag::SuperLUTest>
+{ using type = Opm::Linear::IstlSparseMatrixAdapter<Opm::MatrixBlock<double, numEq, numEq> >; };
+
+template<class TypeTag>
+struct GlobalEqVector<TypeTag, TTag::SuperLUTest>
+{ using type = Dune::BlockVector<Dune::FieldVector<double, numEq> >; };
+
+} // namespace Opm::Properties
+
+namespace {
+
+using TypeTag = Opm::Properties::TTag::SuperLUTest;
+using Backend = Opm::Linear::SuperLUBackend<TypeTag>;
+using SparseMatrixAdapter = Opm::GetPropType<TypeTag, Opm::Properties::SparseMatrixAdapter>;
+using MatrixBlock = typename SparseMatrixAdapter::MatrixBlock;
+using Vector = Opm::GetPropType<TypeTag, Opm::Properties::GlobalEqVector>;
+
+static constexpr unsigned nx = 12;
+static constexpr unsigned ny = 10;
+
+void check(bool condition, const std::string& msg)
+{
+    if (!condition)
+        throw std::logic_error(msg);
+}
+
+// the neighbors of a cell of a nx x ny grid using a five point stencil
+std::vector<unsigned> neighbors(unsigned cellIdx)
+{
+    unsigned i = cellIdx % nx;
+    unsigned j = cellIdx / nx;
+    std::vector<unsigned> result;
+    if (j > 0)
+        result.push_back(cellIdx - nx);
+    if (i > 0)
+        result.push_back(cellIdx - 1);
+    if (i + 1 < nx)
+        result.push_back(cellIdx + 1);
+    if (j + 1 < ny)
+        result.push_back(cellIdx + nx);
+    return result;
+}
+
+SparseMatrixAdapter createMatrix()
+{
+    std::vector<std::set<unsigned> > sparsityPattern(nx*ny);
+    for (unsigned cellIdx = 0; cellIdx < nx*ny; ++cellIdx) {
+        sparsityPattern[cellIdx].insert(cellIdx);
+        for (unsigned neighborIdx : neighbors(cellIdx))
+            sparsityPattern[cellIdx].insert(neighborIdx);
+    }
+
+    SparseMatrixAdapter M(nx*ny, nx*ny);
+    M.reserve(sparsityPattern);
+    return M;
+}
+
+// assign the entries of a non-symmetric, diagonally dominant matrix. the entries depend
+// on the variant, the sparsity pattern does not.
+void assignEntries(SparseMatrixAdapter& M, double variant)
+{
+    M.clear();
+    for (unsigned cellIdx = 0; cellIdx < nx*ny; ++cellIdx) {
+        MatrixBlock diag(0.0);
+        for (unsigned neighborIdx : neighbors(cellIdx)) {
+            MatrixBlock offDiag(0.0);
+            for (int i = 0; i < numEq; ++i)
+                for (int j = 0; j < numEq; ++j)
+                    offDiag[i][j] = -0.2 - 0.1*std::sin(variant + cellIdx + 3.0*neighborIdx + i - j);
+            M.setBlock(cellIdx, neighborIdx, offDiag);
+        }
+        for (int i = 0; i < numEq; ++i) {
+            for (int j = 0; j < numEq; ++j)
+                diag[i][j] = 0.3*std::cos(variant*cellIdx + i + 2.0*j);
+            diag[i][i] = 4.0 + variant;
+        }
+        M.setBlock(cellIdx, cellIdx, diag);
+    }
+}
+
+Vector createRhs(double variant)
+{
+    Vector b(nx*ny);
+    for (unsigned cellIdx = 0; cellIdx < nx*ny; ++cellIdx)
+        for (int i = 0; i < numEq; ++i)
+            b[cellIdx][i] = std::cos(variant + 0.7*cellIdx + i);
+    return b;
+}
+
+// returns the norm of b - A*x relative to the one of b
+double relativeResidual(const SparseMatrixAdapter& M, const Vector& x, const Vector& b)
+{
+    Vector r(b);
+    M.istlMatrix().mmv(x, r);
+    return r.two_norm()/b.two_norm();
+}
+
+void solveAndCheck(Backend& backend, SparseMatrixAdapter& M, double variant, double tolerance)
+{
+    assignEntries(M, variant);
+    Vector b = createRhs(variant);
+    Vector x(b.size());
+    x = 0.0;
+
+    backend.prepare(M, b);
+    backend.setResidual(b);
+    backend.setMatrix(M);
+    check(backend.solve(x), "the linear solver did not converge");
+
+    if (!(relativeResidual(M, x, b) < tolerance))
+        throw std::logic_error("the residual of the solution is too large: "
+                               + std::to_string(relativeResidual(M, x, b)));
+}
+
+} // anonymous namespace
+#endif // HAVE_SUPERLU
+
+int main()
+{
+#if HAVE_SUPERLU
+    Backend::registerParameters();
+    EWOMS_END_PARAM_REGISTRATION(TypeTag);
+
+    try {
+        TestSimulator simulator;
+        SparseMatrixAdapter M = createMatrix();
+
+        // both matrices are factorized, the second one using the column permutation and
+        // the elimination tree of the first one
+        {
+            Backend backend(simulator);
+            solveAndCheck(backend, M, /*variant=*/0.0, /*tolerance=*/1e-12);
+            solveAndCheck(backend, M, /*variant=*/1.0, /*tolerance=*/1e-12);
+
+            // the first system once more to make sure that nothing of the second
+            // factorization is left over
+            solveAndCheck(backend, M, /*variant=*/0.0, /*tolerance=*/1e-12);
+        }
+
+        // the LU decomposition of the first matrix is the preconditioner for the second
+        // one. the entries of the matrices are similar, so this converges.
+        Opm::GetProp<TypeTag, Opm::Properties::ParameterMetaData>::tree()["PreconditionerMaxReuse"] = "1";
+        {
+            Backend backend(simulator);
+            solveAndCheck(backend, M, /*variant=*/0.0, /*tolerance=*/1e-12);
+            solveAndCheck(backend, M, /*variant=*/0.01, /*tolerance=*/1e-8);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "SuperLU backend test passed\n";
+#else
+    std::cout << "SuperLU is not available, skipping the test of its backend\n";
+#endif // HAVE_SUPERLU
+
+    return 0;
+}
@@ -0,0 +1,307 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief Test for the preconditioners which use the OpenMP threads of the process.
+ *
+ * The results are compared against the ones of the sequential Dune preconditioners.
+ */
+#include "config.h"
+
+#include <opm/simulators/linalg/threadedpreconditioners.hh>
+#include <opm/simulators/linalg/matrixblock.hh>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/version.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/preconditioners.hh>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+static constexpr int blockSize = 3;
+
+using Block = Opm::MatrixBlock<double, blockSize, blockSize>;
+using Matrix = Dune::BCRSMatrix<Block>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, blockSize>>;
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2,7)
+using ReferenceILU0 = Dune::SeqILU<Matrix, Vector, Vector>;
+#else
+using ReferenceILU0 = Dune::SeqILU0<Matrix, Vector, Vector>;
+#endif
+using ReferenceSOR = Dune::SeqSOR<Matrix, Vector, Vector>;
+using ReferenceSSOR = Dune::SeqSSOR<Matrix, Vector, Vector>;
+
+std::mt19937 randomGenerator(42);
+
+double randomValue()
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    return dist(randomGenerator);
+}
+
+void check(bool condition, const std::string& msg)
+{
+    if (!condition)
+        throw std::logic_error(msg);
+}
+
+void checkClose(const Vector& a, const Vector& b, const std::string& msg)
+{
+    check(a.size() == b.size(), msg + ": sizes differ");
+    for (unsigned i = 0; i < a.size(); ++i) {
+        for (int k = 0; k < blockSize; ++k) {
+            if (std::abs(a[i][k] - b[i][k]) > 1e-10*(1.0 + std::abs(b[i][k])))
+                throw std::logic_error(msg + ": results differ for row " + std::to_string(i));
+        }
+    }
+}
+
+// the neighbors of a cell of a nx x ny grid using a five point stencil. the couplings
+// in y direction are only present if the cell index is even, so the matrix is
+// structurally unsymmetric.
+std::vector<unsigned> neighbors(unsigned nx, unsigned ny, unsigned cellIdx)
+{
+    unsigned i = cellIdx % nx;
+    unsigned j = cellIdx / nx;
+    std::vector<unsigned> result;
+    if (j > 0 && cellIdx % 2 == 0)
+        result.push_back(cellIdx - nx);
+    if (i > 0)
+        result.push_back(cellIdx - 1);
+    result.push_back(cellIdx);
+    if (i + 1 < nx)
+        result.push_back(cellIdx + 1);
+    if (j + 1 < ny && cellIdx % 2 == 0)
+        result.push_back(cellIdx + nx);
+    return result;
+}
+
+// create a non-symmetric, diagonally dominant block matrix for a given ordering of the
+// cells. the entries only depend on the cells, not on their ordering.
+Matrix createMatrix(unsigned nx, unsigned ny, const std::vector<unsigned>& order)
+{
+    unsigned numRows = nx*ny;
+    std::vector<unsigned> position(numRows);
+    for (unsigned k = 0; k < numRows; ++k)
+        position[order[k]] = k;
+
+    Matrix A(numRows, numRows, Matrix::random);
+    for (unsigned k = 0; k < numRows; ++k)
+        A.setrowsize(k, neighbors(nx, ny, order[k]).size());
+    A.endrowsizes();
+    for (unsigned k = 0; k < numRows; ++k)
+        for (unsigned neighborIdx : neighbors(nx, ny, order[k]))
+            A.addindex(k, position[neighborIdx]);
+    A.endindices();
+
+    for (unsigned k = 0; k < numRows; ++k) {
+        unsigned cellIdx = order[k];
+        for (unsigned neighborIdx : neighbors(nx, ny, cellIdx)) {
+            auto& block = A[k][position[neighborIdx]];
+            for (int r = 0; r < blockSize; ++r) {
+                for (int c = 0; c < blockSize; ++c) {
+                    // use a deterministic function of the cells to get the same
+                    // entries for each ordering
+                    double value = std::sin(1.0 + cellIdx*7.0 + neighborIdx*3.0 + r*5.0 + c);
+                    if (cellIdx == neighborIdx && r == c)
+                        value += 10.0;
+                    block[r][c] = value;
+                }
+            }
+        }
+    }
+
+    return A;
+}
+
+Vector createVector(unsigned numRows)
+{
+    Vector v(numRows);
+    for (unsigned i = 0; i < numRows; ++i)
+        for (int k = 0; k < blockSize; ++k)
+            v[i][k] = randomValue();
+    return v;
+}
+
+void testLevelScheduledILU0()
+{
+    std::vector<unsigned> order(12*9);
+    for (unsigned i = 0; i < order.size(); ++i)
+        order[i] = i;
+    const Matrix A = createMatrix(12, 9, order);
+    const Vector d = createVector(A.N());
+
+    Vector v(A.N()), refV(A.N());
+    Vector tmpD(d);
+    ReferenceILU0 reference(A, 0.9);
+    refV = 0.0;
+    reference.apply(refV, tmpD);
+
+    Opm::Linear::LevelScheduledILU0<Matrix, Vector, Vector> ilu(A, 0.9);
+    v = 0.0;
+    ilu.apply(v, d);
+    checkClose(v, refV, "LevelScheduledILU0");
+}
+
+void testThreadedBlockILU0()
+{
+    std::vector<unsigned> order(12*9);
+    for (unsigned i = 0; i < order.size(); ++i)
+        order[i] = i;
+    const Matrix A = createMatrix(12, 9, order);
+    const Vector d = createVector(A.N());
+
+    // the couplings between the blocks of rows of the threads are neglected. the
+    // entries which are zeroed remain zero during the factorization, so this is
+    // equivalent to the ILU(0) of the matrix without these couplings.
+    std::size_t numRows = A.N();
+    std::size_t numBlocks = std::min<std::size_t>(Opm::Linear::Detail::preconditionerThreads(), numRows);
+    Matrix decoupledA(A);
+    for (std::size_t blockIdx = 0; blockIdx < numBlocks; ++blockIdx) {
+        std::size_t rowBegin = blockIdx*numRows/numBlocks;
+        std::size_t rowEnd = (blockIdx + 1)*numRows/numBlocks;
+        for (std::size_t rowIdx = rowBegin; rowIdx < rowEnd; ++rowIdx)
+            for (auto colIt = decoupledA[rowIdx].begin(); colIt != decoupledA[rowIdx].end(); ++colIt)
+                if (colIt.index() < rowBegin || colIt.index() >= rowEnd)
+                    *colIt = 0.0;
+    }
+
+    Vector v(A.N()), refV(A.N());
+    Vector tmpD(d);
+    ReferenceILU0 reference(decoupledA, 0.9);
+    refV = 0.0;
+    reference.apply(refV, tmpD);
+
+    Opm::Linear::ThreadedBlockILU0<Matrix, Vector, Vector> ilu(A, 0.9);
+    v = 0.0;
+    ilu.apply(v, d);
+    checkClose(v, refV, "ThreadedBlockILU0 (" + std::to_string(numBlocks) + " blocks)");
+}
+
+template <bool symmetric>
+void testMultiColorSOR()
+{
+    const std::string name = symmetric ? "MultiColorSSOR" : "MultiColorSOR";
+    const unsigned nx = 10;
+    const unsigned ny = 7;
+    const unsigned numRows = nx*ny;
+
+    std::vector<unsigned> naturalOrder(numRows);
+    for (unsigned i = 0; i < numRows; ++i)
+        naturalOrder[i] = i;
+    Matrix A = createMatrix(nx, ny, naturalOrder);
+
+    // the rows are colored greedily in their natural order, which leads to a red-black
+    // ordering for the five point stencil. since the rows of the same color are not
+    // coupled, the result is the same as the one of a sequential SOR using this
+    // ordering.
+    std::vector<unsigned> redBlackOrder;
+    for (unsigned color = 0; color < 2; ++color)
+        for (unsigned cellIdx = 0; cellIdx < numRows; ++cellIdx)
+            if ((cellIdx % nx + cellIdx / nx) % 2 == color)
+                redBlackOrder.push_back(cellIdx);
+    Matrix redBlackA = createMatrix(nx, ny, redBlackOrder);
+
+    const Vector d = createVector(numRows);
+    Vector redBlackD(numRows);
+    for (unsigned k = 0; k < numRows; ++k)
+        redBlackD[k] = d[redBlackOrder[k]];
+
+    const int numIterations = 2;
+    const double relaxationFactor = 1.2;
+    Opm::Linear::MultiColorSOR<Matrix, Vector, Vector, symmetric> sor(A, numIterations, relaxationFactor);
+    check(sor.numColors() == 2, name + ": unexpected number of colors");
+
+    for (int updateIdx = 0; updateIdx < 2; ++updateIdx) {
+        if (updateIdx > 0) {
+            // change the entries of the matrix which is referenced by the
+            // preconditioner
+            for (unsigned i = 0; i < numRows; ++i) {
+                A[i][i] *= 2.0;
+                redBlackA[i][i] *= 2.0;
+            }
+            sor.update();
+        }
+
+        Vector refV(numRows);
+        refV = 0.0;
+        Vector tmpD(redBlackD);
+        if (symmetric) {
+            ReferenceSSOR reference(redBlackA, numIterations, relaxationFactor);
+            reference.apply(refV, tmpD);
+        }
+        else {
+            ReferenceSOR reference(redBlackA, numIterations, relaxationFactor);
+            reference.apply(refV, tmpD);
+        }
+
+        Vector v(numRows);
+        sor.apply(v, d);
+
+        Vector redBlackV(numRows);
+        for (unsigned k = 0; k < numRows; ++k)
+            redBlackV[k] = v[redBlackOrder[k]];
+        checkClose(redBlackV, refV, name + (updateIdx > 0 ? " after update()" : ""));
+    }
+}
+
+} // anonymous namespace
+
+int main()
+{
+    try {
+        for (int numThreads : {1, 3}) {
+#ifdef _OPENMP
+            omp_set_num_threads(numThreads);
+#else
+            if (numThreads > 1)
+                continue;
+#endif
+
+            testLevelScheduledILU0();
+            testThreadedBlockILU0();
+            testMultiColorSOR</*symmetric=*/false>();
+            testMultiColorSOR</*symmetric=*/true>();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "threaded preconditioner test passed\n";
+    return 0;
+}
@@ -0,0 +1,183 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief Test for the vector mode automatic differentiation local linearizer.
+ *
+ * The global Jacobian and residual of a perturbed initial solution are assembled using
+ * FvBaseAdLocalLinearizer and FvBaseVectorAdLocalLinearizer for an immiscible and for
+ * a compositional problem. Both linearizers must produce the same results up to
+ * round-off errors.
+ */
+#include "config.h"
+
+#include <opm/models/utils/start.hh>
+#include <opm/models/immiscible/immisciblemodel.hh>
+#include <opm/models/pvs/pvsmodel.hh>
+#include "problems/lensproblem.hh"
+#include "problems/obstacleproblem.hh"
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace Opm::Properties {
+
+namespace TTag {
+struct LensProblemAd { using InheritsFrom = std::tuple<LensBaseProblem, ImmiscibleTwoPhaseModel>; };
+struct LensProblemVectorAd { using InheritsFrom = std::tuple<LensProblemAd>; };
+
+struct ObstacleProblemAd { using InheritsFrom = std::tuple<ObstacleBaseProblem, PvsModel>; };
+struct ObstacleProblemVectorAd { using InheritsFrom = std::tuple<ObstacleProblemAd>; };
+} // end namespace TTag
+
+template<class TypeTag>
+struct LocalLinearizerSplice<TypeTag, TTag::LensProblemAd> { using type = TTag::AutoDiffLocalLinearizer; };
+template<class TypeTag>
+struct LocalLinearizerSplice<TypeTag, TTag::LensProblemVectorAd> { using type = TTag::VectorAutoDiffLocalLinearizer; };
+
+// with P1 finite element gradients, the fluxes depend on all vertices of an element
+#if HAVE_DUNE_LOCALFUNCTIONS
+template<class TypeTag>
+struct UseP1FiniteElementGradients<TypeTag, TTag::LensProblemAd> { static constexpr bool value = true; };
+#endif
+
+template<class TypeTag>
+struct LocalLinearizerSplice<TypeTag, TTag::ObstacleProblemAd> { using type = TTag::AutoDiffLocalLinearizer; };
+template<class TypeTag>
+struct LocalLinearizerSplice<TypeTag, TTag::ObstacleProblemVectorAd> { using type = TTag::VectorAutoDiffLocalLinearizer; };
+
+template<class TypeTag>
+struct PvsVerbosity<TypeTag, TTag::ObstacleProblemAd> { static constexpr int value = 0; };
+
+} // namespace Opm::Properties
+
+namespace {
+
+void check(bool condition, const std::string& msg)
+{
+    if (!condition)
+        throw std::logic_error(msg);
+}
+
+bool isClose(double a, double b, double absTol)
+{ return std::abs(a - b) <= 1e-9*std::max(std::abs(a), std::abs(b)) + absTol; }
+
+// assemble the Jacobian and the residual of a perturbed initial solution
+template <class TypeTag>
+auto linearizeInitialSolution(int argc, const char **argv)
+{
+    using Simulator = Opm::GetPropType<TypeTag, Opm::Properties::Simulator>;
+    using ThreadManager = Opm::GetPropType<TypeTag, Opm::Properties::ThreadManager>;
+
+    Opm::Parameters::reset<TypeTag>();
+    check(Opm::setupParameters_<TypeTag>(argc, argv) == 0,
+          "could not set up the run-time parameters");
+    ThreadManager::init();
+
+    Simulator simulator(/*verbose=*/false);
+    auto& model = simulator.model();
+    model.applyInitialSolution();
+
+    // perturb the current solution so that it differs from the one of the last time
+    // step and so that the fluxes do not vanish
+    auto& solution = model.solution(/*timeIdx=*/0);
+    for (unsigned globalIdx = 0; globalIdx < solution.size(); ++globalIdx)
+        for (unsigned pvIdx = 0; pvIdx < solution[globalIdx].size(); ++pvIdx)
+            solution[globalIdx][pvIdx] *= 1.0 + 1e-3*std::sin(1.0 + globalIdx + 7.0*pvIdx);
+    model.invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+
+    auto& linearizer = model.linearizer();
+    linearizer.linearizeDomain();
+    return std::make_pair(linearizer.jacobian().istlMatrix(), linearizer.residual());
+}
+
+template <class RefTypeTag, class TypeTag>
+void compareLinearizations(int argc, const char **argv, const std::string& name)
+{
+    const auto& [refJacobian, refResidual] = linearizeInitialSolution<RefTypeTag>(argc, argv);
+    const auto& [jacobian, residual] = linearizeInitialSolution<TypeTag>(argc, argv);
+
+    check(refJacobian.N() == jacobian.N() && refJacobian.nonzeroes() == jacobian.nonzeroes(),
+          name+": the sparsity patterns of the Jacobians differ");
+    check(refResidual.size() == residual.size(),
+          name+": the sizes of the residuals differ");
+
+    // entries which are small compared to the largest one are dominated by round-off
+    double maxJacobian = 0.0;
+    for (auto row = refJacobian.begin(); row != refJacobian.end(); ++row)
+        for (auto col = row->begin(); col != row->end(); ++col)
+            maxJacobian = std::max(maxJacobian, double(col->infinity_norm()));
+    double maxResidual = refResidual.infinity_norm();
+
+    for (auto row = refJacobian.begin(); row != refJacobian.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            check(jacobian.exists(row.index(), col.index()),
+                  name+": the sparsity patterns of the Jacobians differ");
+
+            const auto& refBlock = *col;
+            const auto& block = jacobian[row.index()][col.index()];
+            for (unsigned i = 0; i < refBlock.N(); ++i)
+                for (unsigned j = 0; j < refBlock.M(); ++j)
+                    check(isClose(refBlock[i][j], block[i][j], 1e-13*maxJacobian),
+                          name+": Jacobian entry ("+std::to_string(row.index())+", "
+                          +std::to_string(col.index())+")["+std::to_string(i)+"]["
+                          +std::to_string(j)+"] differs: "+std::to_string(refBlock[i][j])
+                          +" vs. "+std::to_string(block[i][j]));
+        }
+    }
+
+    for (unsigned dofIdx = 0; dofIdx < refResidual.size(); ++dofIdx)
+        for (unsigned eqIdx = 0; eqIdx < refResidual[dofIdx].size(); ++eqIdx)
+            check(isClose(refResidual[dofIdx][eqIdx], residual[dofIdx][eqIdx], 1e-13*maxResidual),
+                  name+": residual entry "+std::to_string(dofIdx)+"["+std::to_string(eqIdx)
+                  +"] differs: "+std::to_string(refResidual[dofIdx][eqIdx])
+                  +" vs. "+std::to_string(residual[dofIdx][eqIdx]));
+
+    std::cout << name << ": the linearizations are identical\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    const char **constArgv = const_cast<const char**>(argv);
+
+    try {
+        using namespace Opm::Properties::TTag;
+        compareLinearizations<LensProblemAd, LensProblemVectorAd>(argc, constArgv, "immiscible");
+        compareLinearizations<ObstacleProblemAd, ObstacleProblemVectorAd>(argc, constArgv, "pvs");
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}